@@ -33,9 +33,11 @@ struct TextureHeader {
     uint32_t height;
     uint32_t channels;   // e.g. 4 for RGBA
     uint32_t mipLevels;
-    uint32_t format;     // RHI Format Enum (to be defined, for now 0=RGBA8)
+    uint32_t format;     // rhi::TextureFormat (0=RGBA8, 1=BC1, 2=BC3, 3=ETC2_RGB8, 4=ETC2_RGBA8)
     // Payload follows immediately:
     // [Mip 0 Data] [Mip 1 Data] ...
+    // RGBA8: linear rows of width * 4 bytes.
+    // Compressed: row-major 4x4 blocks per level (edge blocks padded), down to 1x1.
 };
 
 // =================================================================================================
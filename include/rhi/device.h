@@ -21,6 +21,23 @@ public:
     virtual void UpdateBuffer(BufferHandle handle, const void* data, size_t size, size_t offset = 0) = 0;
 
     virtual TextureHandle CreateTexture(const void* pixelData, int width, int height, int channels) = 0;
+    /**
+     * @brief Creates a texture from pre-compressed 4x4 block data.
+     *
+     * @param blockData Row-major blocks of mip 0, immediately followed by each smaller level.
+     * @param mipLevels Number of levels contained in blockData.
+     */
+    virtual TextureHandle CreateCompressedTexture(const void* blockData, int width, int height, int mipLevels, TextureFormat format) = 0;
+    /**
+     * @brief Overwrites a sub-rectangle of mip 0 in place (video frames, dynamic atlases).
+     *
+     * Mip levels are regenerated only if the texture already has a chain; a texture without one keeps a single level.
+     * Compressed textures are re-encoded from pixelData. They can only be updated while they have no mip chain,
+     * and the rect must start on a 4x4 block boundary and span whole blocks unless it reaches the level edge.
+     * Calls that break these rules are rejected and leave the texture unchanged.
+     * @param pixelData Tightly packed rows of width * channels bytes (no row padding), same channel layout as CreateTexture.
+     */
+    virtual void UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const void* pixelData, int channels) = 0;
     virtual void DestroyTexture(TextureHandle handle) = 0;
     
     virtual PipelineHandle CreatePipeline(const PipelineDesc& desc) = 0;
@@ -19,6 +19,8 @@ public:
     void UpdateBuffer(BufferHandle handle, const void* data, size_t size, size_t offset) override;
 
     TextureHandle CreateTexture(const void* pixelData, int width, int height, int channels) override;
+    TextureHandle CreateCompressedTexture(const void* blockData, int width, int height, int mipLevels, TextureFormat format) override;
+    void UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const void* pixelData, int channels) override;
     void DestroyTexture(TextureHandle handle) override;
 
     PipelineHandle CreatePipeline(const PipelineDesc& desc) override;
@@ -36,6 +38,14 @@ private:
         GLenum target;
     };
 
+    struct TextureMeta {
+        GLuint id;
+        GLenum compressedFormat = 0; // 0 for uncompressed textures
+        int width = 0;
+        int height = 0;
+        bool hasMips = false;
+    };
+
     struct PipelineMeta {
         GLuint program;
         GLuint vao;
@@ -61,7 +71,7 @@ private:
     void UseProgram(GLuint id);
 
     std::unordered_map<uint32_t, BufferMeta> m_buffers;
-    std::unordered_map<uint32_t, GLuint> m_textures;
+    std::unordered_map<uint32_t, TextureMeta> m_textures;
     std::unordered_map<uint32_t, PipelineMeta> m_pipelines;
     std::unordered_map<uint32_t, GLuint> m_shaderPrograms;
 
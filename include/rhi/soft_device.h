@@ -23,6 +23,8 @@ public:
     void UpdateBuffer(BufferHandle handle, const void* data, size_t size, size_t offset) override;
 
     TextureHandle CreateTexture(const void* pixelData, int width, int height, int channels) override;
+    TextureHandle CreateCompressedTexture(const void* blockData, int width, int height, int mipLevels, TextureFormat format) override;
+    void UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const void* pixelData, int channels) override;
     
     // Create a handle from an existing GL texture ID.
     // The device will NOT take ownership of this texture (will not delete it).
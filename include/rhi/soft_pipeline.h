@@ -220,9 +220,10 @@ public:
         v0.scn = tri.p[0];
         v1.scn = tri.p[1];
         v2.scn = tri.p[2];
-        std::memcpy(v0.ctx.varyings, tri.varyings[0], sizeof(v0.ctx.varyings));
-        std::memcpy(v1.ctx.varyings, tri.varyings[1], sizeof(v1.ctx.varyings));
-        std::memcpy(v2.ctx.varyings, tri.varyings[2], sizeof(v2.ctx.varyings));
+        // 与 Binning 时的拷贝大小一致 (TriangleData 每个顶点只保存 MAX_VARYINGS 个 float)
+        std::memcpy(v0.ctx.varyings, tri.varyings[0], sizeof(tri.varyings[0]));
+        std::memcpy(v1.ctx.varyings, tri.varyings[1], sizeof(tri.varyings[1]));
+        std::memcpy(v2.ctx.varyings, tri.varyings[2], sizeof(tri.varyings[2]));
 
         // --- Stateless Rasterization Setup ---
         tinygl::SoftRenderContext::RasterState state;
@@ -258,6 +259,12 @@ public:
             state.blend.equationAlpha = MapOp(desc.blend.opAlpha);
         }
 
+        // 5. Color Write Mask
+        state.colorMask[0] = (desc.colorWriteMask & ColorWriteRed) ? GL_TRUE : GL_FALSE;
+        state.colorMask[1] = (desc.colorWriteMask & ColorWriteGreen) ? GL_TRUE : GL_FALSE;
+        state.colorMask[2] = (desc.colorWriteMask & ColorWriteBlue) ? GL_TRUE : GL_FALSE;
+        state.colorMask[3] = (desc.colorWriteMask & ColorWriteAlpha) ? GL_TRUE : GL_FALSE;
+
         ShaderT shader;
         InjectUniforms(shader, uniformData, 1024); 
         InjectResources(shader, ctx);
@@ -368,6 +375,11 @@ private:
         } else {
             ctx.glDisable(GL_BLEND);
         }
+
+        ctx.glColorMask((desc.colorWriteMask & ColorWriteRed) ? GL_TRUE : GL_FALSE,
+                        (desc.colorWriteMask & ColorWriteGreen) ? GL_TRUE : GL_FALSE,
+                        (desc.colorWriteMask & ColorWriteBlue) ? GL_TRUE : GL_FALSE,
+                        (desc.colorWriteMask & ColorWriteAlpha) ? GL_TRUE : GL_FALSE);
     }
 
     void InjectUniforms(ShaderT& shader, const uint8_t* uniformData, size_t size) {
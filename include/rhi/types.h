@@ -71,11 +71,30 @@ struct BlendState {
     BlendOp opAlpha = BlendOp::Add;
 };
 
+// Color write mask (bitwise OR of channels), mirrors glColorMask
+enum ColorWriteMask : uint8_t {
+    ColorWriteNone  = 0,
+    ColorWriteRed   = 1 << 0,
+    ColorWriteGreen = 1 << 1,
+    ColorWriteBlue  = 1 << 2,
+    ColorWriteAlpha = 1 << 3,
+    ColorWriteAll   = 0xF
+};
+
 enum class IndexFormat {
     Uint16,
     Uint32
 };
 
+// Texture storage format. Values are serialized in .ttex files (TextureHeader::format).
+enum class TextureFormat : uint32_t {
+    RGBA8      = 0,
+    BC1        = 1, // RGB, 4 bpp
+    BC3        = 2, // RGBA, 8 bpp
+    ETC2_RGB8  = 3, // RGB, 4 bpp
+    ETC2_RGBA8 = 4  // RGBA (EAC alpha), 8 bpp
+};
+
 // --- Vertex Layout ---
 
 enum class VertexFormat {
@@ -134,6 +153,10 @@ struct PipelineDesc {
     
     // Blend State
     BlendState blend;
+
+    // Color Write Mask (ColorWriteMask bits)
+    // ColorWriteNone: depth-only pass (Z-prepass / shadow map)
+    uint8_t colorWriteMask = ColorWriteAll;
     
     const char* label = nullptr;
 };
@@ -39,6 +39,12 @@ struct alignas(16) Simd4f {
     // 从 float32x4_t 构造
     SIMD_INLINE Simd4f(float32x4_t _v) : v(_v) {}
 
+    // 逐 Lane 构造 (lane0 = a)
+    SIMD_INLINE Simd4f(float a, float b, float c, float d) {
+        const float tmp[4] = {a, b, c, d};
+        v = vld1q_f32(tmp);
+    }
+
     // 加载
     SIMD_INLINE static Simd4f load(const float* ptr) {
         return Simd4f(vld1q_f32(ptr));
@@ -58,6 +64,26 @@ struct alignas(16) Simd4f {
     SIMD_INLINE Simd4f madd(const Simd4f& a, const Simd4f& b) const {
         return Simd4f(vfmaq_f32(v, a.v, b.v)); 
     }
+
+    SIMD_INLINE Simd4f min(const Simd4f& other) const { return Simd4f(vminq_f32(v, other.v)); }
+
+    // 广播第 L 个 lane 到全部 lane
+    template <int L>
+    SIMD_INLINE Simd4f splat() const { return Simd4f(vdupq_laneq_f32(v, L)); }
+
+    // 比较：返回 lane >= 0 的位掩码 (bit i 对应 lane i)
+    SIMD_INLINE int geZeroMask() const {
+        uint32x4_t m = vcgeq_f32(v, vdupq_n_f32(0.0f));
+        return (vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2) |
+               (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8);
+    }
+
+    // RGBA8 (0xAABBGGRR) 解包为 [0, 255] 的 4 个 float (lane0 = R)
+    SIMD_INLINE static Simd4f unpackRGBA8(uint32_t p) {
+        uint16x8_t w = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p)));
+        return Simd4f(vcvtq_f32_u32(vmovl_u16(vget_low_u16(w))));
+    }
+
     // 辅助：从 Vec4 加载
     SIMD_INLINE static Simd4f load(const Vec4& v) {
         // 假设 Vec4 布局是 x,y,z,w 连续 float
@@ -84,6 +110,9 @@ struct alignas(16) Simd4f {
     // 从 __m128 构造
     SIMD_INLINE Simd4f(__m128 _v) : v(_v) {}
 
+    // 逐 Lane 构造 (lane0 = a)
+    SIMD_INLINE Simd4f(float a, float b, float c, float d) : v(_mm_setr_ps(a, b, c, d)) {}
+
     // 加载
     SIMD_INLINE static Simd4f load(const float* ptr) {
         return Simd4f(_mm_loadu_ps(ptr));
@@ -108,6 +137,25 @@ struct alignas(16) Simd4f {
             return Simd4f(_mm_add_ps(v, _mm_mul_ps(a.v, b.v)));
         #endif
     }
+
+    SIMD_INLINE Simd4f min(const Simd4f& other) const { return Simd4f(_mm_min_ps(v, other.v)); }
+
+    // 广播第 L 个 lane 到全部 lane
+    template <int L>
+    SIMD_INLINE Simd4f splat() const { return Simd4f(_mm_shuffle_ps(v, v, _MM_SHUFFLE(L, L, L, L))); }
+
+    // 比较：返回 lane >= 0 的位掩码 (bit i 对应 lane i)
+    SIMD_INLINE int geZeroMask() const {
+        return _mm_movemask_ps(_mm_cmpge_ps(v, _mm_setzero_ps()));
+    }
+
+    // RGBA8 (0xAABBGGRR) 解包为 [0, 255] 的 4 个 float (lane0 = R)
+    SIMD_INLINE static Simd4f unpackRGBA8(uint32_t p) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i x = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)p), zero);
+        return Simd4f(_mm_cvtepi32_ps(_mm_unpacklo_epi16(x, zero)));
+    }
+
     // 辅助：从 Vec4 加载
     SIMD_INLINE static Simd4f load(const Vec4& v) {
         return Simd4f(_mm_loadu_ps(&v.x));
@@ -131,6 +179,49 @@ struct alignas(16) Simd4f {
 
 #endif
 
+// SoA 打包的 4 个 Vec4：lane i 对应第 i 个元素 (x[i], y[i], z[i], w[i])
+// 用于批量顶点着色 (vertexBatch)，一条指令同时处理 4 个顶点的同一分量
+struct Vec4Packet {
+    Simd4f x, y, z, w;
+
+    Vec4Packet() = default;
+    Vec4Packet(const Simd4f& _x, const Simd4f& _y, const Simd4f& _z, const Simd4f& _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+    // 4 个 lane 填充同一个 Vec4
+    static Vec4Packet broadcast(const Vec4& v) {
+        return Vec4Packet(Simd4f(v.x), Simd4f(v.y), Simd4f(v.z), Simd4f(v.w));
+    }
+
+    // AoS -> SoA：in[0..3] 为连续存放的 4 个 Vec4
+    SIMD_INLINE static Vec4Packet loadAoS(const Vec4* in) {
+#if defined(__ARM_NEON) || defined(__aarch64__)
+        float32x4x4_t t = vld4q_f32(&in[0].x);
+        return Vec4Packet(Simd4f(t.val[0]), Simd4f(t.val[1]), Simd4f(t.val[2]), Simd4f(t.val[3]));
+#else
+        __m128 r0 = _mm_loadu_ps(&in[0].x), r1 = _mm_loadu_ps(&in[1].x);
+        __m128 r2 = _mm_loadu_ps(&in[2].x), r3 = _mm_loadu_ps(&in[3].x);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        return Vec4Packet(Simd4f(r0), Simd4f(r1), Simd4f(r2), Simd4f(r3));
+#endif
+    }
+
+    // SoA -> AoS：写出 4 个连续的 Vec4
+    SIMD_INLINE void storeAoS(Vec4* out) const {
+#if defined(__ARM_NEON) || defined(__aarch64__)
+        float32x4x4_t t = {{x.v, y.v, z.v, w.v}};
+        vst4q_f32(&out[0].x, t);
+#else
+        __m128 r0 = x.v, r1 = y.v, r2 = z.v, r3 = w.v;
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(&out[0].x, r0); _mm_storeu_ps(&out[1].x, r1);
+        _mm_storeu_ps(&out[2].x, r2); _mm_storeu_ps(&out[3].x, r3);
+#endif
+    }
+
+    Vec4Packet operator+(const Vec4Packet& o) const { return Vec4Packet(x + o.x, y + o.y, z + o.z, w + o.w); }
+    Vec4Packet operator*(const Simd4f& s) const { return Vec4Packet(x * s, y * s, z * s, w * s); }
+};
+
 // 辅助：SIMD 矩阵列式存储，用于加速 Vertex Shader
 // 这里的逻辑对所有平台通用，只要 Simd4f 接口一致
 struct SimdMat4 {
@@ -164,6 +255,21 @@ struct SimdMat4 {
         res = res.madd(cols[2], z);
         return res;
     }
+
+    // 批量变换 4 个顶点 (SoA)：res.r = sum_c M[r][c] * p.c
+    inline Vec4Packet transformPacket(const Vec4Packet& p) const {
+        return Vec4Packet(transformRow<0>(p), transformRow<1>(p), transformRow<2>(p), transformRow<3>(p));
+    }
+
+private:
+    template <int R>
+    inline Simd4f transformRow(const Vec4Packet& p) const {
+        Simd4f res = cols[3].splat<R>() * p.w;
+        res = res.madd(cols[0].splat<R>(), p.x);
+        res = res.madd(cols[1].splat<R>(), p.y);
+        res = res.madd(cols[2].splat<R>(), p.z);
+        return res;
+    }
 };
 
 }
\ No newline at end of file
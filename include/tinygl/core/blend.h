@@ -0,0 +1,140 @@
+#pragma once
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+#include <cstdint>
+#include "gl_defs.h"
+
+namespace tinygl {
+
+// ==========================================
+// 定点混合单元 (RGBA8)
+// ==========================================
+// 常见混合模式直接在 8-bit 颜色上计算，避免 Uint32ToFloat -> applyBlending -> FloatToUint32 的往返。
+// 定点颜色缓冲按 GL 规范在混合前把源颜色钳制到 [0, 1]，与先量化源颜色等价。
+// 乘积统一按 round(x / 255) 归一化，SIMD 与标量路径结果逐位一致。
+enum FixedBlendMode : uint8_t {
+    FIXED_BLEND_NONE = 0,       // 不支持，使用浮点 applyBlending
+    FIXED_BLEND_ALPHA,          // SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+    FIXED_BLEND_PREMULTIPLIED,  // ONE, ONE_MINUS_SRC_ALPHA
+    FIXED_BLEND_ADDITIVE,       // ONE, ONE
+    FIXED_BLEND_ADDITIVE_ALPHA, // SRC_ALPHA, ONE
+    FIXED_BLEND_MULTIPLY        // DST_COLOR, ZERO (或 ZERO, SRC_COLOR)
+};
+
+// RGB 与 Alpha 使用相同因子且方程为 FUNC_ADD 时才走定点路径，其余组合返回 FIXED_BLEND_NONE
+inline FixedBlendMode classifyFixedBlend(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha,
+                                         GLenum equationRGB, GLenum equationAlpha) {
+    if (srcRGB != srcAlpha || dstRGB != dstAlpha) return FIXED_BLEND_NONE;
+    if (equationRGB != GL_FUNC_ADD || equationAlpha != GL_FUNC_ADD) return FIXED_BLEND_NONE;
+    if (srcRGB == GL_SRC_ALPHA && dstRGB == GL_ONE_MINUS_SRC_ALPHA) return FIXED_BLEND_ALPHA;
+    if (srcRGB == GL_ONE && dstRGB == GL_ONE_MINUS_SRC_ALPHA) return FIXED_BLEND_PREMULTIPLIED;
+    if (srcRGB == GL_ONE && dstRGB == GL_ONE) return FIXED_BLEND_ADDITIVE;
+    if (srcRGB == GL_SRC_ALPHA && dstRGB == GL_ONE) return FIXED_BLEND_ADDITIVE_ALPHA;
+    if ((srcRGB == GL_DST_COLOR && dstRGB == GL_ZERO) || (srcRGB == GL_ZERO && dstRGB == GL_SRC_COLOR)) return FIXED_BLEND_MULTIPLY;
+    return FIXED_BLEND_NONE;
+}
+
+// round(x / 255)，x <= 255 * 255
+inline uint32_t mulDiv255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// 单像素标量版本 (线/点、MSAA 与模板的通用内核)
+inline uint32_t blendFixed(FixedBlendMode mode, uint32_t src, uint32_t dst) {
+    const uint32_t a = src >> 24;
+    uint32_t out = 0;
+    for (int c = 0; c < 32; c += 8) {
+        const uint32_t s = (src >> c) & 0xFF;
+        const uint32_t d = (dst >> c) & 0xFF;
+        uint32_t r;
+        switch (mode) {
+            case FIXED_BLEND_ALPHA: r = mulDiv255(s * a + d * (255 - a)); break;
+            case FIXED_BLEND_PREMULTIPLIED: r = s + mulDiv255(d * (255 - a)); break;
+            case FIXED_BLEND_ADDITIVE: r = s + d; break;
+            case FIXED_BLEND_ADDITIVE_ALPHA: r = mulDiv255(s * a) + d; break;
+            case FIXED_BLEND_MULTIPLY: r = mulDiv255(s * d); break;
+            default: r = s; break;
+        }
+        out |= (r > 255 ? 255u : r) << c;
+    }
+    return out;
+}
+
+// 4 像素版本：src / dst 各 4 个 RGBA8，结果写回 out
+inline void blendFixed4(FixedBlendMode mode, const uint32_t* src, const uint32_t* dst, uint32_t* out) {
+#if defined(__ARM_NEON) || defined(__aarch64__)
+    const uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(src));
+    const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst));
+    // Alpha 广播到 4 个通道：a * 0x01010101
+    const uint8x16_t a = vreinterpretq_u8_u32(vmulq_n_u32(vshrq_n_u32(vld1q_u32(src), 24), 0x01010101u));
+    const uint8x16_t ia = vmvnq_u8(a);
+    // (x + ((x + 128) >> 8) + 128) >> 8，与 mulDiv255 相同
+    auto div255 = [](uint16x8_t lo, uint16x8_t hi) {
+        return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+    };
+    auto mul = [&](uint8x16_t x, uint8x16_t y) {
+        return div255(vmull_u8(vget_low_u8(x), vget_low_u8(y)), vmull_u8(vget_high_u8(x), vget_high_u8(y)));
+    };
+    uint8x16_t r;
+    switch (mode) {
+        case FIXED_BLEND_ALPHA: {
+            uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s), vget_low_u8(a)), vget_low_u8(d), vget_low_u8(ia));
+            uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s), vget_high_u8(a)), vget_high_u8(d), vget_high_u8(ia));
+            r = div255(lo, hi);
+            break;
+        }
+        case FIXED_BLEND_PREMULTIPLIED: r = vqaddq_u8(s, mul(d, ia)); break;
+        case FIXED_BLEND_ADDITIVE: r = vqaddq_u8(s, d); break;
+        case FIXED_BLEND_ADDITIVE_ALPHA: r = vqaddq_u8(mul(s, a), d); break;
+        case FIXED_BLEND_MULTIPLY: r = mul(s, d); break;
+        default: r = s; break;
+    }
+    vst1q_u32(out, vreinterpretq_u32_u8(r));
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i s = _mm_loadu_si128((const __m128i*)src);
+    const __m128i d = _mm_loadu_si128((const __m128i*)dst);
+    // 8-bit -> 16-bit：lo 为像素 0/1，hi 为像素 2/3
+    const __m128i sLo = _mm_unpacklo_epi8(s, zero), sHi = _mm_unpackhi_epi8(s, zero);
+    const __m128i dLo = _mm_unpacklo_epi8(d, zero), dHi = _mm_unpackhi_epi8(d, zero);
+    auto splatAlpha = [](__m128i v) {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    };
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i aLo = splatAlpha(sLo), aHi = splatAlpha(sHi);
+    const __m128i iaLo = _mm_sub_epi16(c255, aLo), iaHi = _mm_sub_epi16(c255, aHi);
+    auto div255 = [](__m128i x) {
+        x = _mm_add_epi16(x, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    };
+    // 乘积不超过 255 * 255，16-bit 无符号范围内 mullo / add 不会溢出
+    auto mul = [&](__m128i xLo, __m128i xHi, __m128i yLo, __m128i yHi) {
+        return _mm_packus_epi16(div255(_mm_mullo_epi16(xLo, yLo)), div255(_mm_mullo_epi16(xHi, yHi)));
+    };
+    __m128i r;
+    switch (mode) {
+        case FIXED_BLEND_ALPHA: {
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(sLo, aLo), _mm_mullo_epi16(dLo, iaLo));
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(sHi, aHi), _mm_mullo_epi16(dHi, iaHi));
+            r = _mm_packus_epi16(div255(lo), div255(hi));
+            break;
+        }
+        case FIXED_BLEND_PREMULTIPLIED: r = _mm_adds_epu8(s, mul(dLo, dHi, iaLo, iaHi)); break;
+        case FIXED_BLEND_ADDITIVE: r = _mm_adds_epu8(s, d); break;
+        case FIXED_BLEND_ADDITIVE_ALPHA: r = _mm_adds_epu8(mul(sLo, sHi, aLo, aHi), d); break;
+        case FIXED_BLEND_MULTIPLY: r = mul(sLo, sHi, dLo, dHi); break;
+        default: r = s; break;
+    }
+    _mm_storeu_si128((__m128i*)out, r);
+#else
+    for (int i = 0; i < 4; ++i) out[i] = blendFixed(mode, src[i], dst[i]);
+#endif
+}
+
+}
@@ -143,6 +143,60 @@ using GLfloat = float;
 #ifndef GL_RGB
 #define GL_RGB 0x1907
 #endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+#ifndef GL_RG
+#define GL_RG 0x8227
+#endif
+
+// Compact Internal Formats (glTexImage2D internalformat，按请求格式原样存储)
+#ifndef GL_R8
+#define GL_R8 0x8229
+#endif
+#ifndef GL_RG8
+#define GL_RG8 0x822B
+#endif
+#ifndef GL_RGB565
+#define GL_RGB565 0x8D62
+#endif
+#ifndef GL_RGBA4
+#define GL_RGBA4 0x8056
+#endif
+#ifndef GL_R16F
+#define GL_R16F 0x822D
+#endif
+#ifndef GL_R32F
+#define GL_R32F 0x822E
+#endif
+
+// Packed / Half Pixel Types
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+#ifndef GL_UNSIGNED_SHORT_5_6_5
+#define GL_UNSIGNED_SHORT_5_6_5 0x8363
+#endif
+#ifndef GL_UNSIGNED_SHORT_4_4_4_4
+#define GL_UNSIGNED_SHORT_4_4_4_4 0x8033
+#endif
+
+// Compressed Texture Formats (glCompressedTexImage2D / glTexImage2D internalformat)
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
 #ifndef GL_RED
 #define GL_RED 0x1903
 #endif
@@ -153,6 +207,20 @@ using GLfloat = float;
 #define GL_STENCIL_INDEX 0x1901
 #endif
 
+// Depth / Stencil Formats (setDepthFormat)
+#ifndef GL_DEPTH_COMPONENT16
+#define GL_DEPTH_COMPONENT16 0x81A5
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24 0x81A6
+#endif
+#ifndef GL_DEPTH_COMPONENT32F
+#define GL_DEPTH_COMPONENT32F 0x8CAC
+#endif
+#ifndef GL_DEPTH24_STENCIL8
+#define GL_DEPTH24_STENCIL8 0x88F0
+#endif
+
 // Tests & States
 #ifndef GL_DEPTH_TEST
 #define GL_DEPTH_TEST 0x0B71
@@ -169,6 +237,9 @@ using GLfloat = float;
 #ifndef GL_BLEND
 #define GL_BLEND 0x0BE2
 #endif
+#ifndef GL_PROGRAM_POINT_SIZE
+#define GL_PROGRAM_POINT_SIZE 0x8642
+#endif
 
 // Comparisons
 #ifndef GL_NEVER
@@ -419,6 +490,38 @@ using GLfloat = float;
 #define GL_TEXTURE_LOD_BIAS 0x8501
 #endif
 
+// Framebuffer Objects
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_DEPTH_ATTACHMENT
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#endif
+#ifndef GL_STENCIL_ATTACHMENT
+#define GL_STENCIL_ATTACHMENT 0x8D20
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT
+#define GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT 0x8CD6
+#endif
+#ifndef GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT
+#define GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT 0x8CD7
+#endif
+#ifndef GL_FRAMEBUFFER_UNSUPPORTED
+#define GL_FRAMEBUFFER_UNSUPPORTED 0x8CDD
+#endif
+
 namespace tinygl {
 
 // System Limits & Defaults (These are specific to tinygl implementation)
@@ -426,6 +529,23 @@ constexpr int MAX_ATTRIBS       = 16;
 constexpr int MAX_BINDINGS      = 16;
 constexpr int MAX_VARYINGS      = 8;
 constexpr int MAX_TEXTURE_UNITS = 16;
+constexpr int TEXTURE_BLOCK_CACHE_SIZE = 64; // 每线程解码块缓存条目数 (压缩纹理，必须为 2 的幂)
+constexpr int VERTEX_CACHE_SIZE = 64;   // Post-Transform Cache 条目数 (必须为 2 的幂)
+constexpr int VERTEX_BATCH_SIZE = 4;    // vertexBatch 每批顶点数 (= Simd4f 宽度)
+constexpr int RASTER_SUBPIXEL_BITS = 8; // 三角形光栅化的定点亚像素精度 (1/256 像素)
+constexpr int RASTER_BLOCK_SIZE = 8;    // 光栅化分层遍历与 Hi-Z 的块大小 (像素)
+constexpr float MAX_POINT_SIZE = 256.0f; // 点精灵的最大边长 (像素)，超出的 glPointSize / gl_PointSize 被钳制
+constexpr float GUARD_BAND_SCALE = 4.0f; // 默认 Guard Band 大小 (NDC 倍数，|x|,|y| <= scale * w 时跳过 X/Y 裁剪)
+constexpr float GUARD_BAND_SCALE_MAX = 64.0f; // 上限：保证定点边函数 (int64) 不溢出
+constexpr int MSAA_SAMPLES = 4;         // 多重采样 (setSampleCount) 支持的采样数
+// 4x MSAA 旋转网格采样点：相对像素中心的偏移 (1/16 像素)，与 D3D 标准 4x 样式一致
+constexpr int MSAA_SAMPLE_OFFSETS[MSAA_SAMPLES][2] = {{-2, -6}, {6, -2}, {-6, 2}, {2, 6}};
+constexpr int PARALLEL_TILE_SIZE = 64;  // 并行立即模式 (setParallelRasterEnabled) 的分箱 Tile 大小 (像素)
+constexpr int FRAMEBUFFER_TILE_SHIFT = 6; // 分块帧缓冲 (setTiledFramebufferEnabled) 的 Tile 边长为 1 << 6 像素，与分箱 Tile 对齐
+static_assert((1 << FRAMEBUFFER_TILE_SHIFT) % RASTER_BLOCK_SIZE == 0, "Hi-Z blocks must not straddle framebuffer tiles");
+static_assert((1 << FRAMEBUFFER_TILE_SHIFT) == PARALLEL_TILE_SIZE, "fast-clear tiles must match the binning tiles");
+constexpr int PARALLEL_MAX_DEFERRED_DRAWS = 65535;         // 单次 glFinish 前最多延迟的 Draw 数 (TileCommand::pipelineId 为 16 位)
+constexpr int PARALLEL_MAX_DEFERRED_TRIANGLES = 1 << 20;   // 超过后自动 glFinish，限制录制内存
 
 // Math & Colors
 constexpr float EPSILON         = 1e-5f;
@@ -0,0 +1,237 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "gl_defs.h"
+
+namespace tinygl {
+
+// ==========================================
+// 帧缓冲寻址 (Surface Layout)
+// ==========================================
+// 默认为行主序；FBO 的颜色附件直接使用纹理的 4x4 分块布局 (与 getTexelRaw 一致)，
+// 渲染结果无需拷贝/重排即可被采样；开启 setTiledFramebufferEnabled 后，默认帧缓冲的颜色以及
+// 所有深度/模板/多重采样存储使用 FRAMEBUFFER_TILE_SHIFT 的分块布局，每个 Tile 在内存中连续。统一为:
+// index(x, y) = ((y >> shiftY) * blocksPerRow + (x >> shiftX)) * blockPixels + (y & maskY) * blockW + (x & maskX)
+struct SurfaceLayout {
+    int shiftX = 31, shiftY = 0;
+    int maskX = 0x7FFFFFFF, maskY = 0;
+    int blockW = 0;
+    int blockPixels = 0;
+    int blocksPerRow = 1;
+    // 2x2 Quad (左上角坐标为偶数) 内 4 个 Lane 相对左上像素的偏移，Quad 不会跨块
+    int quadOffset[4] = {0, 1, 0, 1};
+
+    // 行主序：等价于单列宽度为 width 的块
+    static SurfaceLayout Linear(int width) {
+        SurfaceLayout l;
+        l.blockPixels = width;
+        l.quadOffset[2] = width;
+        l.quadOffset[3] = width + 1;
+        return l;
+    }
+
+    // (1 << shift) x (1 << shift) 分块 (块内行主序，块按行排列)，右/下边缘的块按完整大小分配
+    static SurfaceLayout Tiled(int width, int shift) {
+        SurfaceLayout l;
+        l.shiftX = shift; l.shiftY = shift;
+        l.blockW = 1 << shift;
+        l.maskX = l.blockW - 1; l.maskY = l.blockW - 1;
+        l.blockPixels = l.blockW * l.blockW;
+        l.blocksPerRow = (width + l.blockW - 1) >> shift;
+        l.quadOffset[2] = l.blockW;
+        l.quadOffset[3] = l.blockW + 1;
+        return l;
+    }
+
+    // 纹理存储的 4x4 分块布局
+    static SurfaceLayout Tiled4x4(int width) { return Tiled(width, 2); }
+
+    bool isLinear() const { return blockW == 0; }
+
+    inline size_t index(int x, int y) const {
+        return ((size_t)(y >> shiftY) * blocksPerRow + (x >> shiftX)) * blockPixels + (y & maskY) * blockW + (x & maskX);
+    }
+
+    // height 行所需的存储像素数 (含边缘块的填充)
+    size_t size(int height) const {
+        return height > 0 ? (size_t)blocksPerRow * (((height - 1) >> shiftY) + 1) * blockPixels : 0;
+    }
+
+    // 把矩形 [minX, maxX) x [minY, maxY) 拆成内存连续的行区段，依次调用 fn(offset, x, y, count)
+    template<typename Fn>
+    void forEachSpan(int minX, int minY, int maxX, int maxY, Fn&& fn) const {
+        for (int y = minY; y < maxY; ++y) {
+            for (int x = minX; x < maxX;) {
+                int n = isLinear() ? maxX - x : std::min(blockW - (x & maskX), maxX - x);
+                fn(index(x, y), x, y, n);
+                x += n;
+            }
+        }
+    }
+
+    // 与 forEachSpan 相同，但合并内存上首尾相接的区段 (完整的 Tile 或整行时只有一段)，调用 fn(offset, count)
+    template<typename Fn>
+    void forEachRun(int minX, int minY, int maxX, int maxY, Fn&& fn) const {
+        size_t start = 0, count = 0;
+        forEachSpan(minX, minY, maxX, maxY, [&](size_t offset, int, int, int n) {
+            if (count && offset == start + count) { count += n; return; }
+            if (count) fn(start, count);
+            start = offset;
+            count = n;
+        });
+        if (count) fn(start, count);
+    }
+};
+
+// ==========================================
+// 深度/模板存储格式 (setDepthFormat)
+// ==========================================
+// GL_DEPTH_COMPONENT32F: 32-bit float (默认)，模板为独立的 8-bit 数组
+// GL_DEPTH_COMPONENT24 : 24-bit unorm，存放于 32-bit 字，模板独立
+// GL_DEPTH24_STENCIL8  : 高 24 位深度 + 低 8 位模板打包为一个 32-bit 字，模板测试只访问一条缓存行
+// GL_DEPTH_COMPONENT16 : 16-bit unorm，深度带宽减半，模板独立
+inline bool isSupportedDepthFormat(GLenum format) {
+    return format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH_COMPONENT24 ||
+           format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH_COMPONENT16;
+}
+
+// 按格式访问深度/模板存储 (下标为采样点索引)。光栅化内核在入口构造一份放在寄存器里，
+// 格式分支对整个 Draw 恒定，可被完全预测
+// 定点格式下片元深度先 quantize 到存储精度再参与测试，保证测试结果与写回后读出的值一致；
+// decode 对编码值严格单调，所以比较函数的语义在各格式下保持不变
+struct DepthStencilView {
+    GLenum format = GL_DEPTH_COMPONENT32F;
+    float* f32 = nullptr;        // D32F
+    uint32_t* u32 = nullptr;     // D24 / D24S8 (深度在高 24 位)
+    uint16_t* u16 = nullptr;     // D16
+    uint8_t* stencil = nullptr;  // 独立模板 (D24S8 时为空)
+
+    // 24-bit 在 float 下 16777215 + 0.5 会舍入为 2^24 而溢出到模板位，用 double 求值
+    static uint32_t encode24(float z) { return (uint32_t)((double)std::clamp(z, 0.0f, 1.0f) * 16777215.0 + 0.5); }
+    static uint32_t encode16(float z) { return (uint32_t)(std::clamp(z, 0.0f, 1.0f) * 65535.0f + 0.5f); }
+
+    bool packedStencil() const { return format == GL_DEPTH24_STENCIL8; }
+
+    inline float quantize(float z) const {
+        switch (format) {
+            case GL_DEPTH_COMPONENT16: return (float)encode16(z) * (1.0f / 65535.0f);
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH24_STENCIL8:  return (float)encode24(z) * (1.0f / 16777215.0f);
+            default:                   return z;
+        }
+    }
+
+    inline float load(size_t i) const {
+        switch (format) {
+            case GL_DEPTH_COMPONENT16: return (float)u16[i] * (1.0f / 65535.0f);
+            case GL_DEPTH_COMPONENT24: return (float)u32[i] * (1.0f / 16777215.0f);
+            case GL_DEPTH24_STENCIL8:  return (float)(u32[i] >> 8) * (1.0f / 16777215.0f);
+            default:                   return f32[i];
+        }
+    }
+
+    inline void store(size_t i, float z) const {
+        switch (format) {
+            case GL_DEPTH_COMPONENT16: u16[i] = (uint16_t)encode16(z); break;
+            case GL_DEPTH_COMPONENT24: u32[i] = encode24(z); break;
+            case GL_DEPTH24_STENCIL8:  u32[i] = (encode24(z) << 8) | (u32[i] & 0xFFu); break;
+            default:                   f32[i] = z; break;
+        }
+    }
+
+    inline uint8_t loadStencil(size_t i) const {
+        return packedStencil() ? (uint8_t)(u32[i] & 0xFFu) : stencil[i];
+    }
+
+    inline void storeStencil(size_t i, uint8_t v) const {
+        if (packedStencil()) u32[i] = (u32[i] & ~0xFFu) | v;
+        else stencil[i] = v;
+    }
+
+    // 清除 [begin, begin + n)：clearDepth 为真时写入深度 z，模板按 stencilMask 写入 s
+    void clear(size_t begin, size_t n, bool clearDepth, float z, uint8_t stencilMask, uint8_t s) const {
+        if (packedStencil()) {
+            // 打包格式一次写完深度与模板；keep 为需要保留的位
+            uint32_t keep = (clearDepth ? 0u : 0xFFFFFF00u) | (uint8_t)~stencilMask;
+            uint32_t value = ((clearDepth ? encode24(z) << 8 : 0u) | s) & ~keep;
+            if (keep == 0) {
+                std::fill_n(u32 + begin, n, value);
+            } else if (keep != 0xFFFFFFFFu) {
+                for (size_t i = begin; i < begin + n; ++i) u32[i] = (u32[i] & keep) | value;
+            }
+            return;
+        }
+        if (clearDepth) {
+            switch (format) {
+                case GL_DEPTH_COMPONENT16: std::fill_n(u16 + begin, n, (uint16_t)encode16(z)); break;
+                case GL_DEPTH_COMPONENT24: std::fill_n(u32 + begin, n, encode24(z)); break;
+                default:                   std::fill_n(f32 + begin, n, z); break;
+            }
+        }
+        if (stencilMask == 0xFF) {
+            std::fill_n(stencil + begin, n, s);
+        } else if (stencilMask != 0) {
+            for (size_t i = begin; i < begin + n; ++i) stencil[i] = (stencil[i] & ~stencilMask) | (s & stencilMask);
+        }
+    }
+};
+
+// ==========================================
+// 快速清除 (Fast Clear) 元数据
+// ==========================================
+// 每个 (1 << FRAMEBUFFER_TILE_SHIFT) 见方的 Tile 记录待执行的清除及清除值。glClear 对完整覆盖的 Tile
+// 只更新这里 (O(Tile 数))，Tile 在第一次被光栅化触及时才真正写入 (materialize)；
+// 呈现时从未被绘制的 Tile 直接以清除值写入呈现缓冲
+enum TileClearBits : uint8_t {
+    TILE_CLEAR_COLOR   = 1,
+    TILE_CLEAR_DEPTH   = 2,
+    TILE_CLEAR_STENCIL = 4,
+};
+
+struct TileClearState {
+    uint8_t pending = 0; // TileClearBits
+    uint8_t stencil = 0;
+    uint32_t color = 0;
+    float depth = 1.0f;
+};
+
+// ==========================================
+// 帧缓冲 Surface
+// ==========================================
+// 光栅化所读写的全部逐像素存储。SoftRenderContext 只持有"当前绘制目标"的一份，
+// 绑定 FBO 时与 FBO 内保存的 Surface 整体交换 (O(1))，光栅化路径无需区分绘制目标
+struct FramebufferSurface {
+    GLsizei width = 0, height = 0;
+    uint32_t* color = nullptr;
+    SurfaceLayout colorLayout;
+    SurfaceLayout pixelLayout; // 深度/模板/多重采样颜色的寻址
+    GLenum depthFormat = GL_DEPTH_COMPONENT32F;
+    std::vector<float> depth;
+    std::vector<uint32_t> depth24;
+    std::vector<uint16_t> depth16;
+    std::vector<uint8_t> stencil;
+    std::vector<float> hiz;
+    int hizWidth = 0, hizHeight = 0;
+    std::vector<TileClearState> clearTiles;
+    int clearTilesX = 0, clearTilesY = 0;
+    bool clearPending = false;
+    // MSAA 只用于默认帧缓冲，FBO 始终单采样
+    int sampleCount = 1;
+    std::vector<uint32_t> sampleColor;
+    bool resolvePending = false;
+};
+
+// Framebuffer Object
+// 颜色附件为 TextureObject 的某一 Mip 层 (直接写入其 4x4 分块存储)；
+// 深度/模板没有独立附件，由 FBO 内部按颜色附件尺寸分配
+struct FramebufferObject {
+    GLuint colorTexture = 0;
+    GLint colorLevel = 0;
+    bool autoMipmap = false; // 解绑时按需重建颜色纹理的 Mipmap (仅 Level 0 附件)
+    bool dirty = false;      // 绑定期间颜色附件被写入过
+    FramebufferSurface surface; // 未绑定时保存本 FBO 的 Surface；绑定期间为空
+};
+
+}
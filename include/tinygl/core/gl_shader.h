@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <memory>
 #include "../base/tmath.h"
+#include "../base/math_simd.h"
 #include "gl_defs.h"
 #include "gl_texture.h"
 
@@ -26,14 +27,23 @@ struct ShaderFragDepth {
     operator float() const { return value; }
 };
 
+// 2x2 Quad 内 Varyings 的屏幕空间偏导 (Coarse: 同一 Quad 内 4 个像素共享)
+// dx = V(x+1, y) - V(x, y), dy = V(x, y+1) - V(x, y)
+struct QuadDerivatives {
+    Vec4 dx[MAX_VARYINGS];
+    Vec4 dy[MAX_VARYINGS];
+};
+
 struct ShaderBuiltins {
     // --- Vertex Shader Outputs ---
     Vec4 gl_Position;
-    float gl_PointSize = 1.0f;
+    float gl_PointSize = 1.0f; // 仅在 glEnable(GL_PROGRAM_POINT_SIZE) 时生效，否则使用 glPointSize
 
     // --- Fragment Shader Inputs ---
     Vec4 gl_FragCoord;   // (x, y, z, 1/w) in screen space
     bool gl_FrontFacing; // true if front facing
+    const QuadDerivatives* gl_Derivatives = nullptr; // 由三角形光栅化按 Quad 填充，线/点为 nullptr
+    Vec2 gl_PointCoord = {0.0f, 0.0f}; // 点精灵内的坐标 [0, 1]，左上角为 (0, 0)；仅点图元有效
 
     // --- Fragment Shader Outputs ---
     Vec4 gl_FragColor;
@@ -42,12 +52,29 @@ struct ShaderBuiltins {
 
     // Helper to trigger discard
     void discard() { gl_Discard = true; }
+
+    // GLSL dFdx / dFdy：返回第 varying 个插值量的屏幕空间偏导
+    Vec4 dFdx(int varying) const {
+        return gl_Derivatives ? gl_Derivatives->dx[varying] : Vec4(0, 0, 0, 0);
+    }
+    Vec4 dFdy(int varying) const {
+        return gl_Derivatives ? gl_Derivatives->dy[varying] : Vec4(0, 0, 0, 0);
+    }
+
+    // 由任意 Varying 中的 UV (xy) 计算纹理采样所需的 rho (UV Span per Screen Pixel)
+    // 用法: texture->sample(uv.x, uv.y, lodRho(2));
+    float lodRho(int uvVarying) const {
+        if (!gl_Derivatives) return 0.0f;
+        const Vec4& dx = gl_Derivatives->dx[uvVarying];
+        const Vec4& dy = gl_Derivatives->dy[uvVarying];
+        return std::sqrt(std::max(dx.x * dx.x + dx.y * dx.y, dy.x * dy.x + dy.y * dy.y));
+    }
 };
 
 // Shader & Program
 struct ShaderContext { 
     Vec4 varyings[MAX_VARYINGS]; 
-    float rho = 0.0f; // 纹理导数模长 ( UV单位 / 屏幕像素 ) (UV Span per Screen Pixel)
+    float rho = 0.0f; // 纹理导数模长 ( UV单位 / 屏幕像素 ) (UV Span per Screen Pixel)，取自 varyings[0].xy，其他 Varying 请用 lodRho()
     
     // Per-Fragment Operations control
 
@@ -56,13 +83,67 @@ struct ShaderContext {
     }
 };
 
+// 批量顶点着色 (可选)：Shader 实现 void vertexBatch(const Vec4Packet* attribs, VertexBatchContext& ctx) 时，
+// 三角形绘制会按 VERTEX_BATCH_SIZE 个顶点一批调用它代替逐顶点的 vertex()。
+// attribs[a] 为属性 a 的 SoA 打包；不足一批时，多余 lane 重复最后一个顶点，结果被丢弃。
+struct VertexBatchContext {
+    Vec4Packet gl_Position;
+    Vec4Packet varyings[MAX_VARYINGS];
+    Simd4f gl_PointSize; // 调用前填充为 shader.gl_PointSize
+};
+
 // VOut: 顶点着色器的输出，也是裁剪阶段的输入
 struct VOut { 
     Vec4 pos;       // Clip Space Position (未除以 w)
     Vec4 scn;       // Screen Space Position (已除以 w)
     ShaderContext ctx; 
+    float pointSize = 1.0f; // gl_PointSize
 };
 
+// Shader 可声明 static constexpr int kVaryings = N，表示只使用 varyings[0, N)
+// 光栅化 Setup、逐像素插值、裁剪插值与顶点拷贝都只处理前 N 个；未声明时按 MAX_VARYINGS 处理
+template <typename ShaderT>
+constexpr int shaderVaryingCount() {
+    if constexpr (requires { ShaderT::kVaryings; }) {
+        static_assert(ShaderT::kVaryings >= 0 && ShaderT::kVaryings <= MAX_VARYINGS, "kVaryings must be in [0, MAX_VARYINGS]");
+        return ShaderT::kVaryings;
+    } else {
+        return MAX_VARYINGS;
+    }
+}
+
+// Fragment Shader 是否写 gl_FragDepth：Shader 可声明 static constexpr bool kWritesFragDepth = true
+// 声明后 Hi-Z / Early-Z 不再用插值深度提前剔除，深度测试推迟到 Shader 之后；
+// 未声明时认为不写 (保持提前剔除)，运行时写了 gl_FragDepth 的片元仍在输出合并阶段按最终深度重新测试
+template <typename ShaderT>
+constexpr bool shaderWritesFragDepth() {
+    if constexpr (requires { ShaderT::kWritesFragDepth; }) return ShaderT::kWritesFragDepth;
+    return false;
+}
+
+// Fragment Shader 是否可能 discard：Shader 可声明 static constexpr bool kUsesDiscard = false
+// 只用于 Depth-Only 路径 (discard 不影响提前深度剔除：Early-Z 只读深度缓冲，深度在片元通过 Shader 后才写入)
+// 未声明时保守地认为会 discard
+template <typename ShaderT>
+constexpr bool shaderUsesDiscard() {
+    if constexpr (requires { ShaderT::kUsesDiscard; }) return ShaderT::kUsesDiscard;
+    return true;
+}
+
+// 只拷贝前 N 个 Varying 的顶点拷贝 (之后的 Varying 保留目标中的旧值，管线不会读取)
+template <int N>
+inline void copyVertex(VOut& dst, const VOut& src) {
+    if constexpr (N == MAX_VARYINGS) {
+        dst = src;
+    } else {
+        dst.pos = src.pos;
+        dst.scn = src.scn;
+        dst.ctx.rho = src.ctx.rho;
+        dst.pointSize = src.pointSize;
+        for (int k = 0; k < N; ++k) dst.ctx.varyings[k] = src.ctx.varyings[k];
+    }
+}
+
 struct UniformValue {
     enum Type { INT, FLOAT, MAT4 } type;
     union { int i; float f; float mat[16]; } data;
@@ -4,13 +4,17 @@
 #include <cmath>
 #include <string>
 #include <iostream>
+#include <type_traits>
 #include "../base/tmath.h"
+#include "../base/math_simd.h"
 #include "../base/log.h"
 #include "gl_defs.h"
+#include "texture_codec.h"
 
 namespace tinygl {
 
 struct TextureObject;
+class JobSystem;
 
 // 定义函数指针类型，用于存储当前生效的采样逻辑
 using SamplerFunc = Vec4 (*)(const TextureObject& obj, float u, float v, float rho);
@@ -64,15 +68,18 @@ template <> struct WrapPolicy<GL_CLAMP_TO_BORDER> {
 // --- 2. 过滤策略 (Filter Policies) ---
 // MinFilter, MagFilter: 过滤模式
 // TWrapS, TWrapT: 环绕策略类
-template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT>
+// TFormat: 存储格式策略类 (TexelPolicy，见下文)
+template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT, typename TFormat>
 struct FilterPolicy {
-    static Vec4 sample(const TextureObject& obj, float u, float v, float rho);
+    // 强制内联：activeSampler 取址时仍生成独立函数体，Sampler (类型化采样器) 可整体展开到着色器中
+    SIMD_INLINE static Vec4 sample(const TextureObject& obj, float u, float v, float rho);
     
 private:
     // 辅助：获取单个像素 (Nearest)
     static Vec4 getTexel(const TextureObject& obj, int level, int x, int y);
-    // 辅助：双线性插值 (Bilinear)
-    static Vec4 sampleBilinear(const TextureObject& obj, int level, float uw, float vw);
+    // 辅助：双线性插值 (Bilinear)，一次取出 2x2 足迹，SIMD 解包与加权
+    static Simd4f sampleBilinear(const TextureObject& obj, int level, float uw, float vw);
+    static Vec4 toVec4(const Simd4f& c) { Vec4 r; c.store(r); return r; }
 };
 
 // Texture Object Definition
@@ -83,10 +90,17 @@ struct TINYGL_API TextureObject {
     }
 
     // --- Mipmap Generation (Box Filter) ---
-    void generateMipmaps();
+    // 链已由上次调用生成且之后只有 glTexSubImage2D 改写过 Level 0 时，只重建脏矩形在各层的足迹
+    // 整链重建时一次性分配所有层级；按 4x4 块生成 (RGBA8 走整数 SIMD)，jobs 非空时较大的层级按块行分带并行
+    void generateMipmaps(JobSystem* jobs = nullptr);
+    static constexpr int MIPMAP_BAND_BLOCK_ROWS = 4;              // 并行时每个任务处理的块行数
+    static constexpr size_t MIPMAP_PARALLEL_MIN_TEXELS = 128 * 128; // 单层待重建区域小于此值时串行
+
+    // 记录 level 层 [x, x + w) x [y, y + h) 被改写：Level 0 扩大脏矩形，其余层级使 Mipmap 链失效
+    void markLevelDirty(int level, int x, int y, int w, int h);
 
     // 更新采样器函数指针
-    // 当 glTexParameteri 改变 wrapS, wrapT, minFilter, magFilter 时调用
+    // 当 glTexParameteri 改变 wrapS, wrapT, minFilter, magFilter 或存储格式改变时调用
     void updateSampler();
     
     // --- Data ---
@@ -94,7 +108,9 @@ struct TINYGL_API TextureObject {
     GLsizei width = 0, height = 0;
     
     // Flattened Mipmap Storage
+    // 每层按 4x4 块行优先排列，每块 textureBlockWords(format) 个 uint32_t (非压缩格式为 16 个紧密排列的 texel)
     std::vector<uint32_t> data; 
+    GLenum format = GL_RGBA8; // 存储格式 (所有层级相同，改变时需 updateSampler)
 
     struct MipLevelInfo {
         size_t offset;
@@ -102,6 +118,15 @@ struct TINYGL_API TextureObject {
     };
     std::vector<MipLevelInfo> mipLevels;
 
+    // 增量 Mipmap 状态：mipChainValid 表示 Level 1..N 由 generateMipmaps 从 Level 0 生成，
+    // 之后 Level 0 只在脏矩形 [dirtyX0, dirtyX1) x [dirtyY0, dirtyY1) 内变化 (空矩形表示无变化)。
+    // 层级被重新定义、直接改写或作为 FBO 附件被渲染时清零，下次 generateMipmaps 整链重建。
+    bool mipChainValid = false;
+    int dirtyX0 = 0, dirtyY0 = 0, dirtyX1 = 0, dirtyY1 = 0;
+
+    // Mipmap 在线性空间平均 RGB (数据按 sRGB 编码存储，仅 RGBA8 与压缩格式生效；采样本身不做转换)
+    bool srgbMipmaps = false;
+
     // 纹理参数状态
     GLenum wrapS = GL_REPEAT;
     GLenum wrapT = GL_REPEAT;
@@ -123,47 +148,131 @@ struct TINYGL_API TextureObject {
         // 默认为 Repeat + Nearest/Linear
         updateSampler();
     }
+
+private:
+    // 存储格式确定后按 wrap / filter 选择采样函数
+    template <typename TFormat> void selectSampler();
 };
 
 // ==========================================
 // 模版实现细节 (Template Implementations)
 // ==========================================
 
+// --- 3. 存储格式策略 (Texel Policies) ---
+// 每种存储格式一份取数实现，与过滤 / 环绕策略一起由 updateSampler 在编译期组合：
+//   block(obj, info, x, y): (x, y) 所在 4x4 块的 16 个 texel (块内 ly * 4 + lx)
+//   load(block, i): 第 i 个 texel 的分量，范围 [0, kRange]，缺失分量按 GL 规则补为 (0, 0, 1)
+// kRange 的倒数并入过滤权重，避免逐 texel 归一化
+template <int TexelBytes>
+struct UncompressedTexelPolicy {
+    SIMD_INLINE static const uint8_t* block(const TextureObject& obj, const TextureObject::MipLevelInfo& info, int x, int y) {
+        const size_t b = (size_t)(y >> 2) * ((info.width + 3) >> 2) + (x >> 2);
+        return reinterpret_cast<const uint8_t*>(obj.data.data() + info.offset) + b * (16 * TexelBytes);
+    }
+};
+
+template <GLenum Format> struct TexelPolicy;
+
+template <> struct TexelPolicy<GL_RGBA8> : UncompressedTexelPolicy<4> {
+    static constexpr float kRange = 255.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        return Simd4f::unpackRGBA8(reinterpret_cast<const uint32_t*>(block)[i]);
+    }
+};
+
+template <> struct TexelPolicy<GL_R8> : UncompressedTexelPolicy<1> {
+    static constexpr float kRange = 255.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) { return Simd4f((float)block[i], 0.0f, 0.0f, 255.0f); }
+};
+
+template <> struct TexelPolicy<GL_RG8> : UncompressedTexelPolicy<2> {
+    static constexpr float kRange = 255.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        return Simd4f((float)block[i * 2], (float)block[i * 2 + 1], 0.0f, 255.0f);
+    }
+};
+
+// R5G6B5 (R 在高位，与 GL_UNSIGNED_SHORT_5_6_5 一致)：各通道位宽不同，直接归一化
+template <> struct TexelPolicy<GL_RGB565> : UncompressedTexelPolicy<2> {
+    static constexpr float kRange = 1.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        const uint16_t p = reinterpret_cast<const uint16_t*>(block)[i];
+        return Simd4f((float)(p >> 11) * (1.0f / 31.0f), (float)((p >> 5) & 0x3F) * (1.0f / 63.0f),
+                      (float)(p & 0x1F) * (1.0f / 31.0f), 1.0f);
+    }
+};
+
+// R4G4B4A4 (R 在高位，与 GL_UNSIGNED_SHORT_4_4_4_4 一致)
+template <> struct TexelPolicy<GL_RGBA4> : UncompressedTexelPolicy<2> {
+    static constexpr float kRange = 15.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        const uint16_t p = reinterpret_cast<const uint16_t*>(block)[i];
+        return Simd4f((float)(p >> 12), (float)((p >> 8) & 0xF), (float)((p >> 4) & 0xF), (float)(p & 0xF));
+    }
+};
+
+template <> struct TexelPolicy<GL_R16F> : UncompressedTexelPolicy<2> {
+    static constexpr float kRange = 1.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        return Simd4f(halfToFloat(reinterpret_cast<const uint16_t*>(block)[i]), 0.0f, 0.0f, 1.0f);
+    }
+};
+
+template <> struct TexelPolicy<GL_R32F> : UncompressedTexelPolicy<4> {
+    static constexpr float kRange = 1.0f;
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        return Simd4f(reinterpret_cast<const float*>(block)[i], 0.0f, 0.0f, 1.0f);
+    }
+};
+
+// 压缩格式 (BC1 / BC3 / ETC2)：(x, y) 所在块在取数时解码为 16 个 RGBA8，经每线程块缓存复用
+// 缓存槽可能被下一次 block 调用覆盖，取到块后须先 load 再取下一块
+struct CompressedTexelPolicy {
+    static constexpr float kRange = 255.0f;
+    SIMD_INLINE static const uint8_t* block(const TextureObject& obj, const TextureObject::MipLevelInfo& info, int x, int y) {
+        const size_t b = (size_t)(y >> 2) * ((info.width + 3) >> 2) + (x >> 2);
+        return reinterpret_cast<const uint8_t*>(
+            decodeTextureBlockCached(obj.format, obj.data.data() + info.offset + b * textureBlockWords(obj.format)));
+    }
+    SIMD_INLINE static Simd4f load(const uint8_t* block, int i) {
+        return Simd4f::unpackRGBA8(reinterpret_cast<const uint32_t*>(block)[i]);
+    }
+};
+
+// (x, y) 处的 texel，范围 [0, TFormat::kRange]
+template <typename TFormat>
+SIMD_INLINE Simd4f loadTexel(const TextureObject& obj, const TextureObject::MipLevelInfo& info, int x, int y) {
+    return TFormat::load(TFormat::block(obj, info, x, y), ((y & 3) << 2) | (x & 3));
+}
+
+template <typename TFormat>
+inline Vec4 loadTexelVec4(const TextureObject& obj, const TextureObject::MipLevelInfo& info, int x, int y) {
+    Vec4 r;
+    (loadTexel<TFormat>(obj, info, x, y) * Simd4f(1.0f / TFormat::kRange)).store(r);
+    return r;
+}
+
 // 辅助：获取 Texel (4x4 Tiled Layout Optimization)
+// 运行时按存储格式分派，供 Mipmap 生成等非采样路径使用；采样路径在 updateSampler 时已确定格式
 inline Vec4 getTexelRaw(const TextureObject& obj, int level, int x, int y) {
     if (level < 0 || level >= static_cast<int>(obj.mipLevels.size())) return {0,0,0,1};
+
+    // data 按 4x4 块补齐分配 (glTexImage2D / generateMipmaps)
     const auto& info = obj.mipLevels[level];
-    
-    // 4x4 Tiling Addressing
-    // Ensure we don't access out of bounds if the texture wasn't padded (though we should pad it)
-    // Assuming data is stored in 4x4 tiles.
-    
-    // Number of blocks per row
-    int blocksPerRow = (info.width + 3) / 4;
-    
-    int bx = x / 4;
-    int by = y / 4;
-    int lx = x % 4;
-    int ly = y % 4;
-    
-    // Block Index
-    int blockIdx = by * blocksPerRow + bx;
-    
-    // Pixel Index: Block Start + (ly * 4 + lx)
-    // Each block is 16 pixels
-    size_t pixelIdx = blockIdx * 16 + (ly * 4 + lx);
-    
-    // Safety check (optional in release, but good for stability if padding logic fails)
-    // Note: The data vector size should be sufficient for the padded dimensions.
-    // We trust glTexImage2D allocated enough.
-    
-    uint32_t p = obj.data[info.offset + pixelIdx];
-    constexpr float k = 1.0f / 255.0f;
-    return Vec4((p&0xFF)*k, ((p>>8)&0xFF)*k, ((p>>16)&0xFF)*k, ((p>>24)&0xFF)*k);
+    switch (obj.format) {
+        case GL_RGBA8:  return loadTexelVec4<TexelPolicy<GL_RGBA8>>(obj, info, x, y);
+        case GL_R8:     return loadTexelVec4<TexelPolicy<GL_R8>>(obj, info, x, y);
+        case GL_RG8:    return loadTexelVec4<TexelPolicy<GL_RG8>>(obj, info, x, y);
+        case GL_RGB565: return loadTexelVec4<TexelPolicy<GL_RGB565>>(obj, info, x, y);
+        case GL_RGBA4:  return loadTexelVec4<TexelPolicy<GL_RGBA4>>(obj, info, x, y);
+        case GL_R16F:   return loadTexelVec4<TexelPolicy<GL_R16F>>(obj, info, x, y);
+        case GL_R32F:   return loadTexelVec4<TexelPolicy<GL_R32F>>(obj, info, x, y);
+        default:        return loadTexelVec4<CompressedTexelPolicy>(obj, info, x, y);
+    }
 }
 
-template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT>
-Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::getTexel(const TextureObject& obj, int level, int x, int y) {
+template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT, typename TFormat>
+Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT, TFormat>::getTexel(const TextureObject& obj, int level, int x, int y) {
     // 处理 Wrap (Integer domain)
     int wx = TWrapS::applyInt(x, obj.mipLevels[level].width);
     int wy = TWrapT::applyInt(y, obj.mipLevels[level].height);
@@ -172,11 +281,11 @@ Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::getTexel(const TextureO
         TWrapT::checkBorderInt(wy, obj.mipLevels[level].height)) {
         return obj.borderColor;
     }
-    return getTexelRaw(obj, level, wx, wy);
+    return loadTexelVec4<TFormat>(obj, obj.mipLevels[level], wx, wy);
 }
 
-template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT>
-Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sampleBilinear(const TextureObject& obj, int level, float uw, float vw) {
+template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT, typename TFormat>
+Simd4f FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT, TFormat>::sampleBilinear(const TextureObject& obj, int level, float uw, float vw) {
     const auto& info = obj.mipLevels[level];
     float uImg = uw * info.width - 0.5f;
     float vImg = vw * info.height - 0.5f;
@@ -202,16 +311,44 @@ Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sampleBilinear(const Te
     bool b01 = TWrapS::checkBorderInt(x0w, w) || TWrapT::checkBorderInt(y1w, h);
     bool b11 = TWrapS::checkBorderInt(x1w, w) || TWrapT::checkBorderInt(y1w, h);
 
-    Vec4 c00 = b00 ? obj.borderColor : getTexelRaw(obj, level, x0w, y0w);
-    Vec4 c10 = b10 ? obj.borderColor : getTexelRaw(obj, level, x1w, y0w);
-    Vec4 c01 = b01 ? obj.borderColor : getTexelRaw(obj, level, x0w, y1w);
-    Vec4 c11 = b11 ? obj.borderColor : getTexelRaw(obj, level, x1w, y1w);
+    // 4 个 Texel 解包为 [0, kRange]，1/kRange 并入权重
+    const bool sameBlock = ((x0w ^ x1w) | (y0w ^ y1w)) < 4;
+    Simd4f c00, c10, c01, c11;
+    if (!(b00 || b10 || b01 || b11)) { // 非 CLAMP_TO_BORDER 时编译期恒为 true
+        const uint8_t* p = TFormat::block(obj, info, x0w, y0w);
+        const int i = ((y0w & 3) << 2) | (x0w & 3);
+        c00 = TFormat::load(p, i);
+        if (sameBlock) {
+            // 2x2 足迹落在同一个 4x4 块内 (常见情况)：共用块基址 (压缩格式只解码一次)，块内偏移直接相加
+            const int dx = x1w - x0w;
+            const int dy = (y1w - y0w) * 4;
+            c10 = TFormat::load(p, i + dx);
+            c01 = TFormat::load(p, i + dy);
+            c11 = TFormat::load(p, i + dx + dy);
+        } else {
+            c10 = loadTexel<TFormat>(obj, info, x1w, y0w);
+            c01 = loadTexel<TFormat>(obj, info, x0w, y1w);
+            c11 = loadTexel<TFormat>(obj, info, x1w, y1w);
+        }
+    } else {
+        const Simd4f border = Simd4f::load(obj.borderColor) * Simd4f(TFormat::kRange);
+        auto fetch = [&](bool b, int x, int y) {
+            return b ? border : loadTexel<TFormat>(obj, info, x, y);
+        };
+        c00 = fetch(b00, x0w, y0w);
+        c10 = fetch(b10, x1w, y0w);
+        c01 = fetch(b01, x0w, y1w);
+        c11 = fetch(b11, x1w, y1w);
+    }
 
-    return mix(mix(c00, c10, s), mix(c01, c11, s), t);
+    constexpr float k = 1.0f / TFormat::kRange;
+    const float s0 = (1.0f - s) * k, s1 = s * k;
+    const float t0 = 1.0f - t;
+    return (c00 * Simd4f(s0 * t0)).madd(c10, Simd4f(s1 * t0)).madd(c01, Simd4f(s0 * t)).madd(c11, Simd4f(s1 * t));
 }
 
-template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT>
-Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sample(const TextureObject& obj, float u, float v, float rho) {
+template <GLenum MinFilter, GLenum MagFilter, typename TWrapS, typename TWrapT, typename TFormat>
+SIMD_INLINE Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT, TFormat>::sample(const TextureObject& obj, float u, float v, float rho) {
     if (obj.mipLevels.empty()) return {1, 0, 1, 1};
 
     // 1. 边界检查 (编译期消除)
@@ -240,7 +377,7 @@ Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sample(const TextureObj
             const auto& info = obj.mipLevels[0];
             return getTexel(obj, 0, (int)(uw * info.width), (int)(vw * info.height));
         } else {
-            return sampleBilinear(obj, 0, uw, vw);
+            return toVec4(sampleBilinear(obj, 0, uw, vw));
         }
     }
 
@@ -251,7 +388,7 @@ Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sample(const TextureObj
         return getTexel(obj, 0, (int)(uw * obj.mipLevels[0].width), (int)(vw * obj.mipLevels[0].height));
     } 
     else if constexpr (MinFilter == GL_LINEAR) {
-        return sampleBilinear(obj, 0, uw, vw);
+        return toVec4(sampleBilinear(obj, 0, uw, vw));
     }
     else if constexpr (MinFilter == GL_NEAREST_MIPMAP_NEAREST) {
         int lvl = (int)std::round(level);
@@ -259,7 +396,7 @@ Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sample(const TextureObj
         return getTexel(obj, lvl, (int)(uw * info.width), (int)(vw * info.height));
     }
     else if constexpr (MinFilter == GL_LINEAR_MIPMAP_NEAREST) {
-        return sampleBilinear(obj, (int)std::round(level), uw, vw);
+        return toVec4(sampleBilinear(obj, (int)std::round(level), uw, vw));
     }
     else if constexpr (MinFilter == GL_NEAREST_MIPMAP_LINEAR) {
         int l0 = (int)std::floor(level);
@@ -277,8 +414,52 @@ Vec4 FilterPolicy<MinFilter, MagFilter, TWrapS, TWrapT>::sample(const TextureObj
         int l0 = (int)std::floor(level);
         int l1 = std::min(l0 + 1, (int)maxLevel);
         float f = level - (float)l0;
-        return mix(sampleBilinear(obj, l0, uw, vw), sampleBilinear(obj, l1, uw, vw), f);
+        // 两层的 2x2 足迹都在寄存器中加权，层间插值后只写回一次
+        const Simd4f c0 = sampleBilinear(obj, l0, uw, vw);
+        const Simd4f c1 = sampleBilinear(obj, l1, uw, vw);
+        return toVec4(c0.madd(c1 - c0, Simd4f(f)));
     }
 }
 
+// --- 4. 类型化采样器 (Typed Sampler) ---
+// 着色器在编译期已知纹理的过滤 / 环绕 / 存储格式时使用，sample 直接展开对应的 FilterPolicy，
+// 不经过 activeSampler 间接调用，采样代码可与着色器一起内联、做寄存器分配与常量折叠。
+// bind 时检查纹理参数是否与模板参数一致 (通常在 BindResources 中调用，参数改变后需重新 bind)；
+// 不一致时 sample 退回 TextureObject::sample (activeSampler)。
+// 用法:
+//   Sampler<GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT> diffuse;
+//   void BindResources(SoftRenderContext& ctx) { diffuse.bind(ctx.getTexture(0)); }
+//   void fragment(const ShaderContext& ctx) { gl_FragColor = diffuse.sample(uv.x, uv.y, ctx.rho); }
+template <GLenum MinFilter, GLenum MagFilter, GLenum WrapS, GLenum WrapT, GLenum Format = GL_RGBA8>
+struct Sampler {
+    using TexelFormat = std::conditional_t<textureTexelBytes(Format) != 0, TexelPolicy<Format>, CompressedTexelPolicy>;
+    using Policy = FilterPolicy<MinFilter, MagFilter, WrapPolicy<WrapS>, WrapPolicy<WrapT>, TexelFormat>;
+
+    // 过滤、环绕与存储格式都与模板参数一致时才可走内联路径
+    static bool matches(const TextureObject& tex) {
+        return tex.minFilter == MinFilter && tex.magFilter == MagFilter &&
+               tex.wrapS == WrapS && tex.wrapT == WrapT && tex.format == Format;
+    }
+
+    // 绑定纹理 (可为空)，返回是否走内联路径
+    bool bind(const TextureObject* tex) {
+        m_texture = tex;
+        m_inlined = tex && matches(*tex);
+        return m_inlined;
+    }
+
+    const TextureObject* texture() const { return m_texture; }
+    bool isInlined() const { return m_inlined; }
+    explicit operator bool() const { return m_texture != nullptr; }
+
+    SIMD_INLINE Vec4 sample(float u, float v, float rho = 0.0f) const {
+        if (m_inlined) [[likely]] return Policy::sample(*m_texture, u, v, rho);
+        return m_texture->sample(u, v, rho);
+    }
+
+private:
+    const TextureObject* m_texture = nullptr;
+    bool m_inlined = false;
+};
+
 } // namespace tinygl
\ No newline at end of file
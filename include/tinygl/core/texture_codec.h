@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <tinygl/core/gl_defs.h> // For TINYGL_API
+
+namespace tinygl {
+
+// ==========================================
+// 块压缩纹理编解码 (BC1 / BC3 / ETC2)
+// ==========================================
+// 所有格式都以 4x4 块为单位，块按行优先排列，与 TextureObject 的 4x4 分块布局一一对应：
+// 非压缩格式每块 16 个 texel (块内 ly * 4 + lx 紧密排列)，按 texel 字节数占 4 (R8) 到 16 (RGBA8 / R32F) 个 uint32_t；
+// 压缩格式每块 2 (BC1 / ETC2 RGB) 或 4 (BC3 / ETC2 RGBA) 个 uint32_t。
+// 解码结果为块内 (ly * 4 + lx) 排列的 16 个 RGBA8 (R 在低字节，与 getTexelRaw 一致)。
+
+inline bool isCompressedTextureFormat(GLenum format) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 非压缩格式每个 texel 的字节数，压缩或不支持的格式返回 0
+constexpr int textureTexelBytes(GLenum format) {
+    switch (format) {
+        case GL_R8: return 1;
+        case GL_RG8:
+        case GL_RGB565:
+        case GL_RGBA4:
+        case GL_R16F: return 2;
+        case GL_RGBA8:
+        case GL_R32F: return 4;
+        default: return 0;
+    }
+}
+
+// 每个 4x4 块占用的 uint32_t 数，不支持的格式返回 0
+inline int textureBlockWords(GLenum format) {
+    if (int bytes = textureTexelBytes(format)) return bytes * 4;
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGB8_ETC2: return 2;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC: return 4;
+        default: return 0;
+    }
+}
+
+// w x h 图像在 format 下的存储大小 (uint32_t 数，按 4x4 块补齐)
+inline size_t textureImageWords(GLenum format, int w, int h) {
+    return (size_t)((w + 3) / 4) * ((h + 3) / 4) * textureBlockWords(format);
+}
+
+// IEEE half <-> float (R16F 存储)
+// 规格化数直接平移指数；非规格化数先按规格化数拼出再减去隐含的 2^-14，全程不产生非规格化 float (不受 FTZ / DAZ 影响)
+inline float halfToFloat(uint16_t h) {
+    uint32_t bits = (uint32_t)(h & 0x7FFFu) << 13;
+    const uint32_t exp = bits & 0x0F800000u;
+    bits += (127 - 15) << 23;
+    if (exp == 0x0F800000u) bits += (128 - 16) << 23; // Inf / NaN
+    else if (exp == 0) bits += 1u << 23;
+    float f;
+    std::memcpy(&f, &bits, 4);
+    if (exp == 0) f -= 6.103515625e-05f; // 2^-14
+    return (h & 0x8000u) ? -f : f;
+}
+
+// 就近舍入到偶数，超出 half 范围变为 Inf
+inline uint16_t floatToHalf(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, 4);
+    const uint16_t sign = (uint16_t)((x >> 16) & 0x8000u);
+    x &= 0x7FFFFFFFu;
+    if (x >= 0x7F800000u) return sign | 0x7C00u | (x > 0x7F800000u ? 0x200u : 0u); // Inf / NaN
+    if (x >= 0x477FF000u) return sign | 0x7C00u;                                    // >= 65520
+    if (x < 0x38800000u) {                                                            // < 2^-14：非规格化 half
+        if (x < 0x33000000u) return sign;                                             // < 2^-25
+        const uint32_t e = x >> 23;
+        const uint32_t m = (x & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126 - e;
+        uint32_t h = m >> shift;
+        const uint32_t rem = m & ((1u << shift) - 1), half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1))) ++h;
+        return sign | (uint16_t)h;
+    }
+    uint32_t h = (x - 0x38000000u) >> 13;
+    const uint32_t rem = x & 0x1FFFu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1))) ++h; // 进位溢出到指数仍是正确结果
+    return sign | (uint16_t)h;
+}
+
+// 单块编解码：texels 为块内 16 个 RGBA8
+TINYGL_API void decodeTextureBlock(GLenum format, const uint32_t* block, uint32_t* texels);
+TINYGL_API void encodeTextureBlock(GLenum format, const uint32_t* texels, uint32_t* block);
+
+// 行优先的 w x h RGBA8 图像整体编码为块数组；不足 4x4 的边缘块复制边缘像素补齐，避免填充值拉偏端点
+TINYGL_API void encodeTextureImage(GLenum format, const uint32_t* pixels, int w, int h, uint32_t* blocks);
+
+// 解码块缓存 (每线程 TEXTURE_BLOCK_CACHE_SIZE 项，直接映射，以块地址为键)
+// 返回的指针在同一线程下一次调用前有效
+TINYGL_API const uint32_t* decodeTextureBlockCached(GLenum format, const uint32_t* block);
+// 压缩数据被改写或重新分配后调用，使所有线程的缓存项失效
+TINYGL_API void invalidateDecodedBlocks();
+
+} // namespace tinygl
@@ -46,6 +46,9 @@ public:
     // dataOffset is the byte offset or index in LinearAllocator where the triangle data is stored
     void BinTriangle(const TriangleData& tri, uint16_t pipelineId, uint32_t dataOffset, uint32_t uniformOffset);
 
+    // Add a command to all tiles overlapping the pixel rect [minX, maxX] x [minY, maxY] (inclusive)
+    void BinRect(int minX, int minY, int maxX, int maxY, const TileCommand& cmd);
+
     Tile& GetTile(int x, int y) {
         return m_tiles[y * m_gridWidth + x];
     }
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include "gl_defs.h"
+#include "gl_shader.h"
+
+namespace tinygl {
+
+// 顶点缓存命中统计 (跨 Draw Call 累计，直到手动 reset)
+struct VertexCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    float hitRate() const {
+        uint64_t total = hits + misses;
+        return total ? (float)hits / (float)total : 0.0f;
+    }
+};
+
+// ==========================================
+// Post-Transform Vertex Cache
+// ==========================================
+// 直接映射 (Direct-Mapped) 缓存，Key = (index, instanceID)，Value = Vertex Shader 输出 (VOut)
+// 索引网格中每个顶点平均被约 6 个三角形共享，命中时可跳过 fetchAttribute + shader.vertex()
+// 注意：Uniform 可能在 Draw Call 之间改变，所以每次 Draw 开始时必须 invalidate()
+class VertexCache {
+public:
+    static_assert((VERTEX_CACHE_SIZE & (VERTEX_CACHE_SIZE - 1)) == 0, "VERTEX_CACHE_SIZE must be a power of two");
+
+    // O(1) 失效：只递增 epoch，不清空条目
+    void invalidate() {
+        if (++epoch == 0) {
+            for (auto& e : entries) e.epoch = 0;
+            epoch = 1;
+        }
+    }
+
+    // 返回 (index, instanceID) 对应的槽位
+    // hit == true : 槽位中已是有效的着色结果
+    // hit == false: 槽位已被重新标记，调用者必须立即把着色结果写入返回的 VOut
+    // 返回的引用在下一次 slot() 调用后可能失效 (冲突替换)，调用者应立即拷贝
+    inline VOut& slot(uint32_t index, int instanceID, bool& hit) {
+        Entry& e = entries[index & (VERTEX_CACHE_SIZE - 1)];
+        hit = (e.epoch == epoch && e.index == index && e.instance == instanceID);
+        if (hit) {
+            stats.hits++;
+        } else {
+            stats.misses++;
+            e.epoch = epoch;
+            e.index = index;
+            e.instance = instanceID;
+        }
+        return e.vertex;
+    }
+
+    // 批量着色路径：先 find() 查询 (计入统计)，未命中的顶点成批着色后再 insert()
+    inline const VOut* find(uint32_t index, int instanceID) {
+        const Entry& e = entries[index & (VERTEX_CACHE_SIZE - 1)];
+        if (e.epoch == epoch && e.index == index && e.instance == instanceID) {
+            stats.hits++;
+            return &e.vertex;
+        }
+        stats.misses++;
+        return nullptr;
+    }
+
+    // 返回重新标记后的槽位，调用者负责写入着色结果
+    inline VOut& insert(uint32_t index, int instanceID) {
+        Entry& e = entries[index & (VERTEX_CACHE_SIZE - 1)];
+        e.epoch = epoch;
+        e.index = index;
+        e.instance = instanceID;
+        return e.vertex;
+    }
+
+    // 同一批次内重复引用的顶点 (已在批内复用，等价于一次命中)
+    void recordHit() { stats.hits++; }
+
+    const VertexCacheStats& getStats() const { return stats; }
+    void resetStats() { stats = VertexCacheStats(); }
+
+private:
+    struct Entry {
+        uint32_t epoch = 0; // 0 永远无效
+        uint32_t index = 0;
+        int instance = 0;
+        VOut vertex;
+    };
+
+    Entry entries[VERTEX_CACHE_SIZE];
+    uint32_t epoch = 1;
+    VertexCacheStats stats;
+};
+
+}
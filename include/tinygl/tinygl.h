@@ -10,11 +10,18 @@
 #include <string>
 #include <memory>
 #include <type_traits>
+#include <array>
+#include <utility>
 
 #include "core/gl_defs.h"
 #include "core/gl_texture.h"
 #include "core/gl_buffer.h"
+#include "core/gl_framebuffer.h"
 #include "core/gl_shader.h"
+#include "core/vertex_cache.h"
+#include "core/blend.h"
+#include "core/tiler.h"
+#include "core/job_system.h"
 
 #include "base/tmath.h"
 #include "base/math_simd.h"
@@ -35,6 +42,27 @@ struct Viewport {
     GLsizei w, h;
 };
 
+// Shader 是否提供批量顶点着色入口 vertexBatch (见 VertexBatchContext)
+template <typename ShaderT>
+inline constexpr bool kHasVertexBatch = requires(ShaderT& s, const Vec4Packet* a, VertexBatchContext& c) { s.vertexBatch(a, c); };
+
+// 三角形裁剪的 Outcode 位 (bit 0~5 与 clipAgainstPlane 的 planeID 一一对应)
+enum ClipOutcode : uint32_t {
+    CLIP_LEFT      = 1u << 0,
+    CLIP_RIGHT     = 1u << 1,
+    CLIP_BOTTOM    = 1u << 2,
+    CLIP_TOP       = 1u << 3,
+    CLIP_NEAR      = 1u << 4,
+    CLIP_FAR       = 1u << 5,
+    CLIP_GB_LEFT   = 1u << 6,
+    CLIP_GB_RIGHT  = 1u << 7,
+    CLIP_GB_BOTTOM = 1u << 8,
+    CLIP_GB_TOP    = 1u << 9,
+
+    CLIP_FRUSTUM_MASK = 0x3Fu,
+    CLIP_GUARD_MASK   = 0x3C0u
+};
+
 class TINYGL_API SoftRenderContext {
 public:
     struct ScissorBox {
@@ -67,6 +95,7 @@ public:
         GLenum frontFace = GL_CCW;
         GLboolean depthMask = GL_TRUE;
         GLenum depthFunc = GL_LESS;
+        GLboolean colorMask[4] = {GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE}; // R, G, B, A
 
         GLenum stencilFunc = GL_ALWAYS;
         GLint stencilRef = 0;
@@ -77,6 +106,15 @@ public:
         GLenum stencilPassDepthPass = GL_KEEP;
         GLint clearStencil = 0;
         float clearDepth = 1.0f;
+
+        float pointSize = 1.0f;         // glPointSize
+        bool programPointSize = false;  // GL_PROGRAM_POINT_SIZE：使用 Vertex Shader 输出的 gl_PointSize
+
+        // glColorMask 对应的颜色缓冲像素位掩码 (AABBGGRR)
+        uint32_t colorWriteMask() const {
+            return (colorMask[0] ? 0xFFu << ColorUtils::SHIFT_R : 0u) | (colorMask[1] ? 0xFFu << ColorUtils::SHIFT_G : 0u) |
+                   (colorMask[2] ? 0xFFu << ColorUtils::SHIFT_B : 0u) | (colorMask[3] ? 0xFFu << ColorUtils::SHIFT_A : 0u);
+        }
     };
 
     template <typename T>
@@ -136,6 +174,7 @@ private:
     ResourcePool<BufferObject> buffers;
     ResourcePool<VertexArrayObject> vaos;
     ResourcePool<TextureObject> textures;
+    ResourcePool<FramebufferObject> framebuffers;
 
     GLuint m_boundArrayBuffer = 0;
     GLuint m_boundVertexArray = 0;
@@ -150,14 +189,97 @@ private:
     std::vector<uint32_t> colorBuffer;
     uint32_t* m_colorBufferPtr = nullptr; // Pointer to the active color buffer (internal or external)
 
-    std::vector<float> depthBuffer;
-    std::vector<uint8_t> stencilBuffer; // 8-bit Stencil Buffer
+    // --- Tiled Framebuffer (setTiledFramebufferEnabled) ---
+    // 呈现缓冲 (colorBuffer 或 setExternalBuffer 的外部缓冲) 始终为行主序。分块布局下默认帧缓冲渲染到
+    // m_tiledColorBuffer，呈现/读回时一次性线性化到呈现缓冲；行主序时两者是同一块内存
+    uint32_t* m_presentBufferPtr = nullptr;
+    std::vector<uint32_t> m_tiledColorBuffer;
+    bool m_tiledFramebuffer = false;
+    bool m_linearizePending = false;
+
+    // 深度/模板缓冲按采样点存储：像素 pix = m_pixelLayout.index(x, y) 的第 s 个采样点位于 [pix * m_sampleCount + s]
+    // 只有 m_depthFormat 对应的数组被分配，统一经由 depthStencilView() 访问
+    GLenum m_depthFormat = GL_DEPTH_COMPONENT32F;
+    std::vector<float> depthBuffer;      // GL_DEPTH_COMPONENT32F
+    std::vector<uint32_t> depthBuffer24; // GL_DEPTH_COMPONENT24 / GL_DEPTH24_STENCIL8 (打包模板)
+    std::vector<uint16_t> depthBuffer16; // GL_DEPTH_COMPONENT16
+    // Hi-Z: 每个 RASTER_BLOCK_SIZE x RASTER_BLOCK_SIZE 块的最大深度 (保守值，>= 块内真实最大深度)
+    std::vector<float> hizBuffer;
+    int m_hizWidth = 0;
+    int m_hizHeight = 0;
+    bool m_hizEnabled = true;
+    float m_guardBand = GUARD_BAND_SCALE;
+    std::vector<uint8_t> stencilBuffer; // 8-bit Stencil Buffer (GL_DEPTH24_STENCIL8 时为空)
+
+    // --- Fast Clear ---
+    // 每个帧缓冲 Tile 的待定清除 (见 TileClearState)。m_clearPending 为假时没有任何 Tile 待清除；
+    // 它只在单线程阶段修改，并行光栅化中每个任务只 materialize 自己的 Tile
+    std::vector<TileClearState> m_clearTiles;
+    int m_clearTilesX = 0;
+    int m_clearTilesY = 0;
+    bool m_clearPending = false;
+    bool m_fastClear = true; // setFastClearEnabled
+
+    void resetClearTiles() {
+        m_clearTilesX = (fbWidth + (1 << FRAMEBUFFER_TILE_SHIFT) - 1) >> FRAMEBUFFER_TILE_SHIFT;
+        m_clearTilesY = (fbHeight + (1 << FRAMEBUFFER_TILE_SHIFT) - 1) >> FRAMEBUFFER_TILE_SHIFT;
+        m_clearTiles.assign((size_t)m_clearTilesX * m_clearTilesY, TileClearState());
+        m_clearPending = false;
+    }
+    // 执行 Tile (tx, ty) 中属于 mask 的待定清除
+    void materializeTile(int tx, int ty, uint8_t mask = 0xFF);
+    // 执行与像素闭区间 [minX, maxX] x [minY, maxY] 相交的 Tile 的全部待定清除 (首次触及)
+    inline void materializeTiles(int minX, int minY, int maxX, int maxY) {
+        for (int ty = minY >> FRAMEBUFFER_TILE_SHIFT; ty <= maxY >> FRAMEBUFFER_TILE_SHIFT; ++ty) {
+            for (int tx = minX >> FRAMEBUFFER_TILE_SHIFT; tx <= maxX >> FRAMEBUFFER_TILE_SHIFT; ++tx) {
+                if (m_clearTiles[ty * m_clearTilesX + tx].pending) materializeTile(tx, ty);
+            }
+        }
+    }
+    void materializeAllTiles();
+
+    DepthStencilView depthStencilView() {
+        DepthStencilView v;
+        v.format = m_depthFormat;
+        v.f32 = depthBuffer.data();
+        v.u32 = depthBuffer24.data();
+        v.u16 = depthBuffer16.data();
+        v.stencil = stencilBuffer.data();
+        return v;
+    }
+    // 按 m_depthFormat 分配 count 个采样点的深度/模板 (填充清除值)，释放其余格式的存储
+    void allocateDepthStencil(size_t count);
+    // 当前颜色复制到每个采样点 (默认帧缓冲的颜色与采样缓冲布局相同)
+    void fillSamplesFromColor();
+    // 分块颜色存储 <-> 行主序呈现缓冲 (toLinear 为 false 时反向)
+    void linearizeColorBuffer(bool toLinear = true);
+
+    // --- MSAA (setSampleCount) ---
+    // m_sampleCount > 1 时颜色写入多重采样缓冲 (每像素 m_sampleCount 个连续采样点，按 m_pixelLayout 寻址)，
+    // 呈现 (getColorBuffer / savePPM) 或 RHI EndPass 时 resolve 到 m_colorBufferPtr
+    int m_sampleCount = 1;
+    std::vector<uint32_t> m_sampleColorBuffer;
+    bool m_resolvePending = false;
+
+    // --- Framebuffer Objects ---
+    // 上面的 fbWidth/fbHeight、颜色指针、深度/模板/Hi-Z 与 MSAA 状态始终描述当前绘制目标，
+    // 绑定 FBO 时通过 swapSurface 与其保存的 FramebufferSurface 整体交换
+    SurfaceLayout m_colorLayout;          // 当前颜色目标的寻址方式 (默认帧缓冲为行主序或分块)
+    SurfaceLayout m_pixelLayout;          // 当前目标深度/模板/多重采样颜色的寻址方式
+    GLuint m_boundFramebuffer = 0;
+    FramebufferSurface m_defaultSurface;  // FBO 绑定期间保存默认帧缓冲的 Surface
 
     std::vector<uint32_t> m_indexCache;
     Vec4 m_clearColor = {0.0f, 0.0f, 0.0f, 1.0f}; // Default clear color is black
 
     RasterState m_state;
 
+    // --- Post-Transform Vertex Cache (仅 Indexed Draw 生效) ---
+    VertexCache m_vertexCache;
+    Vec4Packet m_batchAttribs[MAX_ATTRIBS]; // 批量顶点着色的 SoA 属性暂存
+    bool m_vertexCacheEnabled = true;
+    bool m_vertexCacheActive = false; // 当前 Draw Call 是否使用缓存
+
     // --- Binning / Capture Mode for TBR ---
     using TriangleReceiver = std::function<void(const VOut& v0, const VOut& v1, const VOut& v2)>;
     bool m_binningMode = false;
@@ -169,7 +291,12 @@ private:
             {GL_CULL_FACE,    "GL_CULL_FACE"},
             {GL_STENCIL_TEST, "GL_STENCIL_TEST"},
             {GL_SCISSOR_TEST, "GL_SCISSOR_TEST"},
-            {GL_BLEND,        "GL_BLEND"}
+            {GL_BLEND,        "GL_BLEND"},
+            {GL_PROGRAM_POINT_SIZE, "GL_PROGRAM_POINT_SIZE"},
+            {GL_DEPTH_COMPONENT16,  "GL_DEPTH_COMPONENT16"},
+            {GL_DEPTH_COMPONENT24,  "GL_DEPTH_COMPONENT24"},
+            {GL_DEPTH_COMPONENT32F, "GL_DEPTH_COMPONENT32F"},
+            {GL_DEPTH24_STENCIL8,   "GL_DEPTH24_STENCIL8"}
         };
 
         auto it = enumMap.find(value);
@@ -178,50 +305,6 @@ private:
         }
         return "UNKNOWN_ENUM (" + std::to_string(value) + ")";
     }
-    // Helper to calculate blending
-    inline Vec4 applyBlending(const Vec4& src, const Vec4& dst, const RasterState& state) {
-        auto getFactor = [&](GLenum factor, const Vec4& s, const Vec4& d) -> Vec4 {
-            switch (factor) {
-                case GL_ZERO: return Vec4(0, 0, 0, 0);
-                case GL_ONE: return Vec4(1, 1, 1, 1);
-                case GL_SRC_COLOR: return s;
-                case GL_ONE_MINUS_SRC_COLOR: return Vec4(1, 1, 1, 1) - s;
-                case GL_DST_COLOR: return d;
-                case GL_ONE_MINUS_DST_COLOR: return Vec4(1, 1, 1, 1) - d;
-                case GL_SRC_ALPHA: return Vec4(s.w, s.w, s.w, s.w);
-                case GL_ONE_MINUS_SRC_ALPHA: return Vec4(1 - s.w, 1 - s.w, 1 - s.w, 1 - s.w);
-                case GL_DST_ALPHA: return Vec4(d.w, d.w, d.w, d.w);
-                case GL_ONE_MINUS_DST_ALPHA: return Vec4(1 - d.w, 1 - d.w, 1 - d.w, 1 - d.w);
-                case GL_SRC_ALPHA_SATURATE: {
-                    float f = std::min(s.w, 1.0f - d.w);
-                    return Vec4(f, f, f, 1.0f);
-                }
-                // CONSTANT_COLOR and others could be added if needed
-                default: return Vec4(1, 1, 1, 1);
-            }
-        };
-
-        Vec4 srcFactorRGB = getFactor(state.blend.srcRGB, src, dst);
-        Vec4 dstFactorRGB = getFactor(state.blend.dstRGB, src, dst);
-        Vec4 srcFactorA = getFactor(state.blend.srcAlpha, src, dst);
-        Vec4 dstFactorA = getFactor(state.blend.dstAlpha, src, dst);
-
-        auto combine = [](const Vec4& s, const Vec4& sf, const Vec4& d, const Vec4& df, GLenum op) -> Vec4 {
-            switch (op) {
-                case GL_FUNC_ADD: return s * sf + d * df;
-                case GL_FUNC_SUBTRACT: return s * sf - d * df;
-                case GL_FUNC_REVERSE_SUBTRACT: return d * df - s * sf;
-                case GL_MIN: return Vec4(std::min(s.x, d.x), std::min(s.y, d.y), std::min(s.z, d.z), std::min(s.w, d.w));
-                case GL_MAX: return Vec4(std::max(s.x, d.x), std::max(s.y, d.y), std::max(s.z, d.z), std::max(s.w, d.w));
-                default: return s * sf + d * df;
-            }
-        };
-
-        Vec4 resRGB = combine(src, srcFactorRGB, dst, dstFactorRGB, state.blend.equationRGB);
-        Vec4 resA = combine(src, srcFactorA, dst, dstFactorA, state.blend.equationAlpha);
-
-        return Vec4(resRGB.x, resRGB.y, resRGB.z, resA.w);
-    }
 
     // Stencil Op Helper
     inline void applyStencilOp(GLenum op, uint8_t& val, const RasterState& state) {
@@ -263,8 +346,8 @@ private:
     // DOES NOT update stencil buffer (that depends on depth result).
     inline bool checkStencil(int x, int y, const RasterState& state) {
         if (!state.stencilTest) return true;
-        int idx = y * fbWidth + x;
-        return checkStencil(stencilBuffer[idx], state);
+        size_t idx = m_pixelLayout.index(x, y) * m_sampleCount; // 第 0 个采样点
+        return checkStencil(depthStencilView().loadStencil(idx), state);
     }
 
     inline bool testDepth(float z, float currentDepth, const RasterState& state) {
@@ -306,6 +389,129 @@ private:
         }
         return pass;
     }
+
+    // --- 线/点的逐片元操作 (不做多重采样：片元覆盖像素内的全部采样点) ---
+    // 逐 Draw 状态：裁剪矩形、颜色掩码与定点混合模式在 prepareDraw 中解析一次，片元循环不再重复读取 RasterState
+    struct FragmentSetup {
+        int minX = 0, minY = 0, maxX = 0, maxY = 0; // Viewport ∩ Scissor，max 不包含
+        uint32_t colorWriteMask = 0;
+        FixedBlendMode fixedBlend = FIXED_BLEND_NONE;
+        bool depthTest = false;
+        bool programPointSize = false;
+        float pointSize = 1.0f; // 已钳制到 [1, MAX_POINT_SIZE]
+    };
+
+    void updateFragmentSetup() {
+        FragmentSetup& f = m_fragmentSetup;
+        f.minX = std::max(0, m_state.viewport.x);
+        f.maxX = std::min((int)fbWidth, m_state.viewport.x + m_state.viewport.w);
+        f.minY = std::max(0, m_state.viewport.y);
+        f.maxY = std::min((int)fbHeight, m_state.viewport.y + m_state.viewport.h);
+        if (m_state.scissorTest) {
+            f.minX = std::max(f.minX, m_state.scissor.x);
+            f.maxX = std::min(f.maxX, m_state.scissor.x + m_state.scissor.w);
+            f.minY = std::max(f.minY, m_state.scissor.y);
+            f.maxY = std::min(f.maxY, m_state.scissor.y + m_state.scissor.h);
+        }
+        f.colorWriteMask = m_state.colorWriteMask();
+        f.fixedBlend = fixedBlendMode(m_state);
+        f.depthTest = m_state.depthTest;
+        f.programPointSize = m_state.programPointSize;
+        f.pointSize = std::clamp(m_state.pointSize, 1.0f, MAX_POINT_SIZE);
+    }
+
+    // Early-Z：任一采样点通过即执行 Fragment Shader (zq 为按深度格式量化后的深度)
+    inline bool testDepthAnySample(const DepthStencilView& ds, size_t pix, float zq, const RasterState& state) {
+        for (int s = 0; s < m_sampleCount; ++s) {
+            if (testDepth(zq, ds.load(pix * m_sampleCount + s), state)) return true;
+        }
+        return false;
+    }
+
+    // 输出合并：Stencil -> Depth -> 深度写入 -> Blend -> 颜色写入 (逐采样点)
+    // pix 为 m_pixelLayout.index(x, y)；earlyZPassed: 深度已由 Early-Z 判定通过 (未写 gl_FragDepth)，单采样时无需重测
+    inline void mergeFragment(const DepthStencilView& ds, int x, int y, size_t pix, float finalZ, bool earlyZPassed,
+                              const Vec4& fColor, const RasterState& state, const FragmentSetup& setup) {
+        const int samples = m_sampleCount;
+        const size_t base = pix * samples;
+        uint32_t* pColor = samples > 1 ? m_sampleColorBuffer.data() + base : m_colorBufferPtr + m_colorLayout.index(x, y);
+        bool needDepthTest = setup.depthTest && !(earlyZPassed && samples == 1);
+        const uint32_t colorWriteMask = setup.colorWriteMask;
+        const FixedBlendMode fixedBlend = setup.fixedBlend;
+        const float zq = ds.quantize(finalZ);
+
+        for (int s = 0; s < samples; ++s) {
+            size_t idx = base + s;
+            bool stencilPass = true;
+            bool depthPass = true;
+
+            if (state.stencilTest) {
+                uint8_t sv = ds.loadStencil(idx);
+                if (!checkStencil(sv, state)) {
+                    applyStencilOp(state.stencilFail, sv, state);
+                    stencilPass = false;
+                } else {
+                    if (needDepthTest && !testDepth(zq, ds.load(idx), state)) {
+                        applyStencilOp(state.stencilPassDepthFail, sv, state);
+                        depthPass = false;
+                    } else {
+                        applyStencilOp(state.stencilPassDepthPass, sv, state);
+                        depthPass = true;
+                    }
+                }
+                ds.storeStencil(idx, sv);
+            } else {
+                if (needDepthTest && !testDepth(zq, ds.load(idx), state)) {
+                    depthPass = false;
+                }
+            }
+
+            if (stencilPass && depthPass) {
+                if (state.depthMask) {
+                    ds.store(idx, finalZ);
+                    expandHiZ(x, y, zq);
+                }
+                if (colorWriteMask) {
+                    uint32_t outColor;
+                    if (fixedBlend != FIXED_BLEND_NONE) {
+                        outColor = blendFixed(fixedBlend, ColorUtils::FloatToUint32(fColor), pColor[s]);
+                    } else if (state.blendEnabled) {
+                        Vec4 dstColor = ColorUtils::Uint32ToFloat(pColor[s]);
+                        outColor = ColorUtils::FloatToUint32(applyBlending(fColor, dstColor, state));
+                    } else {
+                        outColor = ColorUtils::FloatToUint32(fColor);
+                    }
+                    pColor[s] = maskedColor(outColor, pColor[s], colorWriteMask);
+                }
+            }
+        }
+    }
+
+    // --- Hi-Z Helpers ---
+    // 按 depthBuffer 精确重算一个 Hi-Z 块的最大深度 (bx, by 为块坐标)
+    void updateHiZBlock(int bx, int by);
+    // 重算与像素矩形 [minX, maxX) x [minY, maxY) 相交的所有 Hi-Z 块
+    void rebuildHiZ(int minX, int minY, int maxX, int maxY);
+
+    // 单个像素写入深度后保守地扩大所在块的最大深度 (线/点光栅化使用)
+    inline void expandHiZ(int x, int y, float z) {
+        float& blockMax = hizBuffer[(y / RASTER_BLOCK_SIZE) * m_hizWidth + x / RASTER_BLOCK_SIZE];
+        if (z > blockMax) blockMax = z;
+    }
+
+    // 块内片元的最小深度为 minZ 时，是否一定无法通过深度测试
+    inline bool hizOccluded(float minZ, float blockMax, GLenum depthFunc) {
+        return depthFunc == GL_LESS ? minZ >= blockMax : minZ > blockMax;
+    }
+
+    // 提前深度剔除 (Hi-Z / Early-Z) 只在结果不变时启用：
+    // Shader 声明写 gl_FragDepth 时插值深度不是最终深度；
+    // 模板失败或深度失败会修改模板值时 (如 z-fail 阴影体)，被遮挡的片元仍需执行对应的模板操作
+    template <typename ShaderT>
+    static bool earlyDepthRejectEnabled(const RasterState& state) {
+        return state.depthTest && !shaderWritesFragDepth<ShaderT>() &&
+               !(state.stencilTest && (state.stencilFail != GL_KEEP || state.stencilPassDepthFail != GL_KEEP));
+    }
 public:
     SoftRenderContext(GLsizei width, GLsizei height) {
         fbWidth = width;
@@ -317,8 +523,15 @@ public:
         vaos.forceAllocate(0); 
         colorBuffer.resize(fbWidth * fbHeight, COLOR_BLACK); // 黑色背景
         m_colorBufferPtr = colorBuffer.data();               // Default to internal buffer
+        m_presentBufferPtr = m_colorBufferPtr;
+        m_colorLayout = SurfaceLayout::Linear(fbWidth);
+        m_pixelLayout = m_colorLayout;
+        resetClearTiles();
 
         depthBuffer.resize(fbWidth * fbHeight, m_state.clearDepth); 
+        m_hizWidth = (fbWidth + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+        m_hizHeight = (fbHeight + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+        hizBuffer.resize(m_hizWidth * m_hizHeight, m_state.clearDepth);
         // Stencil Init
         stencilBuffer.resize(fbWidth * fbHeight, 0);
 
@@ -328,10 +541,21 @@ public:
     // Set an external buffer for rendering (e.g., SDL texture memory)
     // Pass nullptr to revert to the internal buffer.
     void setExternalBuffer(uint32_t* ptr) {
-        if (ptr) {
-            m_colorBufferPtr = ptr;
-        } else {
-            m_colorBufferPtr = colorBuffer.data();
+        flushDeferredDraws();
+        m_presentBufferPtr = ptr ? ptr : colorBuffer.data();
+        if (m_tiledFramebuffer) {
+            // 分块布局：继续渲染到内部分块存储，下次呈现时线性化到新的呈现缓冲
+            m_linearizePending = true;
+            return;
+        }
+        // 总是作用于默认帧缓冲 (FBO 绑定期间它保存在 m_defaultSurface 中)
+        bool fboBound = m_boundFramebuffer != 0;
+        uint32_t*& target = fboBound ? m_defaultSurface.color : m_colorBufferPtr;
+        target = m_presentBufferPtr;
+        if (fboBound) {
+            if (m_defaultSurface.sampleCount > 1) m_defaultSurface.resolvePending = true;
+        } else if (m_sampleCount > 1) {
+            m_resolvePending = true; // 新目标需要重新 resolve
         }
     }
 
@@ -376,6 +600,13 @@ public:
         m_state.depthMask = flag;
     }
 
+    void glColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a){
+        m_state.colorMask[0] = r;
+        m_state.colorMask[1] = g;
+        m_state.colorMask[2] = b;
+        m_state.colorMask[3] = a;
+    }
+
     void glStencilFunc(GLenum func, GLint ref, GLuint mask){
         m_state.stencilFunc = func;
         m_state.stencilRef = ref;
@@ -404,6 +635,7 @@ public:
             case GL_SCISSOR_TEST: m_state.scissorTest = true; break;
             case GL_BLEND: m_state.blendEnabled = true; break;
             case GL_CULL_FACE: m_state.cullFace = true; break;
+            case GL_PROGRAM_POINT_SIZE: m_state.programPointSize = true; break;
         }
     }
 
@@ -414,6 +646,7 @@ public:
             case GL_SCISSOR_TEST: m_state.scissorTest = false; break;
             case GL_BLEND: m_state.blendEnabled = false; break;
             case GL_CULL_FACE: m_state.cullFace = false; break;
+            case GL_PROGRAM_POINT_SIZE: m_state.programPointSize = false; break;
         }
     }
 
@@ -424,6 +657,7 @@ public:
             case GL_SCISSOR_TEST: return m_state.scissorTest;
             case GL_BLEND: return m_state.blendEnabled;
             case GL_CULL_FACE: return m_state.cullFace;
+            case GL_PROGRAM_POINT_SIZE: return m_state.programPointSize;
             default: return GL_FALSE;
         }
     }
@@ -432,22 +666,107 @@ public:
         m_state.depthFunc = func;
     }
 
+    void glPointSize(float size) {
+        if (!(size > 0.0f)) {
+            LOG_ERROR("glPointSize: size must be greater than 0.");
+            return;
+        }
+        m_state.pointSize = size;
+    }
+
     // --- State Management ---
     void glClearColor(float r, float g, float b, float a);
     // Clear buffer function
     void glClear(uint32_t buffersToClear);
-    // Get color buffer for external display
-    uint32_t* getColorBuffer() { return m_colorBufferPtr; }
+    // Get color buffer for external display (并行模式下会先完成所有延迟的 Draw，MSAA 下会先 resolve)
+    // 始终返回默认帧缓冲的呈现缓冲 (行主序，分块布局下先线性化)；绑定 FBO 时默认帧缓冲已在绑定前 resolve
+    uint32_t* getColorBuffer() {
+        flushDeferredDraws();
+        storeColorBuffer();
+        return m_presentBufferPtr;
+    }
+
+    // 默认帧缓冲的 Store 阶段：按需 MSAA resolve，分块布局下再线性化到呈现缓冲。
+    // glDraw*/glClear 会标记待处理，getColorBuffer/savePPM 自动调用；force 用于绕过 glDraw* 直接光栅化的 RHI 后端
+    void storeColorBuffer(bool force = false);
+
+    // --- Tiled Framebuffer ---
+    // 开启后默认帧缓冲的颜色、深度/模板与多重采样缓冲按 (1 << FRAMEBUFFER_TILE_SHIFT) 像素见方的 Tile 连续存放，
+    // 与 PARALLEL_TILE_SIZE / RHI 的分箱 Tile 对齐：一个 Tile 的光栅化只访问一段连续内存，相邻 Tile 不共享缓存行。
+    // 呈现 (getColorBuffer / savePPM / RHI Submit) 时一次 SIMD 拷贝线性化到呈现缓冲，setExternalBuffer 照常可用。
+    // 之后分配的 FBO 深度/模板也使用分块布局 (颜色附件始终为纹理的 4x4 分块)。
+    // 只能在默认帧缓冲绑定时切换；颜色保留，深度/模板以清除值重置
+    void setTiledFramebufferEnabled(bool enabled);
+    bool isTiledFramebufferEnabled() const { return m_tiledFramebuffer; }
+
+    // --- Fast Clear ---
+    // 开启 (默认) 时 glClear 对完整覆盖的 Tile 只记录清除值，首次光栅化或呈现时再写入；
+    // 关闭后每次 glClear 立即写满缓冲 (用于对比与调试，结果与开启时一致)
+    void setFastClearEnabled(bool enabled) { m_fastClear = enabled; }
+    bool isFastClearEnabled() const { return m_fastClear; }
+
+    // --- MSAA ---
+    // samples 为 1 (关闭) 或 MSAA_SAMPLES。三角形逐采样点计算覆盖与深度/模板测试，Fragment Shader 每像素只执行一次；
+    // 线/点不做多重采样，覆盖像素内全部采样点。切换采样数会重置深度/模板缓冲，颜色保留。
+    void setSampleCount(int samples);
+    int getSampleCount() const { return m_sampleCount; }
+    // 把多重采样颜色平均写入当前颜色缓冲 (SIMD)，单采样时为空操作
+    void resolveMultisample();
+
+    // --- Depth / Stencil Format ---
+    // 当前绘制目标 (默认帧缓冲或绑定的 FBO) 的深度/模板存储格式：GL_DEPTH_COMPONENT32F (默认)、
+    // GL_DEPTH_COMPONENT24、GL_DEPTH24_STENCIL8 (深度与模板打包在一个 32-bit 字) 或 GL_DEPTH_COMPONENT16。
+    // 定点格式下深度测试在存储精度上进行。切换格式会以清除值重置深度/模板
+    void setDepthFormat(GLenum format);
+    GLenum getDepthFormat() const { return m_depthFormat; }
+
+    // --- Framebuffer Objects (Render-to-Texture) ---
+    // 颜色附件为纹理的某一 Mip 层 (GL_COLOR_ATTACHMENT0)，绘制直接写入纹理的 4x4 分块存储，
+    // 之后可立即作为纹理采样，无需拷贝和 glTexImage2D 重排。深度/模板由 FBO 内部按附件尺寸分配。
+    // FBO 始终单采样；绑定期间 getColorBuffer/savePPM 仍然访问默认帧缓冲。
+    void glGenFramebuffers(GLsizei n, GLuint* ids);
+    void glDeleteFramebuffers(GLsizei n, const GLuint* ids);
+    void glBindFramebuffer(GLenum target, GLuint framebuffer);
+    void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+    GLenum glCheckFramebufferStatus(GLenum target);
+    // 开启后，FBO 被解绑 (切换绘制目标) 时若颜色附件被写入过，则重建其 Mipmap 链 (仅 Level 0 附件)
+    void setFramebufferAutoMipmap(GLuint framebuffer, bool enabled);
+    GLuint getBoundFramebuffer() const { return m_boundFramebuffer; }
     
     GLsizei getWidth() const { return fbWidth; }
     GLsizei getHeight() const { return fbHeight; }
     const Viewport& glGetViewport() const { return m_state.viewport; }
 
+    // Hi-Z 粗粒度遮挡剔除 (仅 GL_LESS / GL_LEQUAL 时生效)
+    void setHiZEnabled(bool enabled) { m_hizEnabled = enabled; }
+
+    // Guard Band 大小 (NDC 倍数)：只越过 X/Y 平面且仍在 Guard Band 内的三角形不做裁剪，
+    // 直接交给光栅化器 (由视口/Scissor 限制包围盒)。1.0 等价于关闭 Guard Band。
+    void setGuardBand(float scale) { m_guardBand = std::clamp(scale, 1.0f, GUARD_BAND_SCALE_MAX); }
+    float getGuardBand() const { return m_guardBand; }
+
     void setBinningMode(bool enabled, TriangleReceiver receiver = nullptr) {
         m_binningMode = enabled;
         m_triangleReceiver = receiver;
     }
 
+    // --- Parallel Immediate Mode ---
+    // 开启后 glDraw* 只在调用线程完成顶点处理、裁剪与分箱 (PARALLEL_TILE_SIZE 的屏幕 Tile)，
+    // 三角形光栅化延迟到 glFinish() 由 JobSystem 按 Tile 并行执行；每个 Tile 内按提交顺序处理，逐像素结果与串行一致。
+    // 每个 Draw 按值拷贝 Shader 并快照 RasterState，Shader 通过指针引用的数据在 glFinish 之前必须保持有效且不变。
+    // glClear、getColorBuffer、setExternalBuffer、纹理修改以及线/点图元会先隐式 glFinish。
+    void setParallelRasterEnabled(bool enabled);
+    bool isParallelRasterEnabled() const { return m_parallelRaster; }
+    // 完成所有延迟的 Draw (非并行模式下为空操作)
+    void glFinish();
+    void glFlush() { glFinish(); }
+
+    // --- Vertex Cache ---
+    void setVertexCacheEnabled(bool enabled) { m_vertexCacheEnabled = enabled; }
+    bool isVertexCacheEnabled() const { return m_vertexCacheEnabled; }
+    const VertexCacheStats& getVertexCacheStats() const { return m_vertexCache.getStats(); }
+    void resetVertexCacheStats() { m_vertexCache.resetStats(); }
+
     // --- Buffers ---
     void glGenBuffers(GLsizei n, GLuint* res);
     void glDeleteBuffers(GLsizei n, const GLuint* buffers);
@@ -483,6 +802,8 @@ public:
     void glEnableVertexArrayAttrib(GLuint vaobj, GLuint index);
     void glVertexAttribDivisor(GLuint index, GLuint divisor);
     Vec4 fetchAttribute(const ResolvedAttribute& attr, int vertexIdx, int instanceIdx);
+    // SoA 批量读取：indices[0..count) 个顶点的同一属性打包到 out (count <= VERTEX_BATCH_SIZE)
+    void fetchAttributePacket(const ResolvedAttribute& attr, const uint32_t* indices, int count, int instanceIdx, Vec4Packet& out);
 
     // --- Textures ---
     void glGenTextures(GLsizei n, GLuint* res);
@@ -491,25 +812,49 @@ public:
     void glBindTexture(GLenum target, GLuint texture);
     TextureObject* getTexture(GLuint unit);
     TextureObject* getTextureObject(GLuint id);
+    // 按 internalformat 存储：GL_R8 / GL_RG8 / GL_RGB565 / GL_RGBA4 / GL_R16F / GL_R32F 每 texel 1~4 字节，
+    // 非尺寸化的 GL_RED / GL_RG 取 8-bit 版本，GL_RGB / GL_RGBA 存为 RGBA8
     void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei w, GLsizei h, GLint border, GLenum format, GLenum type, const void* p);
+    // 原地改写已定义层级的子区域：只转换并重排覆盖到的 4x4 块，保留其余层级 (glGenerateMipmap 随后只重建改写区域的足迹)
+    // 压缩格式要求子区域按 4x4 块对齐 (到达层级边缘的块除外)
+    void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei w, GLsizei h, GLenum format, GLenum type, const void* p);
+    // BC1 / BC3 / ETC2 块数据直接作为存储，采样时解码 (glTexImage2D 传入压缩 internalformat 时在上传时编码)
+    void glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei w, GLsizei h, GLint border, GLsizei imageSize, const void* data);
     void glTexParameteri(GLenum target, GLenum pname, GLint param); // 设置纹理参数
     void glTexParameterf(GLenum target, GLenum pname, GLfloat param); // Float Scalar 版本
     void glTexParameteriv(GLenum target, GLenum pname, const GLint* params); // nt Vector 版本
     void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params); // Float Vector 版本 (关键：Border Color)
     void glGenerateMipmap(GLenum target); // 生成 Mipmap
+    // 开启后该纹理的 Mipmap 按 sRGB 编码处理：RGB 解码到线性空间平均后再编码 (Alpha 仍线性平均)，下次 glGenerateMipmap 整链重建
+    void setTextureSRGBMipmap(GLuint texture, bool enabled);
 
     // --- Draw Execution Helpers ---
-    void prepareDraw();
+    // 返回 false 时当前绘制目标不完整 (FBO 缺少有效的颜色附件)，Draw 被丢弃
+    bool prepareDraw();
+    // FBO 绑定时重新解析颜色附件指针 (纹理存储可能被重新分配)，返回绘制目标是否完整
+    bool refreshFramebufferAttachment();
+    // 与上下文当前的绘制目标 Surface 整体交换
+    void swapSurface(FramebufferSurface& surface);
+    // 为当前绘制目标按 w x h 分配深度/模板/Hi-Z (单采样)
+    void allocateSurface(GLsizei w, GLsizei h);
 
     // --- util ---
     // 线性插值辅助函数 (Linear Interpolation)
     // 用于在被裁剪的边上生成新的顶点
     // t: [0, 1] 插值系数
-    VOut lerpVertex(const VOut& a, const VOut& b, float t);
+    // varyingCount: 需要插值的 Varying 个数 (见 shaderVaryingCount)
+    VOut lerpVertex(const VOut& a, const VOut& b, float t, int varyingCount = MAX_VARYINGS);
     const std::vector<uint32_t>& readIndicesAsInts(GLsizei count, GLenum type, const void* indices_ptr);
     // Converts source pixel data to internal RGBA8888 format
     bool convertToInternalFormat(const void* src_data, GLsizei src_width, GLsizei src_height,
                                  GLenum src_format, GLenum src_type, std::vector<uint32_t>& dst_pixels);
+    // 客户端像素转换为行优先的 storage 格式 texel (压缩格式为待编码的 RGBA8)，可直接使用时返回 src_data，失败返回 nullptr
+    const uint8_t* packPixels(GLenum storage, GLsizei w, GLsizei h, GLenum src_format, GLenum src_type,
+                              const void* src_data, std::vector<uint32_t>& scratch);
+    // 按需创建 JobSystem (并行光栅化与 Mipmap 生成共用)
+    JobSystem* acquireJobSystem();
+    // 生成纹理的 Mipmap 链，Level 0 足够大时交给 JobSystem 并行
+    void generateTextureMipmaps(TextureObject* tex);
     // 辅助：计算属性 f 在屏幕空间的偏导数
     Gradients calcGradients(const VOut& v0, const VOut& v1, const VOut& v2, float invArea, float f0, float f1, float f2);
     // 执行透视除法与视口变换 (Perspective Division & Viewport)
@@ -520,17 +865,46 @@ public:
     // Sutherland-Hodgman 裁剪算法的核心：针对单个平面进行裁剪
     // inputVerts: 输入的顶点列表
     // planeID: 0=Left, 1=Right, 2=Bottom, 3=Top, 4=Near, 5=Far
-    StaticVector<VOut, 16> clipAgainstPlane(const StaticVector<VOut, 16>& inputVerts, int planeID);
+    // outputVerts: 输出缓冲 (调用者提供，两个缓冲交替使用以避免每个平面拷贝整个多边形)
+    void clipAgainstPlane(const StaticVector<VOut, 16>& inputVerts, int planeID, StaticVector<VOut, 16>& outputVerts,
+                          int varyingCount = MAX_VARYINGS);
+    // 计算 Clip Space 顶点的 Outcode (ClipOutcode 位掩码)，包含视锥体 6 平面与 Guard Band 4 平面
+    static inline uint32_t computeOutcode(const Vec4& p, float guardBand) {
+        uint32_t code = 0;
+        // 与 clipAgainstPlane 的 isInside 判定保持一致，bit i 对应 planeID i
+        if (p.w + p.x < 0) code |= CLIP_LEFT;
+        if (p.w - p.x < 0) code |= CLIP_RIGHT;
+        if (p.w + p.y < 0) code |= CLIP_BOTTOM;
+        if (p.w - p.y < 0) code |= CLIP_TOP;
+        if (p.w + p.z < EPSILON) code |= CLIP_NEAR;
+        if (p.w - p.z < 0) code |= CLIP_FAR;
+
+        // Guard Band: 放大后的 X/Y 平面
+        float gw = p.w * guardBand;
+        if (gw + p.x < 0) code |= CLIP_GB_LEFT;
+        if (gw - p.x < 0) code |= CLIP_GB_RIGHT;
+        if (gw + p.y < 0) code |= CLIP_GB_BOTTOM;
+        if (gw - p.y < 0) code |= CLIP_GB_TOP;
+        return code;
+    }
     // Liang-Barsky Line Clipping against a single axis-aligned boundary
     // Returns false if the line is completely outside.
     // Modifies t0 and t1 to the new intersection points.
     bool clipLineAxis(float p, float q, float& t0, float& t1);
     // Clips a line against the canonical view volume. Returns the clipped vertices.
-    StaticVector<VOut, 16> clipLine(const VOut& v0, const VOut& v1);
+    StaticVector<VOut, 16> clipLine(const VOut& v0, const VOut& v1, int varyingCount = MAX_VARYINGS);
 
     // --- rasterize ---
     template <typename ShaderT>
     void rasterizeTriangleTemplate(ShaderT& shader, const VOut& v0, const VOut& v1, const VOut& v2) {
+        if (m_parallelRaster && !m_binningMode) {
+            if constexpr (std::is_copy_constructible_v<ShaderT>) {
+                deferTriangle(shader, v0, v1, v2);
+                return;
+            } else {
+                flushDeferredDraws(); // 无法拷贝的 Shader 退回串行光栅化
+            }
+        }
         rasterizeTriangleTemplate(shader, v0, v1, v2, m_state);
     }
 
@@ -540,8 +914,261 @@ public:
             m_triangleReceiver(v0, v1, v2);
             return;
         }
-        
-        // LOG_INFO("rasterizeTriangleTemplate: " + std::to_string((int)v0.scn.x) + "," + std::to_string((int)v0.scn.y));
+
+        (this->*selectTriangleKernel<ShaderT>(state))(shader, v0, v1, v2, state);
+    }
+
+    // --- Raster Kernel Specialization ---
+    // 与 TextureObject::updateSampler 相同的思路：把逐像素的 switch (深度函数、深度写入、混合) 提升为模板参数，
+    // 每个三角形开始时按 RasterState 查表选出对应的实例。Stencil 与不常见的深度函数/混合模式走通用内核。
+    // 剔除 (Cull) 是逐三角形判断一次，不参与特化。
+    // RASTER_BLEND_DEPTH_ONLY：颜色被 glColorMask 全部屏蔽且 Shader 不写 gl_FragDepth、不 discard (shaderWritesFragDepth / shaderUsesDiscard) 时，
+    // 只做深度测试/写入，跳过 Varying 插值、Fragment Shader 与颜色写入 (Z-Prepass / Shadow Map)
+    // RASTER_BLEND_FIXED：定点混合单元支持的模式 (classifyFixedBlend)，每个 Quad 的 4 个像素一次 SIMD 混合
+    enum RasterBlendMode { RASTER_BLEND_NONE = 0, RASTER_BLEND_FIXED = 1, RASTER_BLEND_DEPTH_ONLY = 2, RASTER_BLEND_GENERIC = 3 };
+
+    // 特化内核覆盖的深度函数，GL_ALWAYS 同时代表关闭深度测试 (两者行为一致)
+    static constexpr GLenum kKernelDepthFuncs[3] = {GL_LESS, GL_LEQUAL, GL_ALWAYS};
+    static constexpr int KERNEL_TABLE_SIZE = 3 * 2 * 3; // DepthFunc x DepthWrite x (None / Fixed Blend / Depth Only)
+
+    template <typename ShaderT>
+    using TriangleKernel = void (SoftRenderContext::*)(ShaderT&, const VOut&, const VOut&, const VOut&, const RasterState&);
+
+    // RasterState -> 内核表索引，-1 表示使用通用内核
+    // allowDepthOnly: Shader 不写 gl_FragDepth 且不 discard，颜色全屏蔽时可以不执行 Fragment Shader
+    static int rasterKernelKey(const RasterState& s, bool allowDepthOnly) {
+        if (s.stencilTest) return -1;
+
+        int depth;
+        if (!s.depthTest || s.depthFunc == GL_ALWAYS) depth = 2;
+        else if (s.depthFunc == GL_LESS) depth = 0;
+        else if (s.depthFunc == GL_LEQUAL) depth = 1;
+        else return -1;
+
+        uint32_t colorMask = s.colorWriteMask();
+        int blend;
+        if (colorMask == 0 && allowDepthOnly) {
+            blend = RASTER_BLEND_DEPTH_ONLY; // 不写颜色，混合状态无关
+        } else if (colorMask != 0xFFFFFFFFu) {
+            return -1; // 部分通道屏蔽由通用内核处理
+        } else if (!s.blendEnabled) {
+            blend = RASTER_BLEND_NONE;
+        } else if (fixedBlendMode(s) != FIXED_BLEND_NONE) {
+            blend = RASTER_BLEND_FIXED;
+        } else {
+            return -1;
+        }
+
+        return (depth * 2 + (s.depthMask ? 1 : 0)) * 3 + blend;
+    }
+
+    template <typename ShaderT, size_t... I>
+    static constexpr std::array<TriangleKernel<ShaderT>, sizeof...(I)> makeTriangleKernelTable(std::index_sequence<I...>) {
+        return {{ &SoftRenderContext::rasterizeTriangleKernel<ShaderT, kKernelDepthFuncs[I / 6], ((I / 3) % 2) == 1, (int)(I % 3)>... }};
+    }
+
+    template <typename ShaderT>
+    TriangleKernel<ShaderT> selectTriangleKernel(const RasterState& state) {
+        static constexpr auto table = makeTriangleKernelTable<ShaderT>(std::make_index_sequence<KERNEL_TABLE_SIZE>{});
+        // MSAA 使用逐采样点的通用内核
+        if (m_sampleCount > 1) return &SoftRenderContext::rasterizeTriangleKernel<ShaderT, 0, true, RASTER_BLEND_GENERIC, MSAA_SAMPLES>;
+        int key = rasterKernelKey(state, !shaderWritesFragDepth<ShaderT>() && !shaderUsesDiscard<ShaderT>());
+        if (key < 0) return &SoftRenderContext::rasterizeTriangleKernel<ShaderT, 0, true, RASTER_BLEND_GENERIC>;
+        return table[key];
+    }
+
+    // --- Parallel Immediate Mode: 延迟绘制记录 ---
+    // 一个 Draw Call 的 Shader 拷贝、RasterState 快照与屏幕空间三角形 (只保存 kVaryings 个 Varying)
+    struct DeferredDrawBase {
+        RasterState state;
+        const void* source = nullptr; // 录制时的 Shader 地址，用于识别同一 Draw 内的后续三角形
+        virtual ~DeferredDrawBase() = default;
+        // 在一个 Tile 内按顺序光栅化本 Draw 的一段三角形 (Worker 线程，Shader 使用线程私有拷贝)
+        virtual void rasterize(SoftRenderContext& ctx, const TileCommand* cmds, size_t count, const RasterState& tileState) = 0;
+    };
+
+    template <typename ShaderT>
+    struct DeferredDraw final : DeferredDrawBase {
+        static constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        struct Vertex {
+            Vec4 scn;
+            Vec4 varyings[kVaryings > 0 ? kVaryings : 1];
+        };
+        struct Triangle { Vertex v[3]; };
+
+        ShaderT shader;
+        TriangleKernel<ShaderT> kernel; // 录制时按 RasterState 选好的内核 (与 Scissor 无关)
+        std::vector<Triangle> triangles;
+
+        DeferredDraw(const ShaderT& s, const RasterState& st, TriangleKernel<ShaderT> k) : shader(s), kernel(k) {
+            state = st;
+        }
+
+        void rasterize(SoftRenderContext& ctx, const TileCommand* cmds, size_t count, const RasterState& tileState) override {
+            ShaderT local = shader;
+            VOut v[3];
+            for (size_t i = 0; i < count; ++i) {
+                const Triangle& tri = triangles[cmds[i].dataIndex];
+                for (int k = 0; k < 3; ++k) {
+                    v[k].scn = tri.v[k].scn;
+                    for (int j = 0; j < kVaryings; ++j) v[k].ctx.varyings[j] = tri.v[k].varyings[j];
+                }
+                (ctx.*kernel)(local, v[0], v[1], v[2], tileState);
+            }
+        }
+    };
+
+    bool m_parallelRaster = false;
+    std::unique_ptr<JobSystem> m_jobSystem;
+    TileBinningSystem m_parallelTiler;
+    std::vector<std::unique_ptr<DeferredDrawBase>> m_deferredDraws;
+    bool m_deferredDrawOpen = false; // 当前 Draw Call 是否已创建延迟记录 (prepareDraw 时复位)
+    FragmentSetup m_fragmentSetup;   // 线/点光栅化的逐 Draw 状态 (prepareDraw 时更新)
+    size_t m_deferredTriangleCount = 0;
+
+    inline void flushDeferredDraws() {
+        if (!m_deferredDraws.empty()) glFinish();
+    }
+
+    // 录制一个已完成顶点处理的三角形并按包围盒分箱
+    template <typename ShaderT>
+    void deferTriangle(ShaderT& shader, const VOut& v0, const VOut& v1, const VOut& v2) {
+        // 包围盒限制在 Viewport/Scissor 内 (外扩 1 像素，保守覆盖定点化误差)
+        int limitMinX = std::max(0, m_state.viewport.x);
+        int limitMaxX = std::min((int)fbWidth, m_state.viewport.x + m_state.viewport.w) - 1;
+        int limitMinY = std::max(0, m_state.viewport.y);
+        int limitMaxY = std::min((int)fbHeight, m_state.viewport.y + m_state.viewport.h) - 1;
+        if (m_state.scissorTest) {
+            limitMinX = std::max(limitMinX, m_state.scissor.x);
+            limitMaxX = std::min(limitMaxX, m_state.scissor.x + m_state.scissor.w - 1);
+            limitMinY = std::max(limitMinY, m_state.scissor.y);
+            limitMaxY = std::min(limitMaxY, m_state.scissor.y + m_state.scissor.h - 1);
+        }
+        int minX = std::max(limitMinX, (int)std::floor(std::min({v0.scn.x, v1.scn.x, v2.scn.x})) - 1);
+        int maxX = std::min(limitMaxX, (int)std::floor(std::max({v0.scn.x, v1.scn.x, v2.scn.x})) + 1);
+        int minY = std::max(limitMinY, (int)std::floor(std::min({v0.scn.y, v1.scn.y, v2.scn.y})) - 1);
+        int maxY = std::min(limitMaxY, (int)std::floor(std::max({v0.scn.y, v1.scn.y, v2.scn.y})) + 1);
+        if (minX > maxX || minY > maxY) return;
+
+        if (!m_deferredDrawOpen || m_deferredDraws.back()->source != &shader) {
+            if (m_deferredDraws.size() >= (size_t)PARALLEL_MAX_DEFERRED_DRAWS) glFinish();
+            m_deferredDraws.push_back(std::make_unique<DeferredDraw<ShaderT>>(shader, m_state, selectTriangleKernel<ShaderT>(m_state)));
+            m_deferredDraws.back()->source = &shader;
+            m_deferredDrawOpen = true;
+        }
+
+        auto& draw = static_cast<DeferredDraw<ShaderT>&>(*m_deferredDraws.back());
+        constexpr int kVaryings = DeferredDraw<ShaderT>::kVaryings;
+        typename DeferredDraw<ShaderT>::Triangle& tri = draw.triangles.emplace_back();
+        const VOut* src[3] = {&v0, &v1, &v2};
+        for (int k = 0; k < 3; ++k) {
+            tri.v[k].scn = src[k]->scn;
+            for (int j = 0; j < kVaryings; ++j) tri.v[k].varyings[j] = src[k]->ctx.varyings[j];
+        }
+
+        TileCommand cmd;
+        cmd.type = TileCommand::DRAW_TRIANGLE;
+        cmd.pipelineId = (uint16_t)(m_deferredDraws.size() - 1);
+        cmd.dataIndex = (uint32_t)(draw.triangles.size() - 1);
+        cmd.uniformOffset = 0;
+        m_parallelTiler.BinRect(minX, minY, maxX, maxY, cmd);
+
+        if (++m_deferredTriangleCount >= (size_t)PARALLEL_MAX_DEFERRED_TRIANGLES) glFinish();
+    }
+
+    // 编译期深度函数 (DepthFuncT == 0 时回退到运行时 switch)
+    template <GLenum DepthFuncT>
+    inline bool testDepthT(float z, float currentDepth, const RasterState& state) {
+        if constexpr (DepthFuncT == GL_LESS) return z < currentDepth;
+        else if constexpr (DepthFuncT == GL_LEQUAL) return z <= currentDepth;
+        else if constexpr (DepthFuncT == GL_ALWAYS) return true;
+        else return testDepth(z, currentDepth, state);
+    }
+
+    // glColorMask：只替换未被屏蔽的通道
+    static inline uint32_t maskedColor(uint32_t src, uint32_t dst, uint32_t writeMask) {
+        return (src & writeMask) | (dst & ~writeMask);
+    }
+
+    // 浮点混合 (参考实现)；定点快速路径 blendFixed 以它为准
+    static Vec4 applyBlending(const Vec4& src, const Vec4& dst, const RasterState& state) {
+        auto getFactor = [&](GLenum factor, const Vec4& s, const Vec4& d) -> Vec4 {
+            switch (factor) {
+                case GL_ZERO: return Vec4(0, 0, 0, 0);
+                case GL_ONE: return Vec4(1, 1, 1, 1);
+                case GL_SRC_COLOR: return s;
+                case GL_ONE_MINUS_SRC_COLOR: return Vec4(1, 1, 1, 1) - s;
+                case GL_DST_COLOR: return d;
+                case GL_ONE_MINUS_DST_COLOR: return Vec4(1, 1, 1, 1) - d;
+                case GL_SRC_ALPHA: return Vec4(s.w, s.w, s.w, s.w);
+                case GL_ONE_MINUS_SRC_ALPHA: return Vec4(1 - s.w, 1 - s.w, 1 - s.w, 1 - s.w);
+                case GL_DST_ALPHA: return Vec4(d.w, d.w, d.w, d.w);
+                case GL_ONE_MINUS_DST_ALPHA: return Vec4(1 - d.w, 1 - d.w, 1 - d.w, 1 - d.w);
+                case GL_SRC_ALPHA_SATURATE: {
+                    float f = std::min(s.w, 1.0f - d.w);
+                    return Vec4(f, f, f, 1.0f);
+                }
+                // CONSTANT_COLOR and others could be added if needed
+                default: return Vec4(1, 1, 1, 1);
+            }
+        };
+
+        Vec4 srcFactorRGB = getFactor(state.blend.srcRGB, src, dst);
+        Vec4 dstFactorRGB = getFactor(state.blend.dstRGB, src, dst);
+        Vec4 srcFactorA = getFactor(state.blend.srcAlpha, src, dst);
+        Vec4 dstFactorA = getFactor(state.blend.dstAlpha, src, dst);
+
+        auto combine = [](const Vec4& s, const Vec4& sf, const Vec4& d, const Vec4& df, GLenum op) -> Vec4 {
+            switch (op) {
+                case GL_FUNC_ADD: return s * sf + d * df;
+                case GL_FUNC_SUBTRACT: return s * sf - d * df;
+                case GL_FUNC_REVERSE_SUBTRACT: return d * df - s * sf;
+                case GL_MIN: return Vec4(std::min(s.x, d.x), std::min(s.y, d.y), std::min(s.z, d.z), std::min(s.w, d.w));
+                case GL_MAX: return Vec4(std::max(s.x, d.x), std::max(s.y, d.y), std::max(s.z, d.z), std::max(s.w, d.w));
+                default: return s * sf + d * df;
+            }
+        };
+
+        Vec4 resRGB = combine(src, srcFactorRGB, dst, dstFactorRGB, state.blend.equationRGB);
+        Vec4 resA = combine(src, srcFactorA, dst, dstFactorA, state.blend.equationAlpha);
+
+        return Vec4(resRGB.x, resRGB.y, resRGB.z, resA.w);
+    }
+
+    // 当前混合状态对应的定点模式；未开启混合或模式不受支持时为 FIXED_BLEND_NONE (浮点 applyBlending)
+    static FixedBlendMode fixedBlendMode(const RasterState& s) {
+        if (!s.blendEnabled) return FIXED_BLEND_NONE;
+        return classifyFixedBlend(s.blend.srcRGB, s.blend.dstRGB, s.blend.srcAlpha, s.blend.dstAlpha,
+                                  s.blend.equationRGB, s.blend.equationAlpha);
+    }
+
+    // 三角形光栅化内核
+    // DepthFuncT == 0 为通用内核：深度、模板、混合全部在运行时读取 state
+    // SamplesT > 1 为 MSAA：逐采样点计算覆盖、深度与模板，Fragment Shader 每个覆盖像素只在像素中心执行一次
+    template <typename ShaderT, GLenum DepthFuncT, bool DepthWriteT, int BlendT, int SamplesT = 1>
+    void rasterizeTriangleKernel(ShaderT& shader, const VOut& v0, const VOut& v1, const VOut& v2, const RasterState& state) {
+
+        // 0. 内核参数：特化内核中均为编译期常量，分支会被完全消除
+        constexpr bool kGenericKernel = (DepthFuncT == 0);
+        // MSAA：覆盖/深度/模板逐采样点，Fragment Shader 每像素只执行一次 (像素中心)
+        constexpr bool kMSAA = SamplesT > 1;
+        constexpr int kFullCover = (1 << SamplesT) - 1;
+        const bool depthTestOn = kGenericKernel ? state.depthTest : (DepthFuncT != GL_ALWAYS);
+        const GLenum depthFunc = kGenericKernel ? state.depthFunc : DepthFuncT;
+        const bool depthWrite = kGenericKernel ? (bool)state.depthMask : DepthWriteT;
+        const bool enableStencilTest = kGenericKernel && state.stencilTest;
+        // 提前深度剔除 (Hi-Z / Early-Z) 的条件同 earlyDepthRejectEnabled (特化内核没有模板测试)
+        const bool earlyDepthReject = depthTestOn && !shaderWritesFragDepth<ShaderT>() &&
+                                      !(enableStencilTest && (state.stencilFail != GL_KEEP || state.stencilPassDepthFail != GL_KEEP));
+        // 颜色写掩码：特化内核只在 glColorMask 全开 (或 Depth-Only 全关) 时被选中
+        const uint32_t colorWriteMask = kGenericKernel ? state.colorWriteMask() : (BlendT == RASTER_BLEND_DEPTH_ONLY ? 0u : 0xFFFFFFFFu);
+        // 定点混合：RASTER_BLEND_FIXED 内核按 Quad 批量混合，通用内核逐采样点调用标量版本
+        const FixedBlendMode fixedBlend = (BlendT == RASTER_BLEND_FIXED || kGenericKernel) ? fixedBlendMode(state) : FIXED_BLEND_NONE;
+        // 不执行 Fragment Shader：通用内核中 (例如模板阴影体) 颜色全屏蔽时同样适用
+        const bool runFragment = !(colorWriteMask == 0 && !shaderWritesFragDepth<ShaderT>() && !shaderUsesDiscard<ShaderT>());
+
+        // Depth-Only 且不写深度：没有任何可见效果
+        if constexpr (BlendT == RASTER_BLEND_DEPTH_ONLY && !DepthWriteT) return;
 
         // 1. 包围盒计算 (Bounding Box)
         int limitMinX = std::max(0, state.viewport.x);
@@ -559,17 +1186,21 @@ public:
         // Early out if scissor/viewport is empty
         if (limitMinX >= limitMaxX || limitMinY >= limitMaxY) return;
 
-        int minX = std::max(limitMinX, (int)std::min({v0.scn.x, v1.scn.x, v2.scn.x}));
-        int maxX = std::min(limitMaxX - 1, (int)std::max({v0.scn.x, v1.scn.x, v2.scn.x}) + 1);
-        int minY = std::max(limitMinY, (int)std::min({v0.scn.y, v1.scn.y, v2.scn.y}));
-        int maxY = std::min(limitMaxY - 1, (int)std::max({v0.scn.y, v1.scn.y, v2.scn.y}) + 1);
+        // 2. 定点化顶点坐标 (Sub-pixel Snapping)
+        // 屏幕坐标量化到 1/2^RASTER_SUBPIXEL_BITS 像素，边函数全部用整数计算：
+        // 覆盖判定是精确的，与三角形提交顺序和 Tile 划分无关
+        constexpr int64_t SUB_ONE = int64_t(1) << RASTER_SUBPIXEL_BITS;
+        constexpr int64_t SUB_HALF = SUB_ONE >> 1;
+        auto snap = [](float v) { return (int64_t)std::llround(v * (float)SUB_ONE); };
+        int64_t fx0 = snap(v0.scn.x), fy0 = snap(v0.scn.y);
+        int64_t fx1 = snap(v1.scn.x), fy1 = snap(v1.scn.y);
+        int64_t fx2 = snap(v2.scn.x), fy2 = snap(v2.scn.y);
 
-        // Early out if triangle is outside scissor/viewport
-        if (minX > maxX || minY > maxY) return;
+        // 3. 面积计算 (Backface Culling)
+        int64_t area = (fy1 - fy0) * (fx2 - fx0) - (fx1 - fx0) * (fy2 - fy0);
 
-        // 2. 面积计算 (Backface Culling)
-        float area = (v1.scn.y - v0.scn.y) * (v2.scn.x - v0.scn.x) - 
-                     (v1.scn.x - v0.scn.x) * (v2.scn.y - v0.scn.y);
+        // 面积 == 0 剔除 (Degenerate)，定点下没有浮点误差导致的闪烁
+        if (area == 0) return;
 
         // Determine Face Orientation
         // In this implementation: Positive Area = CCW, Negative Area = CW
@@ -589,28 +1220,68 @@ public:
         const VOut& tv1 = swap ? v2 : v1;
         const VOut& tv2 = swap ? v1 : v2;
         
-        if (swap) area = -area;
+        if (swap) {
+            std::swap(fx1, fx2);
+            std::swap(fy1, fy2);
+            area = -area;
+        }
+        float invArea = 1.0f / (float)area; // 单位: 定点^2
+
+        // 包围盒：只包含像素中心 (x + 0.5) 可能落在三角形内的像素
+        int minX = std::max(limitMinX, (int)((std::min({fx0, fx1, fx2}) - SUB_HALF + SUB_ONE - 1) >> RASTER_SUBPIXEL_BITS));
+        int maxX = std::min(limitMaxX - 1, (int)((std::max({fx0, fx1, fx2}) - SUB_HALF) >> RASTER_SUBPIXEL_BITS));
+        int minY = std::max(limitMinY, (int)((std::min({fy0, fy1, fy2}) - SUB_HALF + SUB_ONE - 1) >> RASTER_SUBPIXEL_BITS));
+        int maxY = std::min(limitMaxY - 1, (int)((std::max({fy0, fy1, fy2}) - SUB_HALF) >> RASTER_SUBPIXEL_BITS));
+        if constexpr (kMSAA) {
+            // 采样点偏离像素中心不足半像素，包围盒外扩 1 像素即可，覆盖由逐采样点边函数精确判定
+            minX = std::max(limitMinX, minX - 1);
+            maxX = std::min(limitMaxX - 1, maxX + 1);
+            minY = std::max(limitMinY, minY - 1);
+            maxY = std::min(limitMaxY - 1, maxY + 1);
+        }
 
-        // 面积 <= 0 剔除 (Degenerate)
-        // 使用 epsilon 避免浮点误差导致的闪烁
-        if (area <= 1e-6f) return;
-        float invArea = 1.0f / area;
+        // Early out if triangle is outside scissor/viewport
+        if (minX > maxX || minY > maxY) return;
 
-        // 3. 增量系数 Setup
-        // Edge 0: tv1 -> tv2
-        float A0 = tv2.scn.y - tv1.scn.y; float B0 = tv1.scn.x - tv2.scn.x;
-        // Edge 1: tv2 -> tv0
-        float A1 = tv0.scn.y - tv2.scn.y; float B1 = tv2.scn.x - tv0.scn.x;
-        // Edge 2: tv0 -> tv1
-        float A2 = tv1.scn.y - tv0.scn.y; float B2 = tv0.scn.x - tv1.scn.x;
+        // Hi-Z 三角形级剔除：三角形最近深度比包围盒覆盖的所有块的最大深度都远时整体丢弃
+        // 与逐像素 Early-Z 语义一致，只对 GL_LESS / GL_LEQUAL 有效
+        // Hi-Z 中保存的是存储精度下的深度，定点格式下先把估计的最近深度 quantize 再比较 (单调，仍然保守)
+        const DepthStencilView ds = depthStencilView(); // 深度格式分支对整个三角形恒定
+        // 布局拷贝到局部：颜色写入 (uint32_t*) 与 int 成员可能别名，避免每个片元重新加载
+        const SurfaceLayout colorLayout = m_colorLayout;
+        const SurfaceLayout pixelLayout = m_pixelLayout;
+        bool useHiZ = m_hizEnabled && earlyDepthReject && (depthFunc == GL_LESS || depthFunc == GL_LEQUAL);
+        float triMinZ = ds.quantize(std::min({v0.scn.z, v1.scn.z, v2.scn.z}));
+        if (useHiZ) {
+            bool occluded = true;
+            for (int by = minY / RASTER_BLOCK_SIZE; occluded && by <= maxY / RASTER_BLOCK_SIZE; ++by) {
+                const float* row = hizBuffer.data() + by * m_hizWidth;
+                for (int bx = minX / RASTER_BLOCK_SIZE; bx <= maxX / RASTER_BLOCK_SIZE; ++bx) {
+                    if (!hizOccluded(triMinZ, row[bx], depthFunc)) { occluded = false; break; }
+                }
+            }
+            if (occluded) return;
+        }
+
+        // 快速清除：包围盒覆盖的 Tile 在第一次被触及时执行待定的清除 (并行/RHI 模式下包围盒已限制在本任务的 Tile 内)
+        if (m_clearPending) materializeTiles(minX, minY, maxX, maxY);
+
+        // 整数边函数系数 E(x, y) = A * (x - ax) + B * (y - ay)
+        // Edge 0: tv1 -> tv2, Edge 1: tv2 -> tv0, Edge 2: tv0 -> tv1
+        int64_t edgeA[3] = {fy2 - fy1, fy0 - fy2, fy1 - fy0};
+        int64_t edgeB[3] = {fx1 - fx2, fx2 - fx0, fx0 - fx1};
+        int64_t edgeAX[3] = {fx1, fx2, fx0};
+        int64_t edgeAY[3] = {fy1, fy2, fy0};
 
         // 4. [关键优化] 预计算透视修正后的 Varyings
         // 原理：在三角形 Setup 阶段，先计算好 (Attr * 1/w_clip)
         // 这样在像素循环中，只需要做线性组合，不需要做额外的乘法
         // 我们利用 SIMD 寄存器数组在栈上存储这些预处理数据
-        Simd4f preVar0[MAX_VARYINGS];
-        Simd4f preVar1[MAX_VARYINGS];
-        Simd4f preVar2[MAX_VARYINGS];
+        // 只处理 Shader 声明使用的 Varying (kVaryings)
+        constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        Simd4f preVar0[kVaryings > 0 ? kVaryings : 1];
+        Simd4f preVar1[kVaryings > 0 ? kVaryings : 1];
+        Simd4f preVar2[kVaryings > 0 ? kVaryings : 1];
 
         // 广播 1/w_clip 到 SIMD 寄存器
         Simd4f w0_vec(tv0.scn.w);
@@ -618,176 +1289,378 @@ public:
         Simd4f w2_vec(tv2.scn.w);
 
         // 循环展开预处理所有 Varyings
-        for (int k = 0; k < MAX_VARYINGS; ++k) {
+        const int setupVaryings = runFragment ? kVaryings : 0;
+        for (int k = 0; k < setupVaryings; ++k) {
             preVar0[k] = Simd4f::load(tv0.ctx.varyings[k]) * w0_vec;
             preVar1[k] = Simd4f::load(tv1.ctx.varyings[k]) * w1_vec;
             preVar2[k] = Simd4f::load(tv2.ctx.varyings[k]) * w2_vec;
         }
 
-        // 5. 初始权重计算 (Pixel Center)
-        float startX = minX + 0.5f;
-        float startY = minY + 0.5f;
-        auto edgeFunc = [](float ax, float ay, float bx, float by, float px, float py) {
-            return (by - ay) * (px - ax) - (bx - ax) * (py - ay);
+        // 5. 分层光栅化 Setup
+        // 以 8x8 块 -> 4x4 子块 -> 2x2 Quad 的层级遍历包围盒：
+        // 完全在外的块直接跳过，完全在内的块跳过边函数测试，只有部分覆盖的块才逐 Quad 测试
+        // Quad 内用 SIMD 同时计算 4 个像素的边函数、重心坐标与深度
+        // Lane 布局: 0=(x, y) 1=(x+1, y) 2=(x, y+1) 3=(x+1, y+1)
+        // 未覆盖的 Lane 作为 Helper 只参与插值，用于求 Varyings 的屏幕空间偏导，不执行 Fragment Shader
+        constexpr int BLOCK_SIZE = RASTER_BLOCK_SIZE; // 与 Hi-Z 块对齐
+        constexpr int SUB_BLOCK_SIZE = 4;
+        int blockMinX = minX & ~(BLOCK_SIZE - 1);
+        int blockMinY = minY & ~(BLOCK_SIZE - 1);
+        // 三条边在遍历原点 (blockMinX, blockMinY) 像素中心处的值，以及每移动一个像素的整数增量
+        // Top-Left Fill Rule：像素中心恰好落在边上时只归属 Top/Left 边所在的三角形，
+        // 对其余边的常数项减 1，使 E >= 0 在该边上等价于 E > 0，共享边上的像素只着色一次
+        int64_t originX = ((int64_t)blockMinX << RASTER_SUBPIXEL_BITS) + SUB_HALF;
+        int64_t originY = ((int64_t)blockMinY << RASTER_SUBPIXEL_BITS) + SUB_HALF;
+        int64_t edgeC[3], stepX[3], stepY[3];
+        for (int e = 0; e < 3; ++e) {
+            bool topLeft = edgeA[e] > 0 || (edgeA[e] == 0 && edgeB[e] > 0);
+            edgeC[e] = edgeA[e] * (originX - edgeAX[e]) + edgeB[e] * (originY - edgeAY[e]) - (topLeft ? 0 : 1);
+            stepX[e] = edgeA[e] * SUB_ONE;
+            stepY[e] = edgeB[e] * SUB_ONE;
+        }
+
+        // 深度平面 z(x, y) 在遍历原点的值与每像素梯度，用于估计块内最小深度
+        float zOrigin = (tv0.scn.z * (float)edgeC[0] + tv1.scn.z * (float)edgeC[1] + tv2.scn.z * (float)edgeC[2]) * invArea;
+        float zStepX = (tv0.scn.z * (float)stepX[0] + tv1.scn.z * (float)stepX[1] + tv2.scn.z * (float)stepX[2]) * invArea;
+        float zStepY = (tv0.scn.z * (float)stepY[0] + tv1.scn.z * (float)stepY[1] + tv2.scn.z * (float)stepY[2]) * invArea;
+
+        // 采样点相对像素中心的边函数/深度偏移；sampleMargin 为偏移绝对值的上界，用于保守的块分类
+        int64_t sampleE[3][SamplesT];
+        int64_t sampleMargin[3] = {0, 0, 0};
+        float zSampleOffset[SamplesT];
+        if constexpr (kMSAA) {
+            for (int s = 0; s < SamplesT; ++s) {
+                int64_t sx = MSAA_SAMPLE_OFFSETS[s][0] * (SUB_ONE / 16);
+                int64_t sy = MSAA_SAMPLE_OFFSETS[s][1] * (SUB_ONE / 16);
+                for (int e = 0; e < 3; ++e) {
+                    sampleE[e][s] = edgeA[e] * sx + edgeB[e] * sy;
+                    sampleMargin[e] = std::max(sampleMargin[e], std::abs(sampleE[e][s]));
+                }
+                zSampleOffset[s] = (zStepX * MSAA_SAMPLE_OFFSETS[s][0] + zStepY * MSAA_SAMPLE_OFFSETS[s][1]) * (1.0f / 16.0f);
+            }
+        }
+
+        // 每个 Lane 相对 Quad 左上像素的边函数偏移 (浮点，仅用于重心坐标插值)
+        Simd4f laneE0(0.0f, (float)stepX[0], (float)stepY[0], (float)(stepX[0] + stepY[0]));
+        Simd4f laneE1(0.0f, (float)stepX[1], (float)stepY[1], (float)(stepX[1] + stepY[1]));
+        Simd4f laneE2(0.0f, (float)stepX[2], (float)stepY[2], (float)(stepX[2] + stepY[2]));
+
+        Simd4f invArea_vec(invArea);
+        Simd4f z0_vec(tv0.scn.z);
+        Simd4f z1_vec(tv1.scn.z);
+        Simd4f z2_vec(tv2.scn.z);
+
+        // [优化] Quad 上下文提到循环外，避免每次构造 memset
+        ShaderContext quadCtx[4];
+        QuadDerivatives quadDeriv;
+        bool blockDepthWritten = false;
+        uint32_t* colorTarget = kMSAA ? m_sampleColorBuffer.data() : m_colorBufferPtr;
+        shader.gl_FrontFacing = isFront;
+        shader.gl_Derivatives = &quadDeriv;
+
+        // 块分类：0 = 完全在外, 1 = 部分覆盖, 2 = 完全在内
+        // 边函数是线性的，块内像素中心上的极值必在四个角点取得
+        auto classifyBlock = [&](int bx, int by, int size) -> int {
+            int64_t ox = bx - blockMinX;
+            int64_t oy = by - blockMinY;
+            bool inside = true;
+            for (int e = 0; e < 3; ++e) {
+                int64_t c = edgeC[e] + stepX[e] * ox + stepY[e] * oy;
+                int64_t dx = stepX[e] * (size - 1);
+                int64_t dy = stepY[e] * (size - 1);
+                int64_t eMax = c + std::max<int64_t>(0, dx) + std::max<int64_t>(0, dy);
+                if (eMax + sampleMargin[e] < 0) return 0;
+                int64_t eMin = c + std::min<int64_t>(0, dx) + std::min<int64_t>(0, dy);
+                if (eMin - sampleMargin[e] < 0) inside = false;
+            }
+            return inside ? 2 : 1;
         };
-        float w0_row = edgeFunc(tv1.scn.x, tv1.scn.y, tv2.scn.x, tv2.scn.y, startX, startY);
-        float w1_row = edgeFunc(tv2.scn.x, tv2.scn.y, tv0.scn.x, tv0.scn.y, startX, startY);
-        float w2_row = edgeFunc(tv0.scn.x, tv0.scn.y, tv1.scn.x, tv1.scn.y, startX, startY);
-
-        // Optimization: Cache capability flags
-        bool enableDepthTest = state.depthTest;
-        bool enableStencilTest = state.stencilTest;
-
-        // 6. 像素遍历循环
-        for (int y = minY; y <= maxY; ++y) {
-            float w0 = w0_row; float w1 = w1_row; float w2 = w2_row;
-            
-            // 直接计算指针偏移，避免乘法
-            uint32_t pixelOffset = y * fbWidth + minX;
-            uint32_t* pColor = m_colorBufferPtr + pixelOffset;
-            float* pDepth = depthBuffer.data() + pixelOffset;
-            uint8_t* pStencil = stencilBuffer.data() + pixelOffset;
-
-            // [优化] 将 fsIn 提到循环外，避免每次循环都构造 memset
-            ShaderContext fsIn; 
-            for (int x = minX; x <= maxX; ++x) {
-                if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
-                    float alpha = w0 * invArea;
-                    float beta  = w1 * invArea;
-                    float gamma = w2 * invArea;
-
-                    float zInv = alpha * tv0.scn.w + beta * tv1.scn.w + gamma * tv2.scn.w;
-                    
-                    if (zInv > 1e-6f) {
-                        float z = 1.0f / zInv;
-                        float fragDepth = alpha * tv0.scn.z + beta * tv1.scn.z + gamma * tv2.scn.z;
-                        
-                        // 1. Early-Z Optimization (Read-only)
-                        bool earlyZPass = true;
-                        if (enableDepthTest) {
-                            earlyZPass = testDepth(fragDepth, *pDepth, state);
+
+        // 单个 Quad 的处理；testEdges == false 时 (所在块完全在三角形内) 跳过边函数测试
+        auto shadeQuad = [&](int qx, int qy, bool testEdges) {
+            // 包围盒掩码：包围盒已被 Viewport/Scissor 裁剪，块内的像素仍需按它过滤
+            int mask = ((qy >= minY ? 0x3 : 0) | (qy + 1 <= maxY ? 0xC : 0)) &
+                       ((qx >= minX ? 0x5 : 0) | (qx + 1 <= maxX ? 0xA : 0));
+            if (!mask) return;
+
+            int64_t ox = qx - blockMinX;
+            int64_t oy = qy - blockMinY;
+            int64_t qe0 = edgeC[0] + stepX[0] * ox + stepY[0] * oy;
+            int64_t qe1 = edgeC[1] + stepX[1] * ox + stepY[1] * oy;
+            int64_t qe2 = edgeC[2] + stepX[2] * ox + stepY[2] * oy;
+            // 每个 Lane 覆盖的采样点掩码 (非 MSAA 时只有 bit 0)
+            int sampleCover[4] = {kFullCover, kFullCover, kFullCover, kFullCover};
+            if (testEdges) {
+                if constexpr (kMSAA) {
+                    for (int i = 0; i < 4; ++i) {
+                        if (!(mask & (1 << i))) continue;
+                        int64_t l0 = qe0 + ((i & 1) ? stepX[0] : 0) + ((i >> 1) ? stepY[0] : 0);
+                        int64_t l1 = qe1 + ((i & 1) ? stepX[1] : 0) + ((i >> 1) ? stepY[1] : 0);
+                        int64_t l2 = qe2 + ((i & 1) ? stepX[2] : 0) + ((i >> 1) ? stepY[2] : 0);
+                        int c = 0;
+                        for (int s = 0; s < SamplesT; ++s) {
+                            if (((l0 + sampleE[0][s]) | (l1 + sampleE[1][s]) | (l2 + sampleE[2][s])) >= 0) c |= 1 << s;
                         }
+                        sampleCover[i] = c;
+                        if (!c) mask &= ~(1 << i);
+                    }
+                } else {
+                    // (a | b | c) >= 0 <=> 三者符号位均为 0
+                    int cover = 0;
+                    if ((qe0 | qe1 | qe2) >= 0) cover |= 1;
+                    if (((qe0 + stepX[0]) | (qe1 + stepX[1]) | (qe2 + stepX[2])) >= 0) cover |= 2;
+                    if (((qe0 + stepY[0]) | (qe1 + stepY[1]) | (qe2 + stepY[2])) >= 0) cover |= 4;
+                    if (((qe0 + stepX[0] + stepY[0]) | (qe1 + stepX[1] + stepY[1]) | (qe2 + stepX[2] + stepY[2])) >= 0) cover |= 8;
+                    mask &= cover;
+                }
+                if (!mask) return;
+            }
 
-                        if (earlyZPass) {
-                            // 2. Fragment Interpolation
-                            fsIn.rho = 0;
-
-                            Simd4f z_vec(z);
-                            Simd4f alpha_vec(alpha);
-                            Simd4f beta_vec(beta);
-                            Simd4f gamma_vec(gamma);
-
-                            for (int k = 0; k < MAX_VARYINGS; ++k) {
-                                Simd4f res = preVar0[k] * alpha_vec;
-                                res = res.madd(preVar1[k], beta_vec);
-                                res = res.madd(preVar2[k], gamma_vec);
-                                res = res * z_vec;
-                                res.store(fsIn.varyings[k]);
+            Simd4f e0 = Simd4f((float)qe0) + laneE0;
+            Simd4f e1 = Simd4f((float)qe1) + laneE1;
+            Simd4f e2 = Simd4f((float)qe2) + laneE2;
+
+            Simd4f alpha_q = e0 * invArea_vec;
+            Simd4f beta_q  = e1 * invArea_vec;
+            Simd4f gamma_q = e2 * invArea_vec;
+            Simd4f zInv_q = (w0_vec * alpha_q).madd(w1_vec, beta_q).madd(w2_vec, gamma_q);
+            Simd4f depth_q = (z0_vec * alpha_q).madd(z1_vec, beta_q).madd(z2_vec, gamma_q);
+
+            alignas(16) float alpha[4], beta[4], gamma[4], zInv[4], fragDepth[4];
+            alpha_q.store(alpha); beta_q.store(beta); gamma_q.store(gamma);
+            zInv_q.store(zInv); depth_q.store(fragDepth);
+
+            // 1. Early-Z Optimization (Read-only)，剔除被遮挡的 Lane
+            const size_t pixQuad = pixelLayout.index(qx, qy);
+            for (int i = 0; i < 4; ++i) {
+                if (!(mask & (1 << i))) continue;
+                size_t pix = pixQuad + pixelLayout.quadOffset[i];
+                if constexpr (kMSAA) {
+                    // 逐采样点 Early-Z：深度按平面梯度外推到采样点位置
+                    if (zInv[i] <= 1e-6f) { mask &= ~(1 << i); continue; }
+                    if (earlyDepthReject) {
+                        for (int s = 0; s < SamplesT; ++s) {
+                            if ((sampleCover[i] & (1 << s)) &&
+                                !testDepthT<DepthFuncT>(ds.quantize(fragDepth[i] + zSampleOffset[s]), ds.load(pix * SamplesT + s), state)) {
+                                sampleCover[i] &= ~(1 << s);
                             }
+                        }
+                        if (!sampleCover[i]) mask &= ~(1 << i);
+                    }
+                } else if (zInv[i] <= 1e-6f || (earlyDepthReject && !testDepthT<DepthFuncT>(ds.quantize(fragDepth[i]), ds.load(pix), state))) {
+                    mask &= ~(1 << i);
+                }
+            }
 
-                            // --- LOD Calculation ---
-                            float dADX = A0 * invArea; float dBDX = A1 * invArea; float dGDX = A2 * invArea;
-                            float dADY = B0 * invArea; float dBDY = B1 * invArea; float dGDY = B2 * invArea;
-                            float dZwDX = dADX * tv0.scn.w + dBDX * tv1.scn.w + dGDX * tv2.scn.w;
-                            float dZwDY = dADY * tv0.scn.w + dBDY * tv1.scn.w + dGDY * tv2.scn.w;
-                            Vec4 uv0 = tv0.ctx.varyings[0] * tv0.scn.w;
-                            Vec4 uv1 = tv1.ctx.varyings[0] * tv1.scn.w;
-                            Vec4 uv2 = tv2.ctx.varyings[0] * tv2.scn.w;
-                            Vec4 dUVwDX = uv0 * dADX + uv1 * dBDX + uv2 * dGDX;
-                            Vec4 dUVwDY = uv0 * dADY + uv1 * dBDY + uv2 * dGDY;
-                            fsIn.rho = computeRho(z, dUVwDX, dUVwDY, dZwDX, dZwDY, fsIn.varyings[0].x, fsIn.varyings[0].y);
-
-                            // 3. Fragment Shader
-                            // Setup Builtins
-                            shader.gl_FragCoord = Vec4(x + 0.5f, y + 0.5f, fragDepth, zInv); 
-                            shader.gl_FrontFacing = isFront;
-                            shader.gl_Discard = false;
-                            shader.gl_FragDepth.written = false;
-
-                            shader.fragment(fsIn);
-                            Vec4 fColor = shader.gl_FragColor;
-
-                            // 4. Discard Check
-                            if (!shader.gl_Discard) {
-                                float finalZ = shader.gl_FragDepth.written ? shader.gl_FragDepth.value : fragDepth;
-
-                                bool stencilPass = true;
-                                bool depthPass = true;
-
-                                // Optimization: Only re-test depth if FragDepth was written.
-                                // If not written, we rely on Early-Z result (which must have been true to get here).
-                                bool needDepthTest = enableDepthTest && shader.gl_FragDepth.written;
-
-                                if (enableStencilTest) {
-                                    if (!checkStencil(*pStencil, state)) {
-                                        applyStencilOp(state.stencilFail, *pStencil, state);
-                                        stencilPass = false;
-                                    } else {
-                                        // Stencil Passed, check Depth for Stencil Op
-                                        if (needDepthTest && !testDepth(finalZ, *pDepth, state)) {
-                                            applyStencilOp(state.stencilPassDepthFail, *pStencil, state);
-                                            depthPass = false;
-                                        } else {
-                                            applyStencilOp(state.stencilPassDepthPass, *pStencil, state);
-                                            depthPass = true;
-                                        }
-                                    }
+            if (mask) {
+                float rho = 0.0f;
+                if (runFragment) {
+                    // 2. Fragment Interpolation (4 个 Lane 全部插值，Helper Lane 用于求导)
+                    for (int i = 0; i < 4; ++i) {
+                        float z = 1.0f / std::max(zInv[i], 1e-6f);
+                        Simd4f z_vec(z);
+                        Simd4f alpha_vec(alpha[i]);
+                        Simd4f beta_vec(beta[i]);
+                        Simd4f gamma_vec(gamma[i]);
+
+                        for (int k = 0; k < kVaryings; ++k) {
+                            Simd4f res = preVar0[k] * alpha_vec;
+                            res = res.madd(preVar1[k], beta_vec);
+                            res = res.madd(preVar2[k], gamma_vec);
+                            res = res * z_vec;
+                            res.store(quadCtx[i].varyings[k]);
+                        }
+                    }
+
+                    // 3. Quad 有限差分求偏导 (Coarse)
+                    for (int k = 0; k < kVaryings; ++k) {
+                        Simd4f v0 = Simd4f::load(quadCtx[0].varyings[k]);
+                        (Simd4f::load(quadCtx[1].varyings[k]) - v0).store(quadDeriv.dx[k]);
+                        (Simd4f::load(quadCtx[2].varyings[k]) - v0).store(quadDeriv.dy[k]);
+                    }
+
+                    // --- LOD Calculation ---
+                    // 兼容旧接口：ctx.rho 取 varyings[0].xy，每个 Quad 只算一次 sqrt
+                    rho = shader.lodRho(0);
+                }
+
+                // 颜色按当前目标的布局寻址 (FBO 为纹理的 4x4 分块)；MSAA 采样缓冲与深度/模板同为 pixelLayout
+                size_t colorQuad = kMSAA ? 0 : colorLayout.index(qx, qy);
+                // RASTER_BLEND_FIXED：通过测试的片元颜色先收集起来，Quad 结束后 4 像素一次混合并写回
+                uint32_t quadSrc[4] = {}, quadDst[4] = {};
+                int blendMask = 0;
+
+                for (int i = 0; i < 4; ++i) {
+                    if (!(mask & (1 << i))) continue;
+                    int x = qx + (i & 1);
+                    int y = qy + (i >> 1);
+                    size_t pix = (pixQuad + pixelLayout.quadOffset[i]) * SamplesT;
+                    uint32_t* pColor = kMSAA ? colorTarget + pix : colorTarget + colorQuad + colorLayout.quadOffset[i];
+
+                    Vec4 fColor;
+                    float finalZ = fragDepth[i];
+                    bool fragDepthWritten = false;
+
+                    if (runFragment) {
+                        ShaderContext& fsIn = quadCtx[i];
+                        fsIn.rho = rho;
+
+                        // 4. Fragment Shader
+                        // Setup Builtins
+                        shader.gl_FragCoord = Vec4(x + 0.5f, y + 0.5f, fragDepth[i], zInv[i]);
+                        shader.gl_Discard = false;
+                        shader.gl_FragDepth.written = false;
+
+                        shader.fragment(fsIn);
+                        fColor = shader.gl_FragColor;
+
+                        // 5. Discard Check
+                        if (shader.gl_Discard) continue;
+
+                        fragDepthWritten = shader.gl_FragDepth.written;
+                        if (fragDepthWritten) finalZ = shader.gl_FragDepth.value;
+                    }
+
+                    // Optimization: Only re-test depth if FragDepth was written or Early-Z was skipped.
+                    // Otherwise we rely on Early-Z result (which must have been true to get here).
+                    bool needDepthTest = depthTestOn && (fragDepthWritten || !earlyDepthReject);
+
+                    // MSAA 下各采样点的目标颜色通常相同 (三角形内部)，混合结果按目标颜色缓存
+                    const bool blendReadsDst = BlendT == RASTER_BLEND_GENERIC && state.blendEnabled;
+                    bool haveOut = false;
+                    uint32_t lastDst = 0, lastOut = 0;
+
+                    for (int s = 0; s < SamplesT; ++s) {
+                        if (!(sampleCover[i] & (1 << s))) continue;
+                        float sampleZ = finalZ;
+                        if constexpr (kMSAA) {
+                            if (!fragDepthWritten) sampleZ = fragDepth[i] + zSampleOffset[s];
+                        }
+
+                        bool stencilPass = true;
+                        bool depthPass = true;
+                        const size_t si = pix + s;
+
+                        if (enableStencilTest) {
+                            uint8_t sv = ds.loadStencil(si);
+                            if (!checkStencil(sv, state)) {
+                                applyStencilOp(state.stencilFail, sv, state);
+                                stencilPass = false;
+                            } else {
+                                // Stencil Passed, check Depth for Stencil Op
+                                if (needDepthTest && !testDepthT<DepthFuncT>(ds.quantize(sampleZ), ds.load(si), state)) {
+                                    applyStencilOp(state.stencilPassDepthFail, sv, state);
+                                    depthPass = false;
                                 } else {
-                                    // No Stencil, just check Depth
-                                    if (needDepthTest && !testDepth(finalZ, *pDepth, state)) {
-                                        depthPass = false;
-                                    }
+                                    applyStencilOp(state.stencilPassDepthPass, sv, state);
+                                    depthPass = true;
                                 }
+                            }
+                            ds.storeStencil(si, sv);
+                        } else {
+                            // No Stencil, just check Depth
+                            if (needDepthTest && !testDepthT<DepthFuncT>(ds.quantize(sampleZ), ds.load(si), state)) {
+                                depthPass = false;
+                            }
+                        }
+
+                        if (stencilPass && depthPass) {
+                            if (depthWrite) {
+                                ds.store(si, sampleZ);
+                                blockDepthWritten = true;
+                            }
 
-                                if (stencilPass && depthPass) {
-                                    if (state.depthMask) *pDepth = finalZ;
-                                    
-                                    if (state.blendEnabled) {
-                                        Vec4 dstColor = ColorUtils::Uint32ToFloat(*pColor);
-                                        fColor = applyBlending(fColor, dstColor, state);
+                            if constexpr (BlendT == RASTER_BLEND_FIXED) {
+                                quadSrc[i] = ColorUtils::FloatToUint32(fColor);
+                                blendMask |= 1 << i;
+                            } else if (colorWriteMask) {
+                                uint32_t dst = pColor[s];
+                                if (!haveOut || (blendReadsDst && dst != lastDst)) {
+                                    if (fixedBlend != FIXED_BLEND_NONE) {
+                                        lastOut = blendFixed(fixedBlend, ColorUtils::FloatToUint32(fColor), dst);
+                                    } else if (blendReadsDst) {
+                                        Vec4 dstColor = ColorUtils::Uint32ToFloat(dst);
+                                        lastOut = ColorUtils::FloatToUint32(applyBlending(fColor, dstColor, state));
+                                    } else {
+                                        lastOut = ColorUtils::FloatToUint32(fColor);
                                     }
-                                    *pColor = ColorUtils::FloatToUint32(fColor);
+                                    lastDst = dst;
+                                    haveOut = true;
                                 }
+                                pColor[s] = maskedColor(lastOut, dst, colorWriteMask);
+                            }
+                        }
+                    }
+                }
+
+                if constexpr (BlendT == RASTER_BLEND_FIXED) {
+                    if (blendMask) {
+                        uint32_t* pQuad = colorTarget + colorQuad;
+                        for (int i = 0; i < 4; ++i) {
+                            if (blendMask & (1 << i)) quadDst[i] = pQuad[colorLayout.quadOffset[i]];
+                        }
+                        blendFixed4(fixedBlend, quadSrc, quadDst, quadDst);
+                        for (int i = 0; i < 4; ++i) {
+                            if (blendMask & (1 << i)) pQuad[colorLayout.quadOffset[i]] = quadDst[i];
+                        }
+                    }
+                }
+            }
+        };
+
+        // 6. 分层遍历：8x8 块 -> 4x4 子块 -> 2x2 Quad
+        for (int by = blockMinY; by <= maxY; by += BLOCK_SIZE) {
+            for (int bx = blockMinX; bx <= maxX; bx += BLOCK_SIZE) {
+                int blockClass = classifyBlock(bx, by, BLOCK_SIZE);
+                if (blockClass == 0) continue;
+
+                // Hi-Z 块级剔除：用深度平面在块角点上的最小值 (不小于三角形最近深度) 估计块内最近片元
+                // 减去 EPSILON 抵消平面求值与逐像素插值之间的舍入差异，保证剔除是保守的
+                int hizIdx = (by / BLOCK_SIZE) * m_hizWidth + bx / BLOCK_SIZE;
+                if (useHiZ) {
+                    float span = (float)(BLOCK_SIZE - 1);
+                    float zc = zOrigin + zStepX * (float)(bx - blockMinX) + zStepY * (float)(by - blockMinY);
+                    float blockMinZ = zc + std::min(0.0f, zStepX * span) + std::min(0.0f, zStepY * span) - EPSILON;
+                    if constexpr (kMSAA) blockMinZ -= (std::abs(zStepX) + std::abs(zStepY)) * 0.5f; // 采样点越出像素中心
+                    if (hizOccluded(std::max(ds.quantize(blockMinZ), triMinZ), hizBuffer[hizIdx], depthFunc)) continue;
+                }
+                blockDepthWritten = false;
+
+                for (int sy = by; sy < by + BLOCK_SIZE && sy <= maxY; sy += SUB_BLOCK_SIZE) {
+                    for (int sx = bx; sx < bx + BLOCK_SIZE && sx <= maxX; sx += SUB_BLOCK_SIZE) {
+                        int subClass = (blockClass == 2) ? 2 : classifyBlock(sx, sy, SUB_BLOCK_SIZE);
+                        if (subClass == 0) continue;
+
+                        for (int qy = sy; qy < sy + SUB_BLOCK_SIZE && qy <= maxY; qy += 2) {
+                            for (int qx = sx; qx < sx + SUB_BLOCK_SIZE && qx <= maxX; qx += 2) {
+                                shadeQuad(qx, qy, subClass != 2);
                             }
                         }
                     }
                 }
-                
-                // X轴增量
-                w0 += A0; w1 += A1; w2 += A2;
-                pColor++; pDepth++; pStencil++;
+
+                // 块内有深度写入时重算该块的 Hi-Z (只读写本块，TBR 多线程下按 Tile 隔离)
+                if (blockDepthWritten) updateHiZBlock(bx / BLOCK_SIZE, by / BLOCK_SIZE);
             }
-            // Y轴增量
-            w0_row += B0; w1_row += B1; w2_row += B2;
         }
-    }
 
-    // Helper for LOD calculation
-    // Computes the maximum rate of change (rho) of UV coordinates in screen space
-    inline float computeRho(float z, const Vec4& dUVwDX, const Vec4& dUVwDY, float dZwDX, float dZwDY, float u, float v) {
-        // Chain rule for perspective correct interpolation derivatives:
-        // du/dx = z * ( d(u/w)/dx - u * d(1/w)/dx )
-        float dudx = z * (dUVwDX.x - u * dZwDX);
-        float dvdx = z * (dUVwDX.y - v * dZwDX);
-        float dudy = z * (dUVwDY.x - u * dZwDY);
-        float dvdy = z * (dUVwDY.y - v * dZwDY);
-        
-        // rho = max( length(du/dx, dv/dx), length(du/dy, dv/dy) )
-        // Using squared lengths to avoid one sqrt if possible, but log2 needs linear scale.
-        // sqrt(max(lenSqX, lenSqY))
-        float rhoX2 = dudx*dudx + dvdx*dvdx;
-        float rhoY2 = dudy*dudy + dvdy*dvdy;
-        return std::sqrt(std::max(rhoX2, rhoY2));
+        shader.gl_Derivatives = nullptr;
     }
 
     template <typename ShaderT>
     void rasterizeLineTemplate(ShaderT& shader, const VOut& v0, const VOut& v1) {
-        rasterizeLineTemplate(shader, v0, v1, m_state);
+        flushDeferredDraws(); // 线图元不参与并行分箱，保证与之前的三角形保持顺序
+        rasterizeLineTemplate(shader, v0, v1, m_state, m_fragmentSetup);
     }
 
-    // 模板化的线段光栅化 (Bresenham)
+    // 模板化的线段光栅化：主轴 DDA (Bresenham 误差项选择像素，每步主轴前进一个像素)
+    // t 每步增加 1/steps；屏幕空间中 1/w、窗口深度与 varying/w 都是 t 的线性函数，按步递增，
+    // 逐像素只需一次倒数即可得到透视校正的 Varying
     template <typename ShaderT>
-    void rasterizeLineTemplate(ShaderT& shader, const VOut& v0, const VOut& v1, const RasterState& state) {
+    void rasterizeLineTemplate(ShaderT& shader, const VOut& v0, const VOut& v1, const RasterState& state, const FragmentSetup& setup) {
+        constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        constexpr int kSlots = kVaryings > 0 ? kVaryings : 1;
+
         int x0 = (int)v0.scn.x; int y0 = (int)v0.scn.y;
         int x1 = (int)v1.scn.x; int y1 = (int)v1.scn.y;
 
@@ -797,110 +1670,49 @@ public:
         int sy = y0 < y1 ? 1 : -1;
         int err = dx + dy;
 
-        // 线段长度，用于插值
-        float total_dist = std::sqrt(std::pow((float)x1 - x0, 2) + std::pow((float)y1 - y0, 2));
-        if (total_dist < 1e-5f) total_dist = 1.0f;
-
-        // 视口与裁剪边界
-        int minX = std::max(0, state.viewport.x);
-        int maxX = std::min((int)fbWidth, state.viewport.x + state.viewport.w);
-        int minY = std::max(0, state.viewport.y);
-        int maxY = std::min((int)fbHeight, state.viewport.y + state.viewport.h);
-
-        if (state.scissorTest) {
-            minX = std::max(minX, state.scissor.x);
-            maxX = std::min(maxX, state.scissor.x + state.scissor.w);
-            minY = std::max(minY, state.scissor.y);
-            maxY = std::min(maxY, state.scissor.y + state.scissor.h);
+        // 增量：像素数为 steps + 1
+        const int steps = std::max(dx, -dy);
+        const float dt = steps > 0 ? 1.0f / (float)steps : 0.0f;
+        float zInv = v0.scn.w;
+        float depth = v0.scn.z;
+        const float zInvStep = (v1.scn.w - v0.scn.w) * dt;
+        const float depthStep = (v1.scn.z - v0.scn.z) * dt;
+        Simd4f varW[kSlots], varWStep[kSlots]; // varying * (1/w)
+        for (int k = 0; k < kVaryings; ++k) {
+            Simd4f a = Simd4f::load(v0.ctx.varyings[k]) * Simd4f(v0.scn.w);
+            Simd4f b = Simd4f::load(v1.ctx.varyings[k]) * Simd4f(v1.scn.w);
+            varW[k] = a;
+            varWStep[k] = (b - a) * Simd4f(dt);
         }
 
-        // Optimization: Cache capability flags
-        bool enableDepthTest = state.depthTest;
-        bool enableStencilTest = state.stencilTest;
-        bool enableBlend = state.blendEnabled;
+        const bool earlyDepthReject = earlyDepthRejectEnabled<ShaderT>(state);
+        const DepthStencilView ds = depthStencilView();
+        ShaderContext fsIn;
+        fsIn.rho = 0; // Lines usually don't have well defined Rho without extra math
+        shader.gl_FrontFacing = true;
 
         while (true) {
             // 像素裁剪
-            if (x0 >= minX && x0 < maxX && y0 >= minY && y0 < maxY) {
-                // 计算当前点在 v0->v1 上的插值系数 t
-                float dist = std::sqrt(std::pow((float)x0 - v0.scn.x, 2) + std::pow((float)y0 - v0.scn.y, 2));
-                float t = dist / total_dist;
-                t = std::clamp(t, 0.0f, 1.0f);
-
-                // 透视校正插值 Z (Linear Z in Screen Space is 1/w)
-                // 注意：这里简化处理，严谨的线段透视插值也需要重心坐标逻辑
-                float zInv = v0.scn.w * (1.0f - t) + v1.scn.w * t;
-                
-                if (zInv > 1e-5f) { // 避免除零
-                    float z = 1.0f / zInv; // 恢复真实深度
-                    float fragDepth = v0.scn.z * (1.0f - t) + v1.scn.z * t;
-                    int pix = y0 * fbWidth + x0;
-                    
-                    // 1. Early-Z Optimization
-                    bool earlyZPass = true;
-                    if (enableDepthTest) {
-                        earlyZPass = testDepth(fragDepth, depthBuffer[pix], state);
-                    }
-
-                    if (earlyZPass) {
-                        // 2. Interpolate
-                        ShaderContext fsIn;
-                        fsIn.rho = 0; // Lines usually don't have well defined Rho without extra math
-
-                        float w_t0 = v0.scn.w * (1.0f - t) * z;
-                        float w_t1 = v1.scn.w * t * z;
-
-                        for(int k=0; k<MAX_VARYINGS; ++k) {
-                            fsIn.varyings[k] = v0.ctx.varyings[k] * w_t0 + v1.ctx.varyings[k] * w_t1;
-                        }
-
-                        // 3. Shader
-                        // Setup Builtins
-                        shader.gl_FragCoord = Vec4(x0 + 0.5f, y0 + 0.5f, fragDepth, zInv); 
-                        shader.gl_FrontFacing = true;
-                        shader.gl_Discard = false;
-                        shader.gl_FragDepth.written = false;
-
-                        shader.fragment(fsIn);
-                        Vec4 fColor = shader.gl_FragColor;
-
-                        // 4. Discard & Late-Z
-                        if (!shader.gl_Discard) {
-                            float finalZ = shader.gl_FragDepth.written ? shader.gl_FragDepth.value : fragDepth;
-                            
-                            bool stencilPass = true;
-                            bool depthPass = true;
-
-                            bool needDepthTest = enableDepthTest && shader.gl_FragDepth.written;
-
-                            if (enableStencilTest) {
-                                if (!checkStencil(stencilBuffer[pix], state)) {
-                                    applyStencilOp(state.stencilFail, stencilBuffer[pix], state);
-                                    stencilPass = false;
-                                } else {
-                                    if (needDepthTest && !testDepth(finalZ, depthBuffer[pix], state)) {
-                                        applyStencilOp(state.stencilPassDepthFail, stencilBuffer[pix], state);
-                                        depthPass = false;
-                                    } else {
-                                        applyStencilOp(state.stencilPassDepthPass, stencilBuffer[pix], state);
-                                        depthPass = true;
-                                    }
-                                }
-                            } else {
-                                if (needDepthTest && !testDepth(finalZ, depthBuffer[pix], state)) {
-                                    depthPass = false;
-                                }
-                            }
-
-                            if (stencilPass && depthPass) {
-                                if (state.depthMask) depthBuffer[pix] = finalZ;
-                                if (enableBlend) {
-                                    Vec4 dstColor = ColorUtils::Uint32ToFloat(m_colorBufferPtr[pix]);
-                                    fColor = applyBlending(fColor, dstColor, state);
-                                }
-                                m_colorBufferPtr[pix] = ColorUtils::FloatToUint32(fColor);
-                            }
-                        }
+            if (x0 >= setup.minX && x0 < setup.maxX && y0 >= setup.minY && y0 < setup.maxY && zInv > 1e-5f) {
+                if (m_clearPending) materializeTiles(x0, y0, x0, y0);
+                const size_t pix = m_pixelLayout.index(x0, y0);
+
+                // 1. Early-Z
+                if (!earlyDepthReject || testDepthAnySample(ds, pix, ds.quantize(depth), state)) {
+                    // 2. 透视校正插值
+                    const Simd4f w(1.0f / zInv);
+                    for (int k = 0; k < kVaryings; ++k) (varW[k] * w).store(fsIn.varyings[k]);
+
+                    // 3. Shader
+                    shader.gl_FragCoord = Vec4(x0 + 0.5f, y0 + 0.5f, depth, zInv);
+                    shader.gl_Discard = false;
+                    shader.gl_FragDepth.written = false;
+                    shader.fragment(fsIn);
+
+                    // 4. Discard & Late-Z
+                    if (!shader.gl_Discard) {
+                        float finalZ = shader.gl_FragDepth.written ? shader.gl_FragDepth.value : depth;
+                        mergeFragment(ds, x0, y0, pix, finalZ, earlyDepthReject && !shader.gl_FragDepth.written, shader.gl_FragColor, state, setup);
                     }
                 }
             }
@@ -909,104 +1721,326 @@ public:
             int e2 = 2 * err;
             if (e2 >= dy) { err += dy; x0 += sx; }
             if (e2 <= dx) { err += dx; y0 += sy; }
+            zInv += zInvStep;
+            depth += depthStep;
+            for (int k = 0; k < kVaryings; ++k) varW[k] = varW[k] + varWStep[k];
         }
     }
 
     template <typename ShaderT>
     void rasterizePointTemplate(ShaderT& shader, const VOut& v) {
-        rasterizePointTemplate(shader, v, m_state);
+        flushDeferredDraws();
+        rasterizePointTemplate(shader, v, m_state, m_fragmentSetup);
     }
 
-    // 模板化的点光栅化
+    // 模板化的点光栅化：以 v.scn 为中心、边长为点大小的屏幕对齐正方形 (点精灵)
+    // 像素中心落在 (left, left + size] x (top, top + size] 内即被覆盖 (size = 1 时与取整到中心像素一致)，
+    // 即 x ∈ [floor(left + 0.5), floor(left + size + 0.5))
+    // 点内 Varying 与深度为常量 (取自顶点)；gl_PointCoord 以精灵左上角为 (0, 0)
     template <typename ShaderT>
-    void rasterizePointTemplate(ShaderT& shader, const VOut& v, const RasterState& state) {
-        int x = (int)v.scn.x;
-        int y = (int)v.scn.y;
-
-        // 视口与裁剪边界
-        int minX = std::max(0, state.viewport.x);
-        int maxX = std::min((int)fbWidth, state.viewport.x + state.viewport.w);
-        int minY = std::max(0, state.viewport.y);
-        int maxY = std::min((int)fbHeight, state.viewport.y + state.viewport.h);
+    void rasterizePointTemplate(ShaderT& shader, const VOut& v, const RasterState& state, const FragmentSetup& setup) {
+        const float size = setup.programPointSize ? std::clamp(v.pointSize, 1.0f, MAX_POINT_SIZE) : setup.pointSize;
+        ShaderContext fsIn;
+        if (size == 1.0f) {
+            // 默认的 1 像素点：只覆盖中心所在像素
+            rasterizePointPixel(shader, v, fsIn, state, setup, (int)v.scn.x, (int)v.scn.y, v.scn.x - 0.5f, v.scn.y - 0.5f, 1.0f);
+            return;
+        }
+        const float left = v.scn.x - size * 0.5f;
+        const float top = v.scn.y - size * 0.5f;
+        // 视口下界非负：负坐标上截断与 floor 的差别会被钳制掉，这里直接截断
+        const int minX = std::max(setup.minX, (int)(left + 0.5f));
+        const int maxX = std::min(setup.maxX, (int)(left + size + 0.5f)); // 不包含
+        const int minY = std::max(setup.minY, (int)(top + 0.5f));
+        const int maxY = std::min(setup.maxY, (int)(top + size + 0.5f));
+        if (minX >= maxX || minY >= maxY) return;
+
+        // 单采样、无模板、不写 gl_FragDepth 且至少 4 像素宽：按 4 像素一组处理 (该路径在 Shader 之前做深度测试)
+        if (maxX - minX >= 4 && m_sampleCount == 1 && !state.stencilTest && !shaderWritesFragDepth<ShaderT>()) {
+            rasterizePointSpans4(shader, v, fsIn, state, setup, minX, minY, maxX, maxY, left, top, 1.0f / size);
+            return;
+        }
 
-        if (state.scissorTest) {
-            minX = std::max(minX, state.scissor.x);
-            maxX = std::min(maxX, state.scissor.x + state.scissor.w);
-            minY = std::max(minY, state.scissor.y);
-            maxY = std::min(maxY, state.scissor.y + state.scissor.h);
+        // 窄精灵、MSAA 与模板测试：逐像素走通用的输出合并
+        const float invSize = 1.0f / size;
+        for (int y = minY; y < maxY; ++y) {
+            for (int x = minX; x < maxX; ++x) rasterizePointPixel(shader, v, fsIn, state, setup, x, y, left, top, invSize);
         }
+    }
 
-        // 简单的裁剪检查
-        if (x < minX || x >= maxX || y < minY || y >= maxY) return;
+    // 点精灵的单个像素：Early-Z -> Fragment Shader -> 输出合并
+    template <typename ShaderT>
+    inline void rasterizePointPixel(ShaderT& shader, const VOut& v, ShaderContext& fsIn, const RasterState& state, const FragmentSetup& setup,
+                                    int x, int y, float left, float top, float invSize) {
+        if (x < setup.minX || x >= setup.maxX || y < setup.minY || y >= setup.maxY) return;
+        if (m_clearPending) materializeTiles(x, y, x, y);
+        const size_t pix = m_pixelLayout.index(x, y);
+        const DepthStencilView ds = depthStencilView();
 
-        int pix = y * fbWidth + x;
-        
         // v.scn.z 存储的是 Window Space Z (0-1)
-        float fragDepth = v.scn.z; 
+        const float fragDepth = v.scn.z;
+        const bool earlyDepthReject = earlyDepthRejectEnabled<ShaderT>(state);
+        if (earlyDepthReject && !testDepthAnySample(ds, pix, ds.quantize(fragDepth), state)) return;
+        shader.gl_FrontFacing = true;
+        if (!shadePointFragment(shader, v, fsIn, x, y, left, top, invSize)) return;
+        float finalZ = shader.gl_FragDepth.written ? shader.gl_FragDepth.value : fragDepth;
+        mergeFragment(ds, x, y, pix, finalZ, earlyDepthReject && !shader.gl_FragDepth.written, shader.gl_FragColor, state, setup);
+    }
+
+    // 点精灵的单个片元：填充内建变量并执行 Fragment Shader，返回是否未被 discard
+    // Fragment Shader 可能以非 const 引用接收并修改输入，每个片元都把顶点输出复制到 fsIn (调用方每个点只构造一次)
+    template <typename ShaderT>
+    inline bool shadePointFragment(ShaderT& shader, const VOut& v, ShaderContext& fsIn, int x, int y, float left, float top, float invSize) {
+        constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        for (int k = 0; k < kVaryings; ++k) fsIn.varyings[k] = v.ctx.varyings[k];
+        fsIn.rho = v.ctx.rho; // 顶点阶段输出的 rho 为 0，点没有屏幕空间导数
+        shader.gl_FragCoord = Vec4(x + 0.5f, y + 0.5f, v.scn.z, v.scn.w);
+        shader.gl_PointCoord = Vec2{((float)x + 0.5f - left) * invSize, ((float)y + 0.5f - top) * invSize};
+        shader.gl_Discard = false;
+        shader.gl_FragDepth.written = false;
+        shader.fragment(fsIn);
+        return !shader.gl_Discard;
+    }
+
+    // 点精灵的 4 像素一组路径 (单采样、无模板)：
+    // SIMD 深度测试 (LESS / LEQUAL) -> Fragment Shader -> 定点混合 blendFixed4 一次写回，最后按覆盖的块扩大 Hi-Z
+    template <typename ShaderT>
+    void rasterizePointSpans4(ShaderT& shader, const VOut& v, ShaderContext& fsIn, const RasterState& state, const FragmentSetup& setup,
+                              int minX, int minY, int maxX, int maxY, float left, float top, float invSize) {
+        if (m_clearPending) materializeTiles(minX, minY, maxX - 1, maxY - 1);
+        shader.gl_FrontFacing = true;
+        const DepthStencilView ds = depthStencilView();
+        const float fragDepth = v.scn.z;
+        const float zq = ds.quantize(fragDepth);
+        const Simd4f zq4(zq);
+        const bool depthTest = setup.depthTest && state.depthFunc != GL_ALWAYS;
+        auto depthPassMask = [&](const float* depth, int validMask) {
+            if (state.depthFunc == GL_LESS) return ~(zq4 - Simd4f::load(depth)).geZeroMask() & validMask;
+            if (state.depthFunc == GL_LEQUAL) return (Simd4f::load(depth) - zq4).geZeroMask() & validMask;
+            int mask = 0;
+            for (int i = 0; i < 4; ++i) {
+                if ((validMask >> i & 1) && testDepth(zq, depth[i], state)) mask |= 1 << i;
+            }
+            return mask;
+        };
 
-        // Optimization: Cache capability flags
-        bool enableDepthTest = state.depthTest;
-        bool enableStencilTest = state.stencilTest;
-        bool enableBlend = state.blendEnabled;
+        const uint32_t colorWriteMask = setup.colorWriteMask;
+        const FixedBlendMode fixedBlend = setup.fixedBlend;
+        bool depthWritten = false;
+        for (int y = minY; y < maxY; ++y) {
+            for (int x = minX; x < maxX; x += 4) {
+                const int n = std::min(4, maxX - x);
+                int mask = (1 << n) - 1;
+                size_t pix[4];
+                for (int i = 0; i < n; ++i) pix[i] = m_pixelLayout.index(x + i, y);
+                if (depthTest) {
+                    alignas(16) float depth[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+                    for (int i = 0; i < n; ++i) depth[i] = ds.load(pix[i]);
+                    mask = depthPassMask(depth, mask);
+                    if (!mask) continue;
+                }
+
+                Vec4 colors[4];
+                int writeMask = 0;
+                for (int i = 0; i < n; ++i) {
+                    if (!(mask >> i & 1) || !shadePointFragment(shader, v, fsIn, x + i, y, left, top, invSize)) continue;
+                    if (shader.gl_FragDepth.written) {
+                        // 写了 gl_FragDepth：按最终深度重新测试
+                        mergeFragment(ds, x + i, y, pix[i], shader.gl_FragDepth.value, false, shader.gl_FragColor, state, setup);
+                        continue;
+                    }
+                    colors[i] = shader.gl_FragColor;
+                    writeMask |= 1 << i;
+                }
+                if (!writeMask) continue;
 
-        // 1. Early-Z
-        bool earlyZPass = true;
-        if (enableDepthTest) {
-            earlyZPass = testDepth(fragDepth, depthBuffer[pix], state);
+                if (state.depthMask) {
+                    for (int i = 0; i < n; ++i) {
+                        if (writeMask >> i & 1) ds.store(pix[i], fragDepth);
+                    }
+                    depthWritten = true;
+                }
+                if (!colorWriteMask) continue;
+
+                uint32_t* pColor[4];
+                alignas(16) uint32_t src[4] = {0, 0, 0, 0};
+                alignas(16) uint32_t dst[4] = {0, 0, 0, 0};
+                uint32_t out[4];
+                for (int i = 0; i < n; ++i) {
+                    pColor[i] = m_colorBufferPtr + m_colorLayout.index(x + i, y);
+                    dst[i] = *pColor[i];
+                }
+                if (fixedBlend != FIXED_BLEND_NONE) {
+                    for (int i = 0; i < n; ++i) {
+                        if (writeMask >> i & 1) src[i] = ColorUtils::FloatToUint32(colors[i]);
+                    }
+                    blendFixed4(fixedBlend, src, dst, out);
+                } else {
+                    for (int i = 0; i < n; ++i) {
+                        if (!(writeMask >> i & 1)) continue;
+                        out[i] = state.blendEnabled
+                                     ? ColorUtils::FloatToUint32(applyBlending(colors[i], ColorUtils::Uint32ToFloat(dst[i]), state))
+                                     : ColorUtils::FloatToUint32(colors[i]);
+                    }
+                }
+                for (int i = 0; i < n; ++i) {
+                    if (writeMask >> i & 1) *pColor[i] = maskedColor(out[i], dst[i], colorWriteMask);
+                }
+            }
         }
 
-        if (earlyZPass) {
-            // 2. Setup Context
-            ShaderContext fsIn = v.ctx; 
-            fsIn.rho = 0;
+        // 点内深度为常量：按精灵覆盖的块一次扩大 Hi-Z
+        if (depthWritten) {
+            for (int by = minY / RASTER_BLOCK_SIZE; by <= (maxY - 1) / RASTER_BLOCK_SIZE; ++by) {
+                for (int bx = minX / RASTER_BLOCK_SIZE; bx <= (maxX - 1) / RASTER_BLOCK_SIZE; ++bx) {
+                    float& blockMax = hizBuffer[by * m_hizWidth + bx];
+                    if (zq > blockMax) blockMax = zq;
+                }
+            }
+        }
+    }
+
+    // 执行单个顶点的 Vertex Shader (Fetch -> vertex())
+    template <typename ShaderT>
+    inline void shadeVertex(ShaderT& shader, uint32_t idx, int instanceID, VOut& out) {
+        VertexArrayObject& vao = getVAO();
+
+        // 栈上分配属性数组 (SoA -> AoS for Shader)
+        Vec4 attribs[MAX_ATTRIBS];
+
+        // 收集属性 (手动循环展开或编译器自动优化)
+        // 注意：为了极致性能，这里只应该读取 shader 实际需要的属性
+        // 但通用管线必须遍历 enabled 的属性
+        for (int a = 0; a < MAX_ATTRIBS; ++a) {
+            if (vao.bakedAttributes[a].enabled) {
+                attribs[a] = fetchAttribute(vao.bakedAttributes[a], idx, instanceID);
+            }
+        }
 
-            // 3. Fragment Shader
-            // Setup Builtins
-            shader.gl_FragCoord = Vec4(x + 0.5f, y + 0.5f, fragDepth, v.scn.w); 
-            shader.gl_FrontFacing = true;
-            shader.gl_Discard = false;
-            shader.gl_FragDepth.written = false;
+        // 调用 Shader (传入数组指针)
+        // 如果 Shader 需要 gl_InstanceID，通常需要修改 shader.vertex 签名或者作为 uniform 传入
+        // 这里我们保持接口不变，仅通过 Attribute Divisor 支持 Instancing
+        constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        if constexpr (kVaryings == MAX_VARYINGS) {
+            out.ctx = ShaderContext();
+        } else {
+            out.ctx.rho = 0.0f;
+            for (int v = 0; v < kVaryings; ++v) out.ctx.varyings[v] = Vec4(0, 0, 0, 0);
+        }
+        shader.vertex(attribs, out.ctx);
+        out.pos = shader.gl_Position;
+        out.pointSize = shader.gl_PointSize;
+    }
 
-            shader.fragment(fsIn);
-            Vec4 fColor = shader.gl_FragColor;
+    // 获取变换后的顶点：Indexed Draw 时先查 Post-Transform Cache
+    // 命中则直接拷贝，未命中则直接着色到缓存槽位中
+    template <typename ShaderT>
+    inline void fetchVertex(ShaderT& shader, uint32_t idx, int instanceID, VOut& out) {
+        if (m_vertexCacheActive) {
+            bool hit;
+            VOut& cached = m_vertexCache.slot(idx, instanceID, hit);
+            if (!hit) shadeVertex(shader, idx, instanceID, cached);
+            // 同一图元的顶点可能映射到同一槽位，必须立即拷贝
+            copyVertex<shaderVaryingCount<ShaderT>()>(out, cached);
+            return;
+        }
+        shadeVertex(shader, idx, instanceID, out);
+    }
 
-            // 4. Discard & Late-Z
-            if (!shader.gl_Discard) {
-                float finalZ = shader.gl_FragDepth.written ? shader.gl_FragDepth.value : fragDepth;
+    // 批量执行 Vertex Shader (SoA Fetch -> vertexBatch() -> AoS VOut)
+    // indices[0..count) 的着色结果依次写入 *out[i]
+    template <typename ShaderT>
+    inline void shadeVertexBatch(ShaderT& shader, const uint32_t* indices, int count, int instanceID, VOut* const* out) {
+        VertexArrayObject& vao = getVAO();
 
-                bool stencilPass = true;
-                bool depthPass = true;
+        // 属性打包放在成员中复用，避免每批清零 MAX_ATTRIBS 个 Packet
+        Vec4Packet* attribs = m_batchAttribs;
+        for (int a = 0; a < MAX_ATTRIBS; ++a) {
+            if (vao.bakedAttributes[a].enabled) {
+                fetchAttributePacket(vao.bakedAttributes[a], indices, count, instanceID, attribs[a]);
+            }
+        }
 
-                bool needDepthTest = enableDepthTest && shader.gl_FragDepth.written;
+        VertexBatchContext batch;
+        batch.gl_PointSize = Simd4f(shader.gl_PointSize);
+        shader.vertexBatch(attribs, batch);
+
+        Vec4 lanes[VERTEX_BATCH_SIZE];
+        alignas(16) float pointSizes[VERTEX_BATCH_SIZE];
+        batch.gl_Position.storeAoS(lanes);
+        batch.gl_PointSize.store(pointSizes);
+        for (int i = 0; i < count; ++i) {
+            out[i]->pos = lanes[i];
+            out[i]->ctx.rho = 0.0f;
+            out[i]->pointSize = pointSizes[i];
+        }
+        for (int v = 0; v < shaderVaryingCount<ShaderT>(); ++v) {
+            batch.varyings[v].storeAoS(lanes);
+            for (int i = 0; i < count; ++i) out[i]->ctx.varyings[v] = lanes[i];
+        }
+    }
 
-                if (enableStencilTest) {
-                    if (!checkStencil(stencilBuffer[pix], state)) {
-                        applyStencilOp(state.stencilFail, stencilBuffer[pix], state);
-                        stencilPass = false;
+    // 三角形图元的批量着色路径 (Shader 提供 vertexBatch 时使用)
+    // 每次装配 BATCH_TRIANGLES 个三角形：批内去重 -> 查 Vertex Cache -> 未命中的顶点按 VERTEX_BATCH_SIZE 一批着色
+    // getTriangle(t, idx[3]) 返回第 t 个三角形的顶点索引 (已处理 Strip/Fan 的绕序)
+    template <typename ShaderT, typename TriangleGetterF>
+    inline void drawTrianglesBatched(ShaderT& shader, int triCount, int instanceID, TriangleGetterF getTriangle) {
+        constexpr int BATCH_TRIANGLES = 8;
+        constexpr int BATCH_VERTS = BATCH_TRIANGLES * 3;
+
+        VOut verts[BATCH_VERTS];        // 批内唯一顶点
+        uint32_t vertIndex[BATCH_VERTS];
+        int refs[BATCH_VERTS];          // 三角形顶点 -> verts 下标
+        int missing[BATCH_VERTS];       // 需要着色的 verts 下标
+        constexpr int DEDUP_SIZE = 64;  // 批内去重用的直接映射表 (冲突时只是重复着色，不影响正确性)
+        int8_t dedup[DEDUP_SIZE];
+
+        for (int t0 = 0; t0 < triCount; t0 += BATCH_TRIANGLES) {
+            int nTris = std::min(BATCH_TRIANGLES, triCount - t0);
+            int vertCount = 0;
+            int missCount = 0;
+            std::memset(dedup, -1, sizeof(dedup));
+
+            for (int t = 0; t < nTris; ++t) {
+                uint32_t tri[3];
+                getTriangle(t0 + t, tri);
+                for (int k = 0; k < 3; ++k) {
+                    int8_t& bucket = dedup[tri[k] & (DEDUP_SIZE - 1)];
+                    int slot = (bucket >= 0 && vertIndex[bucket] == tri[k]) ? bucket : -1;
+                    if (slot >= 0) {
+                        if (m_vertexCacheActive) m_vertexCache.recordHit();
                     } else {
-                        if (needDepthTest && !testDepth(finalZ, depthBuffer[pix], state)) {
-                            applyStencilOp(state.stencilPassDepthFail, stencilBuffer[pix], state);
-                            depthPass = false;
-                        } else {
-                            applyStencilOp(state.stencilPassDepthPass, stencilBuffer[pix], state);
-                            depthPass = true;
-                        }
-                    }
-                } else {
-                    if (needDepthTest && !testDepth(finalZ, depthBuffer[pix], state)) {
-                        depthPass = false;
+                        slot = vertCount++;
+                        vertIndex[slot] = tri[k];
+                        bucket = (int8_t)slot;
+                        const VOut* cached = m_vertexCacheActive ? m_vertexCache.find(tri[k], instanceID) : nullptr;
+                        if (cached) copyVertex<shaderVaryingCount<ShaderT>()>(verts[slot], *cached);
+                        else missing[missCount++] = slot;
                     }
+                    refs[t * 3 + k] = slot;
                 }
+            }
 
-                if (stencilPass && depthPass) {
-                    if (state.depthMask) depthBuffer[pix] = finalZ;
-                    if (enableBlend) {
-                        Vec4 dstColor = ColorUtils::Uint32ToFloat(m_colorBufferPtr[pix]);
-                        fColor = applyBlending(fColor, dstColor, state);
+            for (int m = 0; m < missCount; m += VERTEX_BATCH_SIZE) {
+                int n = std::min(VERTEX_BATCH_SIZE, missCount - m);
+                uint32_t idx[VERTEX_BATCH_SIZE];
+                VOut* out[VERTEX_BATCH_SIZE];
+                for (int i = 0; i < n; ++i) {
+                    idx[i] = vertIndex[missing[m + i]];
+                    out[i] = &verts[missing[m + i]];
+                }
+                shadeVertexBatch(shader, idx, n, instanceID, out);
+                if (m_vertexCacheActive) {
+                    for (int i = 0; i < n; ++i) {
+                        copyVertex<shaderVaryingCount<ShaderT>()>(m_vertexCache.insert(idx[i], instanceID), *out[i]);
                     }
-                    m_colorBufferPtr[pix] = ColorUtils::FloatToUint32(fColor);
                 }
             }
+
+            for (int t = 0; t < nTris; ++t) {
+                VOut* triangle[3] = {&verts[refs[t * 3 + 0]], &verts[refs[t * 3 + 1]], &verts[refs[t * 3 + 2]]};
+                processTriangle(shader, triangle);
+            }
         }
     }
 
@@ -1017,52 +2051,69 @@ public:
     // =========================================================
     template <typename ShaderT>
     inline void processTriangleVertices(ShaderT& shader, uint32_t idx0, uint32_t idx1, uint32_t idx2, int instanceID) {
-        VertexArrayObject& vao = getVAO();
         uint32_t indices[3] = {idx0, idx1, idx2};
-        StaticVector<VOut, 16> triangle;
+        VOut triangle[3];
 
-        // 1. Vertex Shader Stage (零堆内存分配)
+        // 1. Vertex Shader Stage (零堆内存分配，Indexed Draw 走 Vertex Cache)
         for (int k = 0; k < 3; ++k) {
-            uint32_t idx = indices[k];
-            
-            // 栈上分配属性数组 (SoA -> AoS for Shader)
-            Vec4 attribs[MAX_ATTRIBS];
-            
-            // 收集属性 (手动循环展开或编译器自动优化)
-            // 注意：为了极致性能，这里只应该读取 shader 实际需要的属性
-            // 但通用管线必须遍历 enabled 的属性
-            for (int a = 0; a < MAX_ATTRIBS; ++a) {
-                if (vao.bakedAttributes[a].enabled) {
-                    attribs[a] = fetchAttribute(vao.bakedAttributes[a], idx, instanceID);
-                }
-            }
+            fetchVertex(shader, indices[k], instanceID, triangle[k]);
+        }
+
+        VOut* triPtrs[3] = {&triangle[0], &triangle[1], &triangle[2]};
+        processTriangle(shader, triPtrs);
+    }
 
-            ShaderContext ctx;
-            // 调用 Shader (传入数组指针)
-            // 如果 Shader 需要 gl_InstanceID，通常需要修改 shader.vertex 签名或者作为 uniform 传入
-            // 这里我们保持接口不变，仅通过 Attribute Divisor 支持 Instancing
-            shader.vertex(attribs, ctx);
-            VOut v = {.pos = shader.gl_Position, .ctx = ctx};
-            triangle.push_back(v);
+    // 三角形的后续阶段 (Clip -> Viewport -> Raster)，triangle 指向 3 个已着色顶点
+    // 未裁剪时会就地写入 scn (只依赖 pos，共享顶点重复写入结果相同)
+    template <typename ShaderT>
+    inline void processTriangle(ShaderT& shader, VOut* const* triangle) {
+        // 2. Clipping Stage
+        // Outcode 快速判定：全部在同一平面外 -> 剔除；全部在视锥内 -> 跳过裁剪
+        uint32_t code0 = computeOutcode(triangle[0]->pos, m_guardBand);
+        uint32_t code1 = computeOutcode(triangle[1]->pos, m_guardBand);
+        uint32_t code2 = computeOutcode(triangle[2]->pos, m_guardBand);
+        if (code0 & code1 & code2 & CLIP_FRUSTUM_MASK) return;
+
+        uint32_t codeOr = code0 | code1 | code2;
+        bool needClip = (codeOr & CLIP_FRUSTUM_MASK) != 0;
+        // Guard Band: 只越过 X/Y 平面时，光栅化器会把包围盒限制在视口/Scissor 内，无需裁剪
+        // (Line/Point 模式仍然裁剪，保证绘制的是可见多边形的轮廓)
+        if (needClip && m_state.polygonMode == GL_FILL &&
+            (codeOr & (CLIP_NEAR | CLIP_FAR | CLIP_GUARD_MASK)) == 0) {
+            needClip = false;
         }
 
-        // 2. Clipping Stage (保持不变)
-        StaticVector<VOut, 16> polygon = triangle;
+        if (!needClip) {
+            rasterizePolygon(shader, triangle, 3);
+            return;
+        }
+
+        // 完整 Sutherland-Hodgman：只处理至少有一个顶点在外的平面
+        // (裁剪结果是原三角形的凸组合，原顶点都在内侧的平面不会被越过)
+        StaticVector<VOut, 16> clipA, clipB;
+        for (int k = 0; k < 3; ++k) clipA.push_back(*triangle[k]);
+        StaticVector<VOut, 16>* src = &clipA;
+        StaticVector<VOut, 16>* dst = &clipB;
         for (int p = 0; p < 6; ++p) {
-            polygon = clipAgainstPlane(polygon, p);
-            if (polygon.empty()) break;
+            if (!(codeOr & (1u << p))) continue;
+            clipAgainstPlane(*src, p, *dst, shaderVaryingCount<ShaderT>());
+            std::swap(src, dst);
+            if (src->empty()) return;
         }
-        if (polygon.empty()) return;
+        VOut* polygon[16];
+        for (size_t k = 0; k < src->size(); ++k) polygon[k] = &(*src)[k];
+        rasterizePolygon(shader, polygon, src->size());
+    }
 
-        // 3. Perspective Division & Viewport Transform
-        for (auto& v : polygon) transformToScreen(v);
+    // 3. Perspective Division & Viewport Transform + 4. Rasterization (根据模式分发)
+    template <typename ShaderT>
+    inline void rasterizePolygon(ShaderT& shader, VOut* const* polygon, size_t count) {
+        for (size_t k = 0; k < count; ++k) transformToScreen(*polygon[k]);
 
-        // 4. Rasterization Stage (根据模式分发)
-        
         if (m_state.polygonMode == GL_FILL) {
             // 三角形化处理裁剪后的多边形 (Triangle Fan)
-            for (size_t k = 1; k < polygon.size() - 1; ++k) {
-                rasterizeTriangleTemplate(shader, polygon[0], polygon[k], polygon[k+1]);
+            for (size_t k = 1; k < count - 1; ++k) {
+                rasterizeTriangleTemplate(shader, *polygon[0], *polygon[k], *polygon[k+1]);
             }
         } 
         else if (m_state.polygonMode == GL_LINE) {
@@ -1070,82 +2121,134 @@ public:
             // 注意：这里我们绘制的是裁剪后多边形的边缘
             // 对于一个三角形，如果不被裁剪，就是 3 条边
             // 如果被裁剪成多边形，这里会画出多边形的轮廓
-            for (size_t k = 0; k < polygon.size(); ++k) {
-                const VOut& vStart = polygon[k];
-                const VOut& vEnd   = polygon[(k + 1) % polygon.size()];
+            for (size_t k = 0; k < count; ++k) {
+                const VOut& vStart = *polygon[k];
+                const VOut& vEnd   = *polygon[(k + 1) % count];
                 rasterizeLineTemplate(shader, vStart, vEnd);
             }
         }
         else if (m_state.polygonMode == GL_POINT) {
             // 点模式
-            for (const auto& v : polygon) {
-                rasterizePointTemplate(shader, v);
+            for (size_t k = 0; k < count; ++k) {
+                rasterizePointTemplate(shader, *polygon[k]);
             }
         }
     }
 
-    // 处理单个点 (Vertex -> Clip -> Raster)
+    // 着色 indices[0..count) 到 out[0..count)
+    // Indexed Draw 先查 Vertex Cache；Shader 支持 vertexBatch() 时未命中的顶点按 VERTEX_BATCH_SIZE 一批着色
     template <typename ShaderT>
-    inline void processPointVertex(ShaderT& shader, uint32_t idx, int instanceID) {
-        VertexArrayObject& vao = getVAO();
-        
-        // 1. Vertex Shader
-        Vec4 attribs[MAX_ATTRIBS];
-        for (int a = 0; a < MAX_ATTRIBS; ++a) {
-            if (vao.bakedAttributes[a].enabled) {
-                attribs[a] = fetchAttribute(vao.bakedAttributes[a], idx, instanceID);
+    inline void shadeVertexRun(ShaderT& shader, const uint32_t* indices, int count, int instanceID, VOut* out) {
+        constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        if constexpr (kHasVertexBatch<ShaderT>) {
+            uint32_t idx[VERTEX_BATCH_SIZE];
+            VOut* dst[VERTEX_BATCH_SIZE];
+            int n = 0;
+            auto shadePending = [&] {
+                shadeVertexBatch(shader, idx, n, instanceID, dst);
+                if (m_vertexCacheActive) {
+                    for (int i = 0; i < n; ++i) copyVertex<kVaryings>(m_vertexCache.insert(idx[i], instanceID), *dst[i]);
+                }
+                n = 0;
+            };
+            for (int i = 0; i < count; ++i) {
+                const VOut* cached = m_vertexCacheActive ? m_vertexCache.find(indices[i], instanceID) : nullptr;
+                if (cached) {
+                    copyVertex<kVaryings>(out[i], *cached);
+                    continue;
+                }
+                idx[n] = indices[i];
+                dst[n] = &out[i];
+                if (++n == VERTEX_BATCH_SIZE) shadePending();
             }
+            if (n) shadePending();
+        } else {
+            for (int i = 0; i < count; ++i) fetchVertex(shader, indices[i], instanceID, out[i]);
         }
-        ShaderContext ctx;
-        shader.vertex(attribs, ctx);
-        VOut v = {.pos = shader.gl_Position, .ctx = ctx};
+    }
 
-        // 2. Clipping (Points)
-        // 简单的视锥体剔除: -w <= x,y,z <= w
-        if (std::abs(v.pos.x) > v.pos.w || 
-            std::abs(v.pos.y) > v.pos.w || 
-            std::abs(v.pos.z) > v.pos.w) return;
+    // GL_LINES / GL_LINE_STRIP / GL_LINE_LOOP (Vertex -> Clip -> Raster)
+    // 顶点按批着色，条带中共享的顶点只执行一次 Vertex Shader、Outcode 与屏幕变换；
+    // 两端都在视锥内的线段跳过 clipLine (Liang-Barsky)，并行刷新与逐 Draw 状态每个 Draw 只处理一次
+    template <typename ShaderT, typename IndexGetterF>
+    inline void drawLinesBatched(ShaderT& shader, GLenum mode, GLsizei count, int instanceID, IndexGetterF getIndex) {
+        constexpr int kVaryings = shaderVaryingCount<ShaderT>();
+        constexpr int BATCH_VERTS = 32; // 偶数：GL_LINES 的一对顶点不会跨批
+        if (count < 2) return;
+        flushDeferredDraws(); // 线图元不参与并行分箱，保证与之前的三角形保持顺序
+
+        const bool strip = mode != GL_LINES;
+        const int vertexCount = strip ? count : (count & ~1);
+        VOut verts[BATCH_VERTS + 1]; // 条带：verts[0] 为上一批的最后一个顶点
+        uint32_t codes[BATCH_VERTS + 1];
+        VOut first;                  // GL_LINE_LOOP 的闭合边
+        uint32_t firstCode = 0;
+
+        auto drawLine = [&](const VOut& a, uint32_t codeA, const VOut& b, uint32_t codeB) {
+            if (codeA & codeB) return; // 两端在同一裁剪平面外侧
+            if (!(codeA | codeB)) {
+                rasterizeLineTemplate(shader, a, b, m_state, m_fragmentSetup);
+                return;
+            }
+            StaticVector<VOut, 16> clipped = clipLine(a, b, kVaryings);
+            if (clipped.count < 2) return;
+            transformToScreen(clipped[0]);
+            transformToScreen(clipped[1]);
+            rasterizeLineTemplate(shader, clipped[0], clipped[1], m_state, m_fragmentSetup);
+        };
 
-        // 3. Transform
-        transformToScreen(v);
+        int carry = 0;
+        for (int base = 0; base < vertexCount; base += BATCH_VERTS) {
+            const int n = std::min(BATCH_VERTS, vertexCount - base);
+            uint32_t indices[BATCH_VERTS];
+            for (int i = 0; i < n; ++i) indices[i] = getIndex(base + i);
+            shadeVertexRun(shader, indices, n, instanceID, verts + carry);
+
+            // 视锥内的顶点直接做屏幕变换；视锥外的顶点由 clipLine 生成新的端点
+            const int total = carry + n;
+            for (int i = carry; i < total; ++i) {
+                codes[i] = computeOutcode(verts[i].pos, m_guardBand) & CLIP_FRUSTUM_MASK;
+                if (!codes[i]) transformToScreen(verts[i]);
+            }
 
-        // 4. Rasterize
-        rasterizePointTemplate(shader, v);
+            if (!strip) {
+                for (int i = 0; i + 1 < total; i += 2) drawLine(verts[i], codes[i], verts[i + 1], codes[i + 1]);
+                continue;
+            }
+            if (base == 0 && mode == GL_LINE_LOOP) {
+                copyVertex<kVaryings>(first, verts[0]);
+                firstCode = codes[0];
+            }
+            for (int i = 0; i + 1 < total; ++i) drawLine(verts[i], codes[i], verts[i + 1], codes[i + 1]);
+            copyVertex<kVaryings>(verts[0], verts[total - 1]);
+            codes[0] = codes[total - 1];
+            carry = 1;
+        }
+        if (mode == GL_LINE_LOOP) drawLine(verts[0], codes[0], first, firstCode);
     }
 
-    // 处理单条线 (Vertex -> Clip -> Raster)
-    template <typename ShaderT>
-    inline void processLineVertices(ShaderT& shader, uint32_t idx0, uint32_t idx1, int instanceID) {
-        VertexArrayObject& vao = getVAO();
-        uint32_t indices[2] = {idx0, idx1};
-        VOut verts[2];
-
-        // 1. Vertex Shader
-        for(int i=0; i<2; ++i) {
-            Vec4 attribs[MAX_ATTRIBS];
-            for (int a = 0; a < MAX_ATTRIBS; ++a) {
-                if (vao.bakedAttributes[a].enabled) {
-                    attribs[a] = fetchAttribute(vao.bakedAttributes[a], indices[i], instanceID);
-                }
+    // GL_POINTS：顶点按 BATCH_VERTS 个一批着色 (Vertex Cache + vertexBatch())，
+    // 之后逐点做中心裁剪、屏幕变换与点精灵光栅化
+    template <typename ShaderT, typename IndexGetterF>
+    inline void drawPointsBatched(ShaderT& shader, GLsizei count, int instanceID, IndexGetterF getIndex) {
+        constexpr int BATCH_VERTS = 32;
+        flushDeferredDraws(); // 点图元不参与并行分箱，保证与之前的三角形保持顺序
+
+        VOut verts[BATCH_VERTS];
+        uint32_t indices[BATCH_VERTS];
+        for (int base = 0; base < count; base += BATCH_VERTS) {
+            const int n = std::min(BATCH_VERTS, (int)count - base);
+            for (int i = 0; i < n; ++i) indices[i] = getIndex(base + i);
+            shadeVertexRun(shader, indices, n, instanceID, verts);
+
+            for (int i = 0; i < n; ++i) {
+                VOut& v = verts[i];
+                // 点按中心做视锥体剔除 (-w <= x,y,z <= w)；越过视口边缘的大点在光栅化时按像素裁剪
+                if (std::abs(v.pos.x) > v.pos.w || std::abs(v.pos.y) > v.pos.w || std::abs(v.pos.z) > v.pos.w) continue;
+                transformToScreen(v);
+                rasterizePointTemplate(shader, v, m_state, m_fragmentSetup);
             }
-            ShaderContext ctx;
-            shader.vertex(attribs, ctx);
-            verts[i].pos = shader.gl_Position;
-            verts[i].ctx = ctx;
         }
-
-        // 2. Clipping (Lines)
-        // 使用 Liang-Barsky 算法裁剪线段
-        // 注意：clipLine 返回的是 StaticVector，可能包含 0 个或 2 个顶点
-        StaticVector<VOut, 16> clipped = clipLine(verts[0], verts[1]);
-        if (clipped.count < 2) return;
-
-        // 3. Transform
-        transformToScreen(clipped[0]);
-        transformToScreen(clipped[1]);
-
-        // 4. Rasterize
-        rasterizeLineTemplate(shader, clipped[0], clipped[1]);
     }
 
     // 通用图元组装函数
@@ -1155,58 +2258,64 @@ public:
     inline void drawTopology(ShaderT& shader, GLenum mode, GLsizei count, int instanceID, IndexGetterF getIndex) {
         switch (mode) {
             case GL_POINTS: {
-                for (int i = 0; i < count; ++i) {
-                    processPointVertex(shader, getIndex(i), instanceID);
-                }
-                break;
-            }
-            case GL_LINES: {
-                for (int i = 0; i < count; i += 2) {
-                    if (i + 1 >= count) break;
-                    processLineVertices(shader, getIndex(i), getIndex(i+1), instanceID);
-                }
-                break;
-            }
-            case GL_LINE_STRIP: {
-                if (count < 2) break;
-                for (int i = 0; i < count - 1; ++i) {
-                    processLineVertices(shader, getIndex(i), getIndex(i+1), instanceID);
-                }
+                drawPointsBatched(shader, count, instanceID, getIndex);
                 break;
             }
+            case GL_LINES:
+            case GL_LINE_STRIP:
             case GL_LINE_LOOP: {
-                if (count < 2) break;
-                for (int i = 0; i < count - 1; ++i) {
-                    processLineVertices(shader, getIndex(i), getIndex(i+1), instanceID);
-                }
-                processLineVertices(shader, getIndex(count-1), getIndex(0), instanceID);
+                drawLinesBatched(shader, mode, count, instanceID, getIndex);
                 break;
             }
             case GL_TRIANGLES: {
-                for (int i = 0; i < count; i += 3) {
-                    if (i + 2 >= count) break;
-                    processTriangleVertices(shader, getIndex(i), getIndex(i+1), getIndex(i+2), instanceID);
+                if constexpr (kHasVertexBatch<ShaderT>) {
+                    drawTrianglesBatched(shader, count / 3, instanceID, [&](int t, uint32_t* tri) {
+                        tri[0] = getIndex(t * 3);
+                        tri[1] = getIndex(t * 3 + 1);
+                        tri[2] = getIndex(t * 3 + 2);
+                    });
+                } else {
+                    for (int i = 0; i < count; i += 3) {
+                        if (i + 2 >= count) break;
+                        processTriangleVertices(shader, getIndex(i), getIndex(i+1), getIndex(i+2), instanceID);
+                    }
                 }
                 break;
             }
             case GL_TRIANGLE_STRIP: {
                 if (count < 3) break;
-                for (int i = 0; i < count - 2; ++i) {
-                    uint32_t idx0 = getIndex(i);
-                    uint32_t idx1 = getIndex(i+1);
-                    uint32_t idx2 = getIndex(i+2);
-                    if (i % 2 == 0)
-                        processTriangleVertices(shader, idx0, idx1, idx2, instanceID);
-                    else
-                        processTriangleVertices(shader, idx0, idx2, idx1, instanceID);
+                if constexpr (kHasVertexBatch<ShaderT>) {
+                    drawTrianglesBatched(shader, count - 2, instanceID, [&](int i, uint32_t* tri) {
+                        tri[0] = getIndex(i);
+                        tri[1] = getIndex((i % 2 == 0) ? i + 1 : i + 2);
+                        tri[2] = getIndex((i % 2 == 0) ? i + 2 : i + 1);
+                    });
+                } else {
+                    for (int i = 0; i < count - 2; ++i) {
+                        uint32_t idx0 = getIndex(i);
+                        uint32_t idx1 = getIndex(i+1);
+                        uint32_t idx2 = getIndex(i+2);
+                        if (i % 2 == 0)
+                            processTriangleVertices(shader, idx0, idx1, idx2, instanceID);
+                        else
+                            processTriangleVertices(shader, idx0, idx2, idx1, instanceID);
+                    }
                 }
                 break;
             }
             case GL_TRIANGLE_FAN: {
                 if (count < 3) break;
                 uint32_t centerIdx = getIndex(0);
-                for (int i = 1; i < count - 1; ++i) {
-                    processTriangleVertices(shader, centerIdx, getIndex(i), getIndex(i+1), instanceID);
+                if constexpr (kHasVertexBatch<ShaderT>) {
+                    drawTrianglesBatched(shader, count - 2, instanceID, [&](int i, uint32_t* tri) {
+                        tri[0] = centerIdx;
+                        tri[1] = getIndex(i + 1);
+                        tri[2] = getIndex(i + 2);
+                    });
+                } else {
+                    for (int i = 1; i < count - 1; ++i) {
+                        processTriangleVertices(shader, centerIdx, getIndex(i), getIndex(i+1), instanceID);
+                    }
                 }
                 break;
             }
@@ -1218,7 +2327,7 @@ public:
     void glDrawArrays(ShaderT& shader, GLenum mode, GLint first, GLsizei count) {
         if (count <= 0) return;
         
-        prepareDraw();
+        if (!prepareDraw()) return;
 
         // 定义 getter: 索引就是 first + i
         auto linearIndexGetter = [&](int i) -> uint32_t {
@@ -1233,7 +2342,7 @@ public:
     void glDrawArraysInstanced(ShaderT& shader, GLenum mode, GLint first, GLsizei count, GLsizei primcount) {
         if (count <= 0 || primcount <= 0) return;
         
-        prepareDraw();
+        if (!prepareDraw()) return;
 
         auto linearIndexGetter = [&](int i) -> uint32_t {
             return (uint32_t)(first + i);
@@ -1264,7 +2373,7 @@ public:
     void glDrawElementsInstanced(ShaderT& shader, GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount) {
         if (count == 0 || instanceCount == 0) return;
         
-        prepareDraw();
+        if (!prepareDraw()) return;
 
         size_t indexSize = getIndexTypeSize(type);
         if (indexSize == 0) {
@@ -1316,17 +2425,27 @@ public:
         };
 
         // 3. 循环实例并调用通用逻辑
+        // Uniform 可能在两次 Draw 之间改变，缓存只在单个 Draw Call 内有效
+        // Key 包含 instanceID，Instance 之间不会误命中
+        m_vertexCache.invalidate();
+        m_vertexCacheActive = m_vertexCacheEnabled;
         for (GLsizei instanceID = 0; instanceID < instanceCount; ++instanceID) {
             drawTopology(shader, mode, count, instanceID, getIndex);
         }
+        m_vertexCacheActive = false;
     }
 
     void savePPM(const char* filename) {
+        flushDeferredDraws();
+        // 保存默认帧缓冲 (FBO 绑定期间其尺寸保存在 m_defaultSurface 中)
+        GLsizei w = m_boundFramebuffer ? m_defaultSurface.width : fbWidth;
+        GLsizei h = m_boundFramebuffer ? m_defaultSurface.height : fbHeight;
+        storeColorBuffer();
         FILE* f = fopen(filename, "wb");
         if(!f) return;
-        fprintf(f, "P6\n%d %d\n255\n", fbWidth, fbHeight);
-        for(int i=0; i<fbWidth*fbHeight; ++i) {
-            uint32_t p = colorBuffer[i];
+        fprintf(f, "P6\n%d %d\n255\n", w, h);
+        for(int i=0; i<w*h; ++i) {
+            uint32_t p = m_presentBufferPtr[i];
             uint8_t buf[3] = { (uint8_t)(p&0xFF), (uint8_t)((p>>8)&0xFF), (uint8_t)((p>>16)&0xFF) };
             fwrite(buf, 1, 3, f);
         }
@@ -285,8 +285,15 @@ bool AssetManager::LoadTextureBin(uint32_t index, const fs::path& path) {
     std::vector<unsigned char> data(dataSize);
     in.read(reinterpret_cast<char*>(data.data()), dataSize);
 
-    // Create Texture via RHI
-    rhi::TextureHandle handle = m_device->CreateTexture(data.data(), texHeader.width, texHeader.height, 4);
+    // Create Texture via RHI (compressed payloads carry their own mip chain)
+    rhi::TextureHandle handle;
+    const auto format = static_cast<rhi::TextureFormat>(texHeader.format);
+    if (format == rhi::TextureFormat::RGBA8) {
+        handle = m_device->CreateTexture(data.data(), texHeader.width, texHeader.height, 4);
+    } else {
+        handle = m_device->CreateCompressedTexture(data.data(), texHeader.width, texHeader.height, texHeader.mipLevels, format);
+        if (!handle.IsValid()) return false;
+    }
     
     m_texturePool[index].asset.rhiHandle = handle;
     m_texturePool[index].asset.width = texHeader.width;
@@ -87,11 +87,13 @@ static void PushQuad(mu_Rect dst, mu_Rect src, mu_Color color) {
 // --- Shader Definition ---
 
 struct UIShader : public tinygl::ShaderBuiltins {
+    static constexpr int kVaryings = 2; // Color, UV
+
     // Uniforms
     Mat4 projection;
     
-    // Resources
-    const TextureObject* texture = nullptr;
+    // Resources: the atlas is an R8 texture left at the default sampling parameters
+    Sampler<GL_NEAREST_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT, GL_R8> atlas;
 
     void BindUniforms(const uint8_t* data, size_t size) {
         if (size >= sizeof(Mat4)) {
@@ -100,7 +102,7 @@ struct UIShader : public tinygl::ShaderBuiltins {
     }
     
     void BindResources(SoftRenderContext& ctx) {
-        texture = ctx.getTexture(0);
+        atlas.bind(ctx.getTexture(0));
     }
     
     void vertex(const Vec4* attribs, ShaderContext& ctx) {
@@ -118,14 +120,26 @@ struct UIShader : public tinygl::ShaderBuiltins {
         ctx.varyings[1] = attribs[1]; // UV
     }
 
+    // 批量版本：一次变换 4 个顶点 (SoA)
+    void vertexBatch(const Vec4Packet* attribs, VertexBatchContext& ctx) {
+        Vec4Packet pos(attribs[0].x, attribs[0].y, Simd4f(0.0f), Simd4f(1.0f));
+
+        SimdMat4 proj;
+        proj.load(projection);
+        ctx.gl_Position = proj.transformPacket(pos);
+
+        ctx.varyings[0] = attribs[2]; // Color
+        ctx.varyings[1] = attribs[1]; // UV
+    }
+
     void fragment(const ShaderContext& ctx) {
         Vec4 color = ctx.varyings[0];
         Vec4 uv = ctx.varyings[1];
         
         // Sample texture 0 (Atlas is R8)
         float alpha = 1.0f;
-        if (texture) {
-            Vec4 texColor = texture->sample(uv.x, uv.y, ctx.rho);
+        if (atlas) {
+            Vec4 texColor = atlas.sample(uv.x, uv.y, ctx.rho);
             // Alpha is in Red channel for R8 texture
             alpha = texColor.x;
         }
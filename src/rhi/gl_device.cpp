@@ -1,6 +1,7 @@
 #include <third_party/glad/glad.h>
 #include <rhi/gl_device.h>
 #include <rhi/shader_registry.h>
+#include <tinygl/core/texture_codec.h>
 #include <iostream>
 #include <cstring>
 #include <algorithm>
@@ -129,6 +130,33 @@ namespace {
         }
         return program;
     }
+
+    GLenum ToGLCompressedFormat(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::BC1:        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case TextureFormat::BC3:        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case TextureFormat::ETC2_RGB8:  return GL_COMPRESSED_RGB8_ETC2;
+            case TextureFormat::ETC2_RGBA8: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+            default: return 0;
+        }
+    }
+
+    // UpdateTexture pixels (1 / 3 / 4 channels) to RGBA8 for the block encoder, like tinygl's convertToInternalFormat.
+    void ExpandToRGBA8(const void* pixelData, int width, int height, int channels, std::vector<uint32_t>& rgba) {
+        const size_t count = (size_t)width * height;
+        rgba.resize(count);
+        const uint8_t* src = static_cast<const uint8_t*>(pixelData);
+        if (channels == 4) {
+            std::memcpy(rgba.data(), src, count * 4);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t r = src[i * channels];
+            const uint32_t g = channels == 3 ? src[i * 3 + 1] : 0;
+            const uint32_t b = channels == 3 ? src[i * 3 + 2] : 0;
+            rgba[i] = 0xFF000000u | (b << 16) | (g << 8) | r; // AABBGGRR
+        }
+    }
 } // namespace
 
 GLDevice::GLDevice() {
@@ -147,7 +175,7 @@ GLDevice::GLDevice() {
 GLDevice::~GLDevice() {
     if (m_globalUBO) glDeleteBuffers(1, &m_globalUBO);
     for (auto& pair : m_buffers) glDeleteBuffers(1, &pair.second.id);
-    for (auto& pair : m_textures) glDeleteTextures(1, &pair.second);
+    for (auto& pair : m_textures) glDeleteTextures(1, &pair.second.id);
     for (auto& pair : m_pipelines) {
         glDeleteVertexArrays(1, &pair.second.vao);
     }
@@ -227,13 +255,86 @@ TextureHandle GLDevice::CreateTexture(const void* pixelData, int width, int heig
     if (pixelData) glGenerateMipmap(GL_TEXTURE_2D);
 
     uint32_t handle = m_nextTextureHandle++;
-    m_textures[handle] = id;
+    m_textures[handle] = {id, 0, width, height, pixelData != nullptr};
     return {handle};
 }
 
+TextureHandle GLDevice::CreateCompressedTexture(const void* blockData, int width, int height, int mipLevels, TextureFormat format) {
+    const GLenum glFormat = ToGLCompressedFormat(format);
+    if (glFormat == 0) {
+        std::cerr << "GLDevice: Unsupported compressed texture format " << (uint32_t)format << std::endl;
+        return {0};
+    }
+
+    GLuint id;
+    glGenTextures(1, &id);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, id);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(0, mipLevels - 1));
+
+    // Drivers cannot generate mipmaps for compressed formats; upload the cooked chain level by level.
+    const uint8_t* src = static_cast<const uint8_t*>(blockData);
+    int w = width, h = height;
+    for (int level = 0; level < mipLevels; ++level) {
+        const GLsizei size = (GLsizei)(tinygl::textureImageWords(glFormat, w, h) * sizeof(uint32_t));
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, w, h, 0, size, src);
+        src += size;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+
+    uint32_t handle = m_nextTextureHandle++;
+    m_textures[handle] = {id, glFormat, width, height, mipLevels > 1};
+    return {handle};
+}
+
+void GLDevice::UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const void* pixelData, int channels) {
+    if (!m_textures.count(handle.id) || !pixelData) return;
+    const TextureMeta& meta = m_textures[handle.id];
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, meta.id);
+
+    if (meta.compressedFormat) {
+        // Same rules as SoftDevice: drivers cannot rebuild a compressed chain, and the rect must cover whole 4x4 blocks.
+        if (meta.hasMips) {
+            std::cerr << "GLDevice: UpdateTexture cannot update a compressed texture with mip levels" << std::endl;
+            return;
+        }
+        if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > meta.width || y + height > meta.height ||
+            (x | y) & 3 || ((width & 3) && x + width != meta.width) || ((height & 3) && y + height != meta.height)) {
+            std::cerr << "GLDevice: UpdateTexture on a compressed texture requires a region aligned to 4x4 blocks" << std::endl;
+            return;
+        }
+        // Encode on the CPU with the same codec the soft backend uses.
+        std::vector<uint32_t> rgba;
+        ExpandToRGBA8(pixelData, width, height, channels, rgba);
+        std::vector<uint32_t> blocks(tinygl::textureImageWords(meta.compressedFormat, width, height));
+        tinygl::encodeTextureImage(meta.compressedFormat, rgba.data(), width, height, blocks.data());
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, meta.compressedFormat,
+                                  (GLsizei)(blocks.size() * sizeof(uint32_t)), blocks.data());
+        return;
+    }
+
+    GLenum format = GL_RGBA;
+    if (channels == 3) format = GL_RGB;
+    else if (channels == 1) format = GL_RED;
+
+    // Rows are tightly packed; the default 4-byte alignment misreads odd-width RED / RGB rects.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, pixelData);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // Only keep an existing chain in sync, as SoftDevice does.
+    if (meta.hasMips) glGenerateMipmap(GL_TEXTURE_2D);
+}
+
 void GLDevice::DestroyTexture(TextureHandle handle) {
     if (m_textures.count(handle.id)) {
-        GLuint id = m_textures[handle.id];
+        GLuint id = m_textures[handle.id].id;
         glDeleteTextures(1, &id);
         m_textures.erase(handle.id);
     }
@@ -350,6 +451,12 @@ void GLDevice::Submit(const CommandBuffer& buffer) {
                         } else {
                             glDisable(GL_BLEND);
                         }
+
+                        // Color Write Mask
+                        glColorMask((desc.colorWriteMask & ColorWriteRed) ? GL_TRUE : GL_FALSE,
+                                    (desc.colorWriteMask & ColorWriteGreen) ? GL_TRUE : GL_FALSE,
+                                    (desc.colorWriteMask & ColorWriteBlue) ? GL_TRUE : GL_FALSE,
+                                    (desc.colorWriteMask & ColorWriteAlpha) ? GL_TRUE : GL_FALSE);
                     }
                 }
                 break;
@@ -377,7 +484,7 @@ void GLDevice::Submit(const CommandBuffer& buffer) {
                 const auto* pkt = reinterpret_cast<const PacketSetTexture*>(ptr);
                 glActiveTexture(GL_TEXTURE0 + pkt->slot);
                 if (m_textures.count(pkt->handle.id)) {
-                    glBindTexture(GL_TEXTURE_2D, m_textures[pkt->handle.id]);
+                    glBindTexture(GL_TEXTURE_2D, m_textures[pkt->handle.id].id);
                 } else {
                     glBindTexture(GL_TEXTURE_2D, 0);
                 }
@@ -510,6 +617,7 @@ void GLDevice::Submit(const CommandBuffer& buffer) {
                  if (pkt->colorLoadOp == LoadAction::Clear) {
                     glClearColor(pkt->clearColor[0], pkt->clearColor[1], pkt->clearColor[2], pkt->clearColor[3]);
                     mask |= GL_COLOR_BUFFER_BIT;
+                    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE); // Ensure we can write to color buffer
                  }
                  if (pkt->depthLoadOp == LoadAction::Clear) {
                     glClearDepth(pkt->clearDepth);
@@ -87,6 +87,61 @@ TextureHandle SoftDevice::CreateTexture(const void* pixelData, int width, int he
     return {id};
 }
 
+TextureHandle SoftDevice::CreateCompressedTexture(const void* blockData, int width, int height, int mipLevels, TextureFormat format) {
+    GLenum glFormat = 0;
+    switch (format) {
+        case TextureFormat::BC1: glFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+        case TextureFormat::BC3: glFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+        case TextureFormat::ETC2_RGB8: glFormat = GL_COMPRESSED_RGB8_ETC2; break;
+        case TextureFormat::ETC2_RGBA8: glFormat = GL_COMPRESSED_RGBA8_ETC2_EAC; break;
+        default:
+            LOG_ERROR("CreateCompressedTexture: Unsupported texture format " + std::to_string((uint32_t)format));
+            return {0};
+    }
+
+    TextureRes res;
+    res.owned = true;
+    m_ctx.glGenTextures(1, &res.glId);
+    m_ctx.glBindTexture(GL_TEXTURE_2D, res.glId);
+
+    // 块数据直接作为纹理存储，按层依次上传 (Level 0 在前)
+    const uint8_t* src = static_cast<const uint8_t*>(blockData);
+    int w = width, h = height;
+    for (int level = 0; level < mipLevels; ++level) {
+        const GLsizei size = (GLsizei)(tinygl::textureImageWords(glFormat, w, h) * sizeof(uint32_t));
+        m_ctx.glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, w, h, 0, size, src);
+        src += size;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+
+    uint32_t id = m_textures.Allocate(std::move(res));
+    return {id};
+}
+
+void SoftDevice::UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const void* pixelData, int channels) {
+    TextureRes* res = m_textures.Get(handle.id);
+    if (!res) return;
+
+    GLenum format = GL_RGBA;
+    if (channels == 3) format = GL_RGB;
+    else if (channels == 1) format = GL_RED;
+
+    const TextureObject* tex = m_ctx.getTextureObject(res->glId);
+    if (!tex) return;
+    // 与 GLDevice 一致：压缩纹理只能在没有 Mipmap 链时更新 (GL 无法为压缩格式重建 Mipmap)
+    if (tinygl::isCompressedTextureFormat(tex->format) && tex->mipLevels.size() > 1) {
+        LOG_ERROR("UpdateTexture: Compressed textures with mip levels cannot be updated");
+        return;
+    }
+
+    m_ctx.glBindTexture(GL_TEXTURE_2D, res->glId);
+    // 压缩纹理由 glTexSubImage2D 按块重新编码，区域需按 4x4 块对齐 (到达层级边缘的除外)
+    m_ctx.glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, pixelData);
+    // 已有 Mipmap 链时只重建改写区域的足迹
+    if (tex->mipLevels.size() > 1) m_ctx.glGenerateMipmap(GL_TEXTURE_2D);
+}
+
 TextureHandle SoftDevice::CreateTextureFromNative(GLuint glTextureId) {
     TextureRes res;
     res.glId = glTextureId;
@@ -326,6 +381,7 @@ void SoftDevice::Submit(const CommandBuffer& buffer) {
                  if (pkt->colorLoadOp == LoadAction::Clear) {
                     m_ctx.glClearColor(pkt->clearColor[0], pkt->clearColor[1], pkt->clearColor[2], pkt->clearColor[3]);
                     mask |= GL_COLOR_BUFFER_BIT;
+                    m_ctx.glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE); // Ensure we can write to color buffer
                  }
                  if (pkt->depthLoadOp == LoadAction::Clear) {
                     m_ctx.glClearDepth(pkt->clearDepth);
@@ -352,7 +408,7 @@ void SoftDevice::Submit(const CommandBuffer& buffer) {
             }
 
             case CommandType::EndPass: {
-                 // Store actions would go here (e.g., resolving MSAA, flushing to memory)
+                 // Store actions: MSAA resolve 在 Phase 2 光栅化完成后统一执行
                  break;
             }
             
@@ -410,6 +466,10 @@ void SoftDevice::Submit(const CommandBuffer& buffer) {
             }
         }
     });
+
+    // --- Phase 3: Store (MSAA Resolve / 分块帧缓冲线性化) ---
+    // Phase 2 绕过了 glDraw*，这里强制执行一次 Store
+    m_ctx.storeColorBuffer(true);
 }
 
 void SoftDevice::Present() {
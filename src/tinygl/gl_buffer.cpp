@@ -303,9 +303,21 @@ void SoftRenderContext::glVertexAttribDivisor(GLuint index, GLuint divisor) {
     }
 }
 
-void SoftRenderContext::prepareDraw() {
+bool SoftRenderContext::prepareDraw() {
+    if (m_boundFramebuffer) {
+        if (!refreshFramebufferAttachment()) {
+            LOG_WARN("Draw skipped: bound framebuffer " + std::to_string(m_boundFramebuffer) + " is incomplete.");
+            return false;
+        }
+        framebuffers.get(m_boundFramebuffer)->dirty = true;
+    }
+    m_deferredDrawOpen = false; // 并行模式：每个 Draw Call 单独录制 Shader 拷贝与状态快照
+    updateFragmentSetup();      // 线/点光栅化的裁剪矩形、颜色掩码与混合模式
+    if (m_sampleCount > 1) m_resolvePending = true; // MSAA：呈现前需要 resolve
+    else if (m_tiledFramebuffer && !m_boundFramebuffer) m_linearizePending = true; // 分块布局：呈现前需要线性化
+
     VertexArrayObject& vao = getVAO();
-    if (!vao.isDirty) return;
+    if (!vao.isDirty) return true;
 
     for (int i = 0; i < MAX_ATTRIBS; ++i) {
         VertexAttribFormat& fmt = vao.attributes[i];
@@ -349,6 +361,7 @@ void SoftRenderContext::prepareDraw() {
     }
     
     vao.isDirty = false;
+    return true;
 }
 
 Vec4 SoftRenderContext::fetchAttribute(const ResolvedAttribute& attr, int vertexIdx, int instanceIdx) {
@@ -403,4 +416,66 @@ Vec4 SoftRenderContext::fetchAttribute(const ResolvedAttribute& attr, int vertex
     return Vec4(raw[0], raw[1], raw[2], raw[3]);
 }
 
-}
\ No newline at end of file
+void SoftRenderContext::fetchAttributePacket(const ResolvedAttribute& attr, const uint32_t* indices, int count, int instanceIdx, Vec4Packet& out) {
+    if (!attr.enabled || !attr.basePointer || count <= 0) {
+        out = Vec4Packet::broadcast(Vec4(0, 0, 0, 1));
+        return;
+    }
+
+    // 先按 AoS 读出每个 lane，再一次性转置为 SoA；类型/分量数判断提到 lane 循环之外
+    size_t elementSize = (attr.type == GL_UNSIGNED_BYTE) ? sizeof(uint8_t) : sizeof(float);
+    size_t readSize = attr.size * elementSize;
+
+    // 1. 解析每个 lane 的源地址 (不足一批时重复最后一个顶点，越界的 lane 为 nullptr)
+    const uint8_t* srcs[VERTEX_BATCH_SIZE];
+    for (int i = 0; i < VERTEX_BATCH_SIZE; ++i) {
+        int lane = std::min(i, count - 1);
+        int effectiveIdx = (attr.divisor == 0) ? (int)indices[lane] : (instanceIdx / (int)attr.divisor);
+        const uint8_t* src = attr.basePointer + (size_t)effectiveIdx * attr.stride;
+        if (src < attr.basePointer || src + readSize > attr.limitPointer) {
+            LOG_ERROR("fetchAttributePacket OOB: idx=" + std::to_string(effectiveIdx) +
+                      " inst=" + std::to_string(instanceIdx));
+            src = nullptr;
+        }
+        srcs[i] = src;
+    }
+
+    // 2. 按类型与分量数读取 (分量数为编译期常量，memcpy 会被内联为定长拷贝)
+    Vec4 lanes[VERTEX_BATCH_SIZE];
+    auto gatherFloat = [&](auto components) {
+        constexpr int N = decltype(components)::value;
+        for (int i = 0; i < VERTEX_BATCH_SIZE; ++i) {
+            lanes[i] = Vec4(0, 0, 0, 1);
+            if (srcs[i]) std::memcpy(&lanes[i].x, srcs[i], N * sizeof(float));
+        }
+    };
+
+    switch (attr.type) {
+        case GL_FLOAT: {
+            switch (attr.size) {
+                case 4:  gatherFloat(std::integral_constant<int, 4>{}); break;
+                case 3:  gatherFloat(std::integral_constant<int, 3>{}); break;
+                case 2:  gatherFloat(std::integral_constant<int, 2>{}); break;
+                default: gatherFloat(std::integral_constant<int, 1>{}); break;
+            }
+            break;
+        }
+        case GL_UNSIGNED_BYTE: {
+            float scale = attr.normalized ? 255.0f : 1.0f;
+            for (int i = 0; i < VERTEX_BATCH_SIZE; ++i) {
+                uint8_t ubyte_raw[4] = {0, 0, 0, 255};
+                if (srcs[i]) std::memcpy(ubyte_raw, srcs[i], attr.size * sizeof(uint8_t));
+                else ubyte_raw[3] = (uint8_t)scale; // 越界时返回 (0,0,0,1)
+                lanes[i] = Vec4(ubyte_raw[0] / scale, ubyte_raw[1] / scale, ubyte_raw[2] / scale, ubyte_raw[3] / scale);
+            }
+            break;
+        }
+        default:
+            out = Vec4Packet::broadcast(Vec4(0, 0, 0, 1));
+            return;
+    }
+
+    out = Vec4Packet::loadAoS(lanes);
+}
+
+}
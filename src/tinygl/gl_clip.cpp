@@ -2,9 +2,10 @@
 
 namespace tinygl {
 
- StaticVector<VOut, 16> SoftRenderContext::clipAgainstPlane(const StaticVector<VOut, 16>& inputVerts, int planeID) {
-    StaticVector<VOut, 16> outputVerts;
-    if (inputVerts.empty()) return outputVerts;
+void SoftRenderContext::clipAgainstPlane(const StaticVector<VOut, 16>& inputVerts, int planeID, StaticVector<VOut, 16>& outputVerts,
+                                         int varyingCount) {
+    outputVerts.clear();
+    if (inputVerts.empty()) return;
 
     // Lambda: 判断点是否在平面内 (Inside Test)
     // OpenGL Frustum Planes based on w:
@@ -49,7 +50,7 @@ namespace tinygl {
                 // 情况 1: Out -> In (外部进入内部)
                 // 需要在交点处生成新顶点，并加入
                 float t = getIntersectT(prev->pos, curr.pos);
-                outputVerts.push_back(lerpVertex(*prev, curr, t));
+                outputVerts.push_back(lerpVertex(*prev, curr, t, varyingCount));
             }
             // 情况 2: In -> In (一直在内部)
             // 直接加入当前点
@@ -58,15 +59,13 @@ namespace tinygl {
             // 情况 3: In -> Out (内部跑到外部)
             // 需要在交点处生成新顶点，并加入
             float t = getIntersectT(prev->pos, curr.pos);
-            outputVerts.push_back(lerpVertex(*prev, curr, t));
+            outputVerts.push_back(lerpVertex(*prev, curr, t, varyingCount));
         }
         // 情况 4: Out -> Out (一直在外部)，直接丢弃
 
         prev = &curr;
         prevInside = currInside;
     }
-
-    return outputVerts;
 }
 
 
@@ -86,27 +85,28 @@ bool SoftRenderContext::clipLineAxis(float p, float q, float& t0, float& t1) {
     return true;
 }
 
-StaticVector<VOut, 16> SoftRenderContext::clipLine(const VOut& v0, const VOut& v1) {
+StaticVector<VOut, 16> SoftRenderContext::clipLine(const VOut& v0, const VOut& v1, int varyingCount) {
     float t0 = 0.0f, t1 = 1.0f;
     Vec4 d = v1.pos - v0.pos;
 
     // Clip against 6 planes of the canonical view volume
-    if (!clipLineAxis( d.x + d.w, -(v0.pos.x + v0.pos.w), t0, t1)) return {}; // Left
-    if (!clipLineAxis(-d.x + d.w,  (v0.pos.x - v0.pos.w), t0, t1)) return {}; // Right
-    if (!clipLineAxis( d.y + d.w, -(v0.pos.y + v0.pos.w), t0, t1)) return {}; // Bottom
-    if (!clipLineAxis(-d.y + d.w,  (v0.pos.y - v0.pos.w), t0, t1)) return {}; // Top
-    if (!clipLineAxis( d.z + d.w, -(v0.pos.z + v0.pos.w), t0, t1)) return {}; // Near
-    if (!clipLineAxis(-d.z + d.w,  (v0.pos.z - v0.pos.w), t0, t1)) return {}; // Far
+    // Liang-Barsky 形式 p * t <= q：例如 Left 平面 x + w >= 0 -> -(d.x + d.w) * t <= v0.x + v0.w
+    if (!clipLineAxis(-(d.x + d.w), v0.pos.x + v0.pos.w, t0, t1)) return {}; // Left
+    if (!clipLineAxis(  d.x - d.w,  v0.pos.w - v0.pos.x, t0, t1)) return {}; // Right
+    if (!clipLineAxis(-(d.y + d.w), v0.pos.y + v0.pos.w, t0, t1)) return {}; // Bottom
+    if (!clipLineAxis(  d.y - d.w,  v0.pos.w - v0.pos.y, t0, t1)) return {}; // Top
+    if (!clipLineAxis(-(d.z + d.w), v0.pos.z + v0.pos.w, t0, t1)) return {}; // Near
+    if (!clipLineAxis(  d.z - d.w,  v0.pos.w - v0.pos.z, t0, t1)) return {}; // Far
 
     StaticVector<VOut, 16> clippedVerts;
     if (t0 > 0.0f) {
-        clippedVerts.push_back(lerpVertex(v0, v1, t0));
+        clippedVerts.push_back(lerpVertex(v0, v1, t0, varyingCount));
     } else {
         clippedVerts.push_back(v0);
     }
 
     if (t1 < 1.0f) {
-        clippedVerts.push_back(lerpVertex(v0, v1, t1));
+        clippedVerts.push_back(lerpVertex(v0, v1, t1, varyingCount));
     } else {
         clippedVerts.push_back(v1);
     }
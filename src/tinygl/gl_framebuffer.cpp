@@ -0,0 +1,191 @@
+#include <tinygl/tinygl.h>
+
+namespace tinygl {
+
+// ==========================================
+// Framebuffer Objects
+// ==========================================
+
+void SoftRenderContext::glGenFramebuffers(GLsizei n, GLuint* ids) {
+    for (GLsizei i = 0; i < n; ++i) {
+        ids[i] = framebuffers.allocate();
+    }
+}
+
+void SoftRenderContext::glDeleteFramebuffers(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; ++i) {
+        GLuint id = ids[i];
+        if (id == 0 || !framebuffers.isActive(id)) continue;
+        // 删除当前绑定的 FBO 时回退到默认帧缓冲 (与 OpenGL 语义一致)
+        if (id == m_boundFramebuffer) glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        framebuffers.release(id);
+    }
+}
+
+void SoftRenderContext::swapSurface(FramebufferSurface& surface) {
+    std::swap(fbWidth, surface.width);
+    std::swap(fbHeight, surface.height);
+    std::swap(m_colorBufferPtr, surface.color);
+    std::swap(m_colorLayout, surface.colorLayout);
+    std::swap(m_pixelLayout, surface.pixelLayout);
+    std::swap(m_depthFormat, surface.depthFormat);
+    depthBuffer.swap(surface.depth);
+    depthBuffer24.swap(surface.depth24);
+    depthBuffer16.swap(surface.depth16);
+    stencilBuffer.swap(surface.stencil);
+    hizBuffer.swap(surface.hiz);
+    std::swap(m_hizWidth, surface.hizWidth);
+    std::swap(m_hizHeight, surface.hizHeight);
+    std::swap(m_sampleCount, surface.sampleCount);
+    m_sampleColorBuffer.swap(surface.sampleColor);
+    std::swap(m_resolvePending, surface.resolvePending);
+    m_clearTiles.swap(surface.clearTiles);
+    std::swap(m_clearTilesX, surface.clearTilesX);
+    std::swap(m_clearTilesY, surface.clearTilesY);
+    std::swap(m_clearPending, surface.clearPending);
+}
+
+void SoftRenderContext::allocateSurface(GLsizei w, GLsizei h) {
+    fbWidth = w;
+    fbHeight = h;
+    m_sampleCount = 1;
+    std::vector<uint32_t>().swap(m_sampleColorBuffer);
+    m_resolvePending = false;
+    m_pixelLayout = m_tiledFramebuffer ? SurfaceLayout::Tiled(w, FRAMEBUFFER_TILE_SHIFT) : SurfaceLayout::Linear(w);
+    allocateDepthStencil(m_pixelLayout.size(h));
+    m_hizWidth = (w + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+    m_hizHeight = (h + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+    hizBuffer.assign((size_t)m_hizWidth * m_hizHeight, depthStencilView().quantize(m_state.clearDepth));
+    resetClearTiles();
+    if (m_parallelRaster) m_parallelTiler.Init(fbWidth, fbHeight, PARALLEL_TILE_SIZE);
+}
+
+void SoftRenderContext::setTiledFramebufferEnabled(bool enabled) {
+    if (m_boundFramebuffer) {
+        LOG_WARN("setTiledFramebufferEnabled: bind framebuffer 0 first.");
+        return;
+    }
+    if (enabled == m_tiledFramebuffer) return;
+    flushDeferredDraws();
+    materializeAllTiles();
+    storeColorBuffer(); // 呈现缓冲与当前颜色一致
+
+    m_colorLayout = enabled ? SurfaceLayout::Tiled(fbWidth, FRAMEBUFFER_TILE_SHIFT) : SurfaceLayout::Linear(fbWidth);
+    m_pixelLayout = m_colorLayout;
+    m_tiledFramebuffer = enabled;
+    if (enabled) {
+        m_tiledColorBuffer.assign(m_colorLayout.size(fbHeight), COLOR_BLACK);
+        m_colorBufferPtr = m_tiledColorBuffer.data();
+        linearizeColorBuffer(false); // 保留已有内容
+    } else {
+        std::vector<uint32_t>().swap(m_tiledColorBuffer);
+        m_colorBufferPtr = m_presentBufferPtr;
+    }
+
+    // 深度/模板与多重采样颜色按新布局重新分配 (与 setSampleCount 一致)
+    if (m_sampleCount > 1) fillSamplesFromColor();
+    allocateDepthStencil(m_pixelLayout.size(fbHeight) * m_sampleCount);
+    std::fill(hizBuffer.begin(), hizBuffer.end(), depthStencilView().quantize(m_state.clearDepth));
+}
+
+void SoftRenderContext::glBindFramebuffer(GLenum target, GLuint framebuffer) {
+    if (target != GL_FRAMEBUFFER && target != GL_DRAW_FRAMEBUFFER) {
+        LOG_WARN("glBindFramebuffer: Only GL_FRAMEBUFFER / GL_DRAW_FRAMEBUFFER are supported.");
+        return;
+    }
+    if (framebuffer == m_boundFramebuffer) return;
+    if (framebuffer != 0 && !framebuffers.isActive(framebuffer)) {
+        // 与 glBindTexture 一致：绑定时补建
+        framebuffers.forceAllocate(framebuffer);
+    }
+    flushDeferredDraws();
+
+    // 1. 换出当前绘制目标
+    if (m_boundFramebuffer == 0) {
+        // 默认帧缓冲在 FBO 绑定期间不会被绘制，提前 resolve / 线性化以便 getColorBuffer 直接返回
+        storeColorBuffer();
+        swapSurface(m_defaultSurface);
+    } else {
+        FramebufferObject* prev = framebuffers.get(m_boundFramebuffer);
+        materializeAllTiles(); // 颜色附件即将作为纹理被采样
+        swapSurface(prev->surface);
+        if (prev->autoMipmap && prev->dirty && prev->colorLevel == 0) {
+            if (TextureObject* tex = textures.get(prev->colorTexture)) generateTextureMipmaps(tex);
+        }
+        prev->dirty = false;
+    }
+
+    // 2. 换入新的绘制目标
+    m_boundFramebuffer = framebuffer;
+    if (framebuffer == 0) {
+        swapSurface(m_defaultSurface);
+    } else {
+        swapSurface(framebuffers.get(framebuffer)->surface);
+        refreshFramebufferAttachment();
+    }
+    if (m_parallelRaster) m_parallelTiler.Init(fbWidth, fbHeight, PARALLEL_TILE_SIZE);
+}
+
+void SoftRenderContext::glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+    if (target != GL_FRAMEBUFFER && target != GL_DRAW_FRAMEBUFFER) return;
+    if (m_boundFramebuffer == 0) {
+        LOG_ERROR("glFramebufferTexture2D: No framebuffer object bound.");
+        return;
+    }
+    if (attachment != GL_COLOR_ATTACHMENT0) {
+        LOG_WARN("glFramebufferTexture2D: Only GL_COLOR_ATTACHMENT0 is supported (depth/stencil are allocated internally).");
+        return;
+    }
+    if (texture != 0 && textarget != GL_TEXTURE_2D) {
+        LOG_WARN("glFramebufferTexture2D: Only GL_TEXTURE_2D is supported.");
+        return;
+    }
+    flushDeferredDraws();
+    materializeAllTiles(); // 待定的清除属于旧附件
+
+    FramebufferObject* fb = framebuffers.get(m_boundFramebuffer);
+    fb->colorTexture = texture;
+    fb->colorLevel = level;
+    fb->dirty = false;
+    if (!refreshFramebufferAttachment()) {
+        LOG_WARN("glFramebufferTexture2D: Framebuffer " + std::to_string(m_boundFramebuffer) + " is incomplete.");
+    }
+}
+
+GLenum SoftRenderContext::glCheckFramebufferStatus(GLenum target) {
+    if (target != GL_FRAMEBUFFER && target != GL_DRAW_FRAMEBUFFER) return 0;
+    if (m_boundFramebuffer == 0) return GL_FRAMEBUFFER_COMPLETE;
+    const FramebufferObject* fb = framebuffers.get(m_boundFramebuffer);
+    if (fb->colorTexture == 0) return GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT;
+    return refreshFramebufferAttachment() ? GL_FRAMEBUFFER_COMPLETE : GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT;
+}
+
+void SoftRenderContext::setFramebufferAutoMipmap(GLuint framebuffer, bool enabled) {
+    if (FramebufferObject* fb = framebuffers.get(framebuffer)) fb->autoMipmap = enabled;
+}
+
+bool SoftRenderContext::refreshFramebufferAttachment() {
+    FramebufferObject* fb = framebuffers.get(m_boundFramebuffer);
+    TextureObject* tex = fb ? textures.get(fb->colorTexture) : nullptr;
+    if (!tex || fb->colorLevel < 0 || fb->colorLevel >= (GLint)tex->mipLevels.size()) {
+        m_colorBufferPtr = nullptr;
+        return false;
+    }
+
+    const TextureObject::MipLevelInfo& info = tex->mipLevels[fb->colorLevel];
+    if (info.width <= 0 || info.height <= 0 || tex->format != GL_RGBA8) { // 只有 RGBA8 纹理可作为渲染目标
+        m_colorBufferPtr = nullptr;
+        return false;
+    }
+    // 附件尺寸变化 (首次附加或纹理被重新定义) 时重新分配深度/模板
+    if (info.width != fbWidth || info.height != fbHeight) {
+        allocateSurface(info.width, info.height);
+        m_colorLayout = SurfaceLayout::Tiled4x4(info.width);
+    }
+    // 纹理存储可能因 glTexImage2D / generateMipmaps 重新分配，每次都重新取地址
+    m_colorBufferPtr = tex->data.data() + info.offset;
+    tex->mipChainValid = false; // 渲染直接改写附件层级，之后的 generateMipmaps 需整链重建
+    return true;
+}
+
+}
@@ -2,78 +2,308 @@
 
 namespace tinygl {
 
+namespace {
+uint32_t toUnorm(float v, float range) {
+    return (uint32_t)(std::clamp(v, 0.0f, 1.0f) * range + 0.5f);
+}
+
+// 将颜色按非压缩存储格式写入一个 texel (定点格式钳制到 [0, 1] 并四舍五入)
+void storeTexel(GLenum format, uint8_t* dst, const Vec4& c) {
+    switch (format) {
+        case GL_RGBA8: {
+            const uint32_t p = (toUnorm(c.w, 255.0f) << 24) | (toUnorm(c.z, 255.0f) << 16) |
+                               (toUnorm(c.y, 255.0f) << 8) | toUnorm(c.x, 255.0f);
+            std::memcpy(dst, &p, 4);
+            break;
+        }
+        case GL_R8:
+            dst[0] = (uint8_t)toUnorm(c.x, 255.0f);
+            break;
+        case GL_RG8:
+            dst[0] = (uint8_t)toUnorm(c.x, 255.0f);
+            dst[1] = (uint8_t)toUnorm(c.y, 255.0f);
+            break;
+        case GL_RGB565: {
+            const uint16_t p = (uint16_t)((toUnorm(c.x, 31.0f) << 11) | (toUnorm(c.y, 63.0f) << 5) | toUnorm(c.z, 31.0f));
+            std::memcpy(dst, &p, 2);
+            break;
+        }
+        case GL_RGBA4: {
+            const uint16_t p = (uint16_t)((toUnorm(c.x, 15.0f) << 12) | (toUnorm(c.y, 15.0f) << 8) |
+                                          (toUnorm(c.z, 15.0f) << 4) | toUnorm(c.w, 15.0f));
+            std::memcpy(dst, &p, 2);
+            break;
+        }
+        case GL_R16F: {
+            const uint16_t h = floatToHalf(c.x);
+            std::memcpy(dst, &h, 2);
+            break;
+        }
+        case GL_R32F:
+            std::memcpy(dst, &c.x, 4);
+            break;
+        default:
+            break;
+    }
+}
+
+// 4x4 分块布局中 (x, y) 的 texel 序号：块起点 + 块内 (ly * 4 + lx)
+size_t tiledTexelIndex(int x, int y, int blocksPerRow) {
+    return ((size_t)(y >> 2) * blocksPerRow + (x >> 2)) * 16 + ((y & 3) << 2) + (x & 3);
+}
+
+// sRGB <-> 线性查表：解码按 8-bit 取值，编码按 12-bit 量化的线性值
+struct SRGBTables {
+    float toLinear[256];
+    uint8_t fromLinear[4096];
+};
+
+const SRGBTables& srgbTables() {
+    static const SRGBTables tables = [] {
+        SRGBTables t;
+        for (int i = 0; i < 256; ++i) {
+            const float c = i / 255.0f;
+            t.toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < 4096; ++i) {
+            const float l = i / 4095.0f;
+            const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            t.fromLinear[i] = (uint8_t)toUnorm(c, 255.0f);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// 4 个 RGBA8 texel 的平均值 (四舍五入)；sRGB 模式下 RGB 在线性空间平均，Alpha 始终线性
+uint32_t averageRGBA8(uint32_t a, uint32_t b, uint32_t c, uint32_t d, bool srgb) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const uint32_t ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF, cc = (c >> shift) & 0xFF, cd = (d >> shift) & 0xFF;
+        uint32_t avg;
+        if (srgb && shift < 24) {
+            const SRGBTables& t = srgbTables();
+            const float l = (t.toLinear[ca] + t.toLinear[cb] + t.toLinear[cc] + t.toLinear[cd]) * 0.25f;
+            avg = t.fromLinear[(int)(l * 4095.0f + 0.5f)];
+        } else {
+            avg = (ca + cb + cc + cd + 2) >> 2;
+        }
+        result |= avg << shift;
+    }
+    return result;
+}
+
+// 由源层相邻的 2x2 个 4x4 块 (8x8 texel) 生成目标层一个 4x4 块：src = 左上、右上、左下、右下
+// 目标 texel (lx, ly) 取源 (2lx, 2ly) 起的 2x2，逐通道 16-bit 累加后四舍五入，结果与 averageRGBA8 (非 sRGB) 一致
+SIMD_INLINE void downsampleBlockRGBA8(const uint32_t* const src[4], uint32_t* dst) {
+    for (int ly = 0; ly < 4; ++ly) {
+        const uint32_t* left = src[(ly >> 1) * 2] + ((ly & 1) * 8);
+        const uint32_t* right = src[(ly >> 1) * 2 + 1] + ((ly & 1) * 8);
+#if defined(__ARM_NEON) || defined(__aarch64__)
+        auto halfRow = [](const uint32_t* rows) {
+            const uint8x16_t r0 = vreinterpretq_u8_u32(vld1q_u32(rows));
+            const uint8x16_t r1 = vreinterpretq_u8_u32(vld1q_u32(rows + 4));
+            const uint16x8_t lo = vaddl_u8(vget_low_u8(r0), vget_low_u8(r1));   // texel 0, 1
+            const uint16x8_t hi = vaddl_u8(vget_high_u8(r0), vget_high_u8(r1)); // texel 2, 3
+            const uint16x8_t sum = vaddq_u16(vcombine_u16(vget_low_u16(lo), vget_low_u16(hi)),
+                                             vcombine_u16(vget_high_u16(lo), vget_high_u16(hi)));
+            return vrshrn_n_u16(sum, 2);
+        };
+        vst1q_u32(dst + ly * 4, vreinterpretq_u32_u8(vcombine_u8(halfRow(left), halfRow(right))));
+#elif defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+        auto halfRow = [](const uint32_t* rows) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows));
+            const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + 4));
+            const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero)); // texel 0, 1
+            const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero)); // texel 2, 3
+            const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+            return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+        };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ly * 4), _mm_packus_epi16(halfRow(left), halfRow(right)));
+#else
+        for (int lx = 0; lx < 4; ++lx) {
+            const uint32_t* rows = lx < 2 ? left : right;
+            const int i = (lx & 1) * 2;
+            dst[ly * 4 + lx] = averageRGBA8(rows[i], rows[i + 1], rows[i + 4], rows[i + 5], false);
+        }
+#endif
+    }
+}
+
+// RGBA8：由上一层重建 level 层的块 [bx0, bx1) x [by0, by1)
+// 完全位于图像内部的块 (源 8x8 也都在图像内) 走 SIMD 整块路径，边缘块逐 texel 钳制坐标 (块内超出图像的部分复制边缘像素)
+void downsampleBlocksRGBA8(TextureObject& tex, int level, int bx0, int by0, int bx1, int by1) {
+    const TextureObject::MipLevelInfo src = tex.mipLevels[level - 1];
+    const TextureObject::MipLevelInfo dst = tex.mipLevels[level];
+    const int srcBlocksPerRow = (src.width + 3) / 4;
+    const int dstBlocksPerRow = (dst.width + 3) / 4;
+    const uint32_t* srcBase = tex.data.data() + src.offset;
+    uint32_t* dstBase = tex.data.data() + dst.offset;
+    const bool srgb = tex.srgbMipmaps;
+    const bool wholeSource = src.width >= 2 && src.height >= 2;
+
+    for (int by = by0; by < by1; ++by) {
+        for (int bx = bx0; bx < bx1; ++bx) {
+            uint32_t* out = dstBase + ((size_t)by * dstBlocksPerRow + bx) * 16;
+            if (!srgb && wholeSource && bx * 4 + 4 <= dst.width && by * 4 + 4 <= dst.height) {
+                const uint32_t* top = srcBase + ((size_t)(by * 2) * srcBlocksPerRow + bx * 2) * 16;
+                const uint32_t* bottom = top + (size_t)srcBlocksPerRow * 16;
+                const uint32_t* const quad[4] = {top, top + 16, bottom, bottom + 16};
+                downsampleBlockRGBA8(quad, out);
+                continue;
+            }
+            for (int ly = 0; ly < 4; ++ly) {
+                const int sy0 = std::min(by * 4 + ly, dst.height - 1) * 2;
+                const int sy1 = std::min(sy0 + 1, src.height - 1);
+                for (int lx = 0; lx < 4; ++lx) {
+                    const int sx0 = std::min(bx * 4 + lx, dst.width - 1) * 2;
+                    const int sx1 = std::min(sx0 + 1, src.width - 1);
+                    out[ly * 4 + lx] = averageRGBA8(srcBase[tiledTexelIndex(sx0, sy0, srcBlocksPerRow)],
+                                                    srcBase[tiledTexelIndex(sx1, sy0, srcBlocksPerRow)],
+                                                    srcBase[tiledTexelIndex(sx0, sy1, srcBlocksPerRow)],
+                                                    srcBase[tiledTexelIndex(sx1, sy1, srcBlocksPerRow)], srgb);
+                }
+            }
+        }
+    }
+}
+
+// 其余格式：由上一层 2x2 Box Filter 重建 level 层的块 [bx0, bx1) x [by0, by1)，经浮点取数 / 写回
+// 压缩格式先按 RGBA8 写入暂存块再逐块编码 (块内超出图像的部分复制边缘像素，避免填充值拉偏端点)
+void downsampleBlocks(TextureObject& tex, int level, int bx0, int by0, int bx1, int by1) {
+    const TextureObject::MipLevelInfo src = tex.mipLevels[level - 1];
+    const TextureObject::MipLevelInfo dst = tex.mipLevels[level];
+    const bool compressed = isCompressedTextureFormat(tex.format);
+    const GLenum texelFormat = compressed ? GL_RGBA8 : tex.format;
+    const int texelBytes = textureTexelBytes(texelFormat);
+    const int blocksPerRow = (dst.width + 3) / 4;
+    const bool srgb = tex.srgbMipmaps && compressed;
+
+    uint32_t staging[16];
+    for (int by = by0; by < by1; ++by) {
+        for (int bx = bx0; bx < bx1; ++bx) {
+            uint8_t* out = compressed ? reinterpret_cast<uint8_t*>(staging)
+                                      : reinterpret_cast<uint8_t*>(tex.data.data() + dst.offset) + ((size_t)by * blocksPerRow + bx) * 16 * texelBytes;
+            for (int i = 0; i < 16; ++i) {
+                const int srcX = std::min(bx * 4 + (i & 3), dst.width - 1) * 2;
+                const int srcY = std::min(by * 4 + (i >> 2), dst.height - 1) * 2;
+                const int srcX1 = std::min(srcX + 1, src.width - 1);
+                const int srcY1 = std::min(srcY + 1, src.height - 1);
+                Vec4 c00 = getTexelRaw(tex, level - 1, srcX, srcY);
+                Vec4 c10 = getTexelRaw(tex, level - 1, srcX1, srcY);
+                Vec4 c01 = getTexelRaw(tex, level - 1, srcX, srcY1);
+                Vec4 c11 = getTexelRaw(tex, level - 1, srcX1, srcY1);
+                if (srgb) {
+                    auto pack = [](const Vec4& c) {
+                        return (toUnorm(c.w, 255.0f) << 24) | (toUnorm(c.z, 255.0f) << 16) | (toUnorm(c.y, 255.0f) << 8) | toUnorm(c.x, 255.0f);
+                    };
+                    staging[i] = averageRGBA8(pack(c00), pack(c10), pack(c01), pack(c11), true);
+                    continue;
+                }
+                storeTexel(texelFormat, out + i * texelBytes, (c00 + c10 + c01 + c11) * 0.25f);
+            }
+            if (compressed) {
+                encodeTextureBlock(tex.format, staging,
+                                   tex.data.data() + dst.offset + ((size_t)by * blocksPerRow + bx) * textureBlockWords(tex.format));
+            }
+        }
+    }
+}
+
+// 重建 level 层覆盖 [x0, x1) x [y0, y1) 的所有 4x4 块，区域扩展到块边界后写回 (整块重建后块内所有 texel 都可能变化)
+// 较大的区域按块行分带交给 JobSystem：每带只写本层自己的块、只读上一层，各带之间无重叠
+void downsampleRegion(TextureObject& tex, int level, int& x0, int& y0, int& x1, int& y1, JobSystem* jobs) {
+    const TextureObject::MipLevelInfo& dst = tex.mipLevels[level];
+    const int bx0 = x0 / 4, by0 = y0 / 4, bx1 = (x1 + 3) / 4, by1 = (y1 + 3) / 4;
+    auto run = [&](int bandBy0, int bandBy1) {
+        if (tex.format == GL_RGBA8) downsampleBlocksRGBA8(tex, level, bx0, bandBy0, bx1, bandBy1);
+        else downsampleBlocks(tex, level, bx0, bandBy0, bx1, bandBy1);
+    };
+
+    const int bands = (by1 - by0 + TextureObject::MIPMAP_BAND_BLOCK_ROWS - 1) / TextureObject::MIPMAP_BAND_BLOCK_ROWS;
+    if (jobs && bands > 1 && (size_t)(bx1 - bx0) * (by1 - by0) * 16 >= TextureObject::MIPMAP_PARALLEL_MIN_TEXELS) {
+        jobs->ParallelFor(0, bands, [&](int band) {
+            const int bandBy0 = by0 + band * TextureObject::MIPMAP_BAND_BLOCK_ROWS;
+            run(bandBy0, std::min(by1, bandBy0 + TextureObject::MIPMAP_BAND_BLOCK_ROWS));
+        });
+    } else {
+        run(by0, by1);
+    }
+    if (isCompressedTextureFormat(tex.format)) invalidateDecodedBlocks(); // 该层块内容已改变，按地址缓存的解码结果失效
+
+    x0 = bx0 * 4;
+    y0 = by0 * 4;
+    x1 = std::min(bx1 * 4, dst.width);
+    y1 = std::min(by1 * 4, dst.height);
+}
+}
 
 // ==========================================
 // TextureObject
 // ==========================================
 
-void TextureObject::generateMipmaps() {
+void TextureObject::generateMipmaps(JobSystem* jobs) {
     if (mipLevels.empty()) return;
-    
-    int currentLevel = 0;
-    while (true) {
-        int srcW = mipLevels[currentLevel].width;
-        int srcH = mipLevels[currentLevel].height;
-
-        if (srcW <= 1 && srcH <= 1) break;
-
-        int nextW = std::max(1, srcW / 2);
-        int nextH = std::max(1, srcH / 2);
-        
-        // Calculate size for Tiled Storage (aligned to 4x4)
-        int blocksX = (nextW + 3) / 4;
-        int blocksY = (nextH + 3) / 4;
-        size_t nextSize = blocksX * blocksY * 16;
-        
-        size_t newOffset = data.size();
-        data.resize(newOffset + nextSize);
-        
-        // Push back first
-        mipLevels.push_back({newOffset, nextW, nextH});
-
-        uint32_t* dstPtr = data.data() + newOffset;
-
-        // Helper for Tiled Index
-        auto getTiledAddr = [](int x, int y, int w) -> size_t {
-            int bx = x / 4; int by = y / 4;
-            int lx = x % 4; int ly = y % 4;
-            int blocksW = (w + 3) / 4;
-            return (by * blocksW + bx) * 16 + (ly * 4 + lx);
-        };
 
-        for (int y = 0; y < nextH; ++y) {
-            for (int x = 0; x < nextW; ++x) {
-                int srcX = x * 2;
-                int srcY = y * 2;
-                
-                // Read from Source (already tiled) using getTexelRaw
-                // getTexelRaw handles the Tiled addressing of the source level
-                Vec4 c00 = getTexelRaw(*this, currentLevel, srcX, srcY);
-                Vec4 c10 = getTexelRaw(*this, currentLevel, std::min(srcX + 1, srcW - 1), srcY);
-                Vec4 c01 = getTexelRaw(*this, currentLevel, srcX, std::min(srcY + 1, srcH - 1));
-                Vec4 c11 = getTexelRaw(*this, currentLevel, std::min(srcX + 1, srcW - 1), std::min(srcY + 1, srcH - 1));
-
-                Vec4 avg = (c00 + c10 + c01 + c11) * 0.25f;
-                
-                uint32_t R = (uint32_t)(avg.x * 255.0f);
-                uint32_t G = (uint32_t)(avg.y * 255.0f);
-                uint32_t B = (uint32_t)(avg.z * 255.0f);
-                uint32_t A = (uint32_t)(avg.w * 255.0f);
-                
-                // Write to Dest (needs Tiled addressing)
-                size_t destIdx = getTiledAddr(x, y, nextW);
-                dstPtr[destIdx] = (A << 24) | (B << 16) | (G << 8) | R;
-            }
+    if (mipChainValid) {
+        // 增量：逐层把脏矩形映射到下一层 (下一层 texel x 读取 2x, 2x + 1)，只重建覆盖到的区域
+        int x0 = dirtyX0, y0 = dirtyY0, x1 = dirtyX1, y1 = dirtyY1;
+        for (int level = 1; level < static_cast<int>(mipLevels.size()); ++level) {
+            x0 = x0 / 2;
+            y0 = y0 / 2;
+            x1 = std::min(mipLevels[level].width, (x1 + 1) / 2);
+            y1 = std::min(mipLevels[level].height, (y1 + 1) / 2);
+            if (x0 >= x1 || y0 >= y1) break;
+            downsampleRegion(*this, level, x0, y0, x1, y1, jobs);
         }
-        currentLevel++;
+        dirtyX0 = dirtyY0 = dirtyX1 = dirtyY1 = 0;
+        return;
+    }
+
+    // 否则从 Level 0 重建整条 Mipmap 链 (不能在旧链之后继续追加)
+    // 先算出所有层级的尺寸与偏移并一次性分配，避免逐层 resize 反复搬移整条链
+    size_t oldLevels = mipLevels.size();
+    mipLevels.erase(mipLevels.begin() + 1, mipLevels.end());
+    size_t total = mipLevels[0].offset + textureImageWords(format, mipLevels[0].width, mipLevels[0].height);
+    while (mipLevels.back().width > 1 || mipLevels.back().height > 1) {
+        const int nextW = std::max(1, mipLevels.back().width / 2);
+        const int nextH = std::max(1, mipLevels.back().height / 2);
+        mipLevels.push_back({total, nextW, nextH});
+        total += textureImageWords(format, nextW, nextH);
+    }
+    data.resize(total);
+    if (isCompressedTextureFormat(format)) invalidateDecodedBlocks(); // data 可能已重新分配，按旧地址缓存的块失效
+
+    for (int level = 1; level < static_cast<int>(mipLevels.size()); ++level) {
+        int x0 = 0, y0 = 0, x1 = mipLevels[level].width, y1 = mipLevels[level].height;
+        downsampleRegion(*this, level, x0, y0, x1, y1, jobs);
+    }
+    mipChainValid = true;
+    dirtyX0 = dirtyY0 = dirtyX1 = dirtyY1 = 0;
+    if (mipLevels.size() != oldLevels) {
+        LOG_INFO("Generated " + std::to_string(mipLevels.size()) + " mipmap levels (Tiled).");
+    }
+}
+
+void TextureObject::markLevelDirty(int level, int x, int y, int w, int h) {
+    if (level != 0) {
+        mipChainValid = false;
+        return;
+    }
+    if (w <= 0 || h <= 0) return;
+    if (dirtyX0 >= dirtyX1 || dirtyY0 >= dirtyY1) {
+        dirtyX0 = x; dirtyY0 = y; dirtyX1 = x + w; dirtyY1 = y + h;
+    } else {
+        dirtyX0 = std::min(dirtyX0, x); dirtyY0 = std::min(dirtyY0, y);
+        dirtyX1 = std::max(dirtyX1, x + w); dirtyY1 = std::max(dirtyY1, y + h);
     }
-    LOG_INFO("Generated " + std::to_string(mipLevels.size()) + " mipmap levels (Tiled).");
 }
 
 // 辅助宏：检查 MagFilter 并赋值
 #define CHECK_MAG(MIN, MAG, WRAPS, WRAPT) \
     if (magFilter == MAG) { \
-        activeSampler = &FilterPolicy<MIN, MAG, WRAPS, WRAPT>::sample; \
+        activeSampler = &FilterPolicy<MIN, MAG, WRAPS, WRAPT, TFormat>::sample; \
         return; \
     }
 
@@ -95,7 +325,8 @@ void TextureObject::generateMipmaps() {
         CASE_MIN(GL_LINEAR_MIPMAP_LINEAR,   WRAPS, WRAPT) \
     }
 
-void TextureObject::updateSampler() {
+template <typename TFormat>
+void TextureObject::selectSampler() {
     if (wrapS == wrapT) {
         switch (wrapS) {
             case GL_REPEAT: 
@@ -141,6 +372,19 @@ void TextureObject::updateSampler() {
     }
 }
 
+// 先按存储格式确定取数策略，再展开 wrap / filter 组合
+void TextureObject::updateSampler() {
+    switch (format) {
+        case GL_RGBA8:  selectSampler<TexelPolicy<GL_RGBA8>>(); break;
+        case GL_R8:     selectSampler<TexelPolicy<GL_R8>>(); break;
+        case GL_RG8:    selectSampler<TexelPolicy<GL_RG8>>(); break;
+        case GL_RGB565: selectSampler<TexelPolicy<GL_RGB565>>(); break;
+        case GL_RGBA4:  selectSampler<TexelPolicy<GL_RGBA4>>(); break;
+        case GL_R16F:   selectSampler<TexelPolicy<GL_R16F>>(); break;
+        case GL_R32F:   selectSampler<TexelPolicy<GL_R32F>>(); break;
+        default:        selectSampler<CompressedTexelPolicy>(); break;
+    }
+}
 
 // ==========================================
 // SoftRenderContext
@@ -180,6 +424,7 @@ TextureObject* SoftRenderContext::getTexture(GLuint unit) {
 }
 
 void SoftRenderContext::glDeleteTextures(GLsizei n, const GLuint* textures_to_delete) {
+    flushDeferredDraws(); // 并行模式下延迟的 Draw 可能仍在采样这些纹理
     for (GLsizei i = 0; i < n; ++i) {
         GLuint id = textures_to_delete[i];
         if (id != 0) {
@@ -190,6 +435,13 @@ void SoftRenderContext::glDeleteTextures(GLsizei n, const GLuint* textures_to_de
                 }
             }
 
+            // 作为 FBO 颜色附件时自动解除附加 (绑定中的 FBO 随之变为不完整)
+            for (size_t fb = 1; fb < framebuffers.size(); ++fb) {
+                if (FramebufferObject* obj = framebuffers.get((GLuint)fb)) {
+                    if (obj->colorTexture == id) obj->colorTexture = 0;
+                }
+            }
+
             if (textures.isActive(id)) {
                 textures.release(id);
                 LOG_INFO("Deleted Texture ID: " + std::to_string(id));
@@ -198,25 +450,18 @@ void SoftRenderContext::glDeleteTextures(GLsizei n, const GLuint* textures_to_de
     }
 }
 
-void SoftRenderContext::glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei w, GLsizei h, GLint border, GLenum format, GLenum type, const void* p) {
-    auto* tex = getTexture(m_activeTextureUnit); if(!tex) return;
-
-    // Phase 1: Basic Parameter Handling
-    if (target != GL_TEXTURE_2D) {
-        LOG_WARN("glTexImage2D: Only GL_TEXTURE_2D is supported for target.");
-        return;
-    }
-    if (border != 0) {
-        LOG_WARN("glTexImage2D: Border must be 0.");
-        return;
-    }
-    if (internalformat != GL_RGBA) {
-        LOG_WARN("glTexImage2D: Only GL_RGBA internalformat is fully supported for storage.");
-        // Continue with GL_RGBA storage regardless
+namespace {
+// 为 level 层分配 4x4 块对齐的存储并返回其起点；level 0 重置整条链
+// 各层必须使用同一存储格式 (采样按 TextureObject::format 解码)
+uint32_t* defineTextureLevel(TextureObject* tex, GLint level, GLsizei w, GLsizei h, GLenum format, const char* caller) {
+    if (level > 0 && format != tex->format) {
+        LOG_ERROR(std::string(caller) + ": Level " + std::to_string(level) + " format does not match level 0.");
+        return nullptr;
     }
 
     tex->width = w; 
     tex->height = h;
+    tex->mipChainValid = false;
 
     // Handle level metadata
     if (level >= static_cast<int>(tex->mipLevels.size())) {
@@ -225,12 +470,14 @@ void SoftRenderContext::glTexImage2D(GLenum target, GLint level, GLint internalf
     
     // Calculate new size needed with 4x4 tiling alignment
     // Even if user provides w,h, we store in blocks of 4x4
-    int blocksX = (w + 3) / 4;
-    int blocksY = (h + 3) / 4;
-    size_t sizeNeeded = blocksX * blocksY * 16;
+    size_t sizeNeeded = textureImageWords(format, w, h);
     
     // Simplification: Assume Level 0 is uploaded first and resets the buffer.
     if (level == 0) {
+        if (tex->format != format) {
+            tex->format = format;
+            tex->updateSampler(); // 采样函数按存储格式特化
+        }
         tex->data.resize(sizeNeeded);
         tex->mipLevels[0] = {0, w, h};
         // Clear other levels if they existed from previous usage
@@ -241,48 +488,229 @@ void SoftRenderContext::glTexImage2D(GLenum target, GLint level, GLint internalf
         tex->data.resize(currentEnd + sizeNeeded);
         tex->mipLevels[level] = {currentEnd, w, h};
     }
+    return tex->data.data() + tex->mipLevels[level].offset;
+}
 
-    // Convert and Copy Data with SWIZZLING
-    if (p) {
-        std::vector<uint32_t> temp;
-        // Convert input to linear uint32_t buffer first
-        if (convertToInternalFormat(p, w, h, format, type, temp)) {
-            size_t offset = tex->mipLevels[level].offset;
-            uint32_t* destBase = tex->data.data() + offset;
-            
-            // Swizzle Loop
-            // Iterate over destination blocks
-            for (int by = 0; by < blocksY; ++by) {
-                for (int bx = 0; bx < blocksX; ++bx) {
-                    // Block Base Index in Destination
-                    int blockIdx = by * blocksX + bx;
-                    uint32_t* blockPtr = destBase + blockIdx * 16;
-                    
-                    // Iterate pixels in block
-                    for (int ly = 0; ly < 4; ++ly) {
-                        for (int lx = 0; lx < 4; ++lx) {
-                            int srcX = bx * 4 + lx;
-                            int srcY = by * 4 + ly;
-                            
-                            // Check bounds
-                            if (srcX < w && srcY < h) {
-                                blockPtr[ly * 4 + lx] = temp[srcY * w + srcX];
-                            } else {
-                                // Padding (transparent black)
-                                blockPtr[ly * 4 + lx] = 0;
-                            }
-                        }
-                    }
+// internalformat -> 存储格式：压缩与紧凑格式原样存储，非尺寸化的 GL_RED / GL_RG 取 8-bit 版本，不支持时返回 0
+GLenum resolveStorageFormat(GLint internalformat) {
+    const GLenum f = (GLenum)internalformat;
+    if (isCompressedTextureFormat(f) || textureTexelBytes(f)) return f;
+    switch (f) {
+        case GL_RED: return GL_R8;
+        case GL_RG: return GL_RG8;
+        case GL_RGB:
+        case GL_RGBA: return GL_RGBA8;
+        default: return 0;
+    }
+}
+
+// 客户端数据与存储格式逐 texel 字节布局相同，可跳过转换
+bool matchesStorageLayout(GLenum storage, GLenum format, GLenum type) {
+    switch (storage) {
+        case GL_RGBA8:  return format == GL_RGBA && type == GL_UNSIGNED_BYTE;
+        case GL_R8:     return format == GL_RED && type == GL_UNSIGNED_BYTE;
+        case GL_RG8:    return format == GL_RG && type == GL_UNSIGNED_BYTE;
+        case GL_RGB565: return format == GL_RGB && type == GL_UNSIGNED_SHORT_5_6_5;
+        case GL_RGBA4:  return format == GL_RGBA && type == GL_UNSIGNED_SHORT_4_4_4_4;
+        case GL_R16F:   return format == GL_RED && type == GL_HALF_FLOAT;
+        case GL_R32F:   return format == GL_RED && type == GL_FLOAT;
+        default:        return false;
+    }
+}
+
+// 行优先的 w x h 图像 (每 texel bytes 字节) 重排为 4x4 块布局，块内超出图像的部分填 0
+void swizzleTexels(const uint8_t* src, int w, int h, int bytes, uint8_t* dst) {
+    const int blocksX = (w + 3) / 4;
+    const int blocksY = (h + 3) / 4;
+    const size_t rowBytes = (size_t)4 * bytes;
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            uint8_t* block = dst + ((size_t)by * blocksX + bx) * 16 * bytes;
+            const size_t valid = (size_t)std::min(4, w - bx * 4) * bytes;
+            for (int ly = 0; ly < 4; ++ly) {
+                uint8_t* row = block + ly * rowBytes;
+                const int srcY = by * 4 + ly;
+                if (srcY < h) {
+                    std::memcpy(row, src + ((size_t)srcY * w + bx * 4) * bytes, valid);
+                    std::memset(row + valid, 0, rowBytes - valid);
+                } else {
+                    std::memset(row, 0, rowBytes);
                 }
             }
-        } else {
+        }
+    }
+}
+
+// 行优先的 w x h 图像写入 4x4 块布局层级的 (x0, y0) 处，只触及覆盖到的块
+void writeTexelRect(const uint8_t* src, int w, int h, int bytes, uint8_t* dst, int blocksPerRow, int x0, int y0) {
+    for (int y = 0; y < h; ++y) {
+        const int ty = y0 + y;
+        uint8_t* dstRow = dst + tiledTexelIndex(0, ty, blocksPerRow) * bytes;
+        const uint8_t* srcRow = src + (size_t)y * w * bytes;
+        for (int x = 0; x < w;) {
+            const int tx = x0 + x;
+            const int n = std::min(4 - (tx & 3), w - x); // 同一块内连续的 texel
+            std::memcpy(dstRow + tiledTexelIndex(tx, 0, blocksPerRow) * bytes, srcRow + (size_t)x * bytes, (size_t)n * bytes);
+            x += n;
+        }
+    }
+}
+}
+
+void SoftRenderContext::glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei w, GLsizei h, GLint border, GLenum format, GLenum type, const void* p) {
+    flushDeferredDraws();
+    auto* tex = getTexture(m_activeTextureUnit); if(!tex) return;
+
+    // Phase 1: Basic Parameter Handling
+    if (target != GL_TEXTURE_2D) {
+        LOG_WARN("glTexImage2D: Only GL_TEXTURE_2D is supported for target.");
+        return;
+    }
+    if (border != 0) {
+        LOG_WARN("glTexImage2D: Border must be 0.");
+        return;
+    }
+    // 按请求的 internalformat 存储 (压缩格式在上传时编码)
+    GLenum storage = resolveStorageFormat(internalformat);
+    if (storage == 0) {
+        LOG_WARN("glTexImage2D: Unsupported internalformat " + std::to_string(internalformat) + ", storing as GL_RGBA8.");
+        storage = GL_RGBA8;
+    }
+
+    uint32_t* destBase = defineTextureLevel(tex, level, w, h, storage, "glTexImage2D");
+    if (!destBase) return;
+
+    // Convert and Copy Data with SWIZZLING
+    if (p) {
+        std::vector<uint32_t> scratch;
+        const uint8_t* packed = packPixels(storage, w, h, format, type, p, scratch);
+        if (!packed) {
             LOG_ERROR("glTexImage2D: Failed to convert source pixel data.");
+        } else if (const int texelBytes = textureTexelBytes(storage)) {
+            swizzleTexels(packed, w, h, texelBytes, reinterpret_cast<uint8_t*>(destBase));
+        } else {
+            encodeTextureImage(storage, reinterpret_cast<const uint32_t*>(packed), w, h, destBase);
+        }
+    }
+    if (isCompressedTextureFormat(storage)) invalidateDecodedBlocks();
+}
+
+const uint8_t* SoftRenderContext::packPixels(GLenum storage, GLsizei w, GLsizei h, GLenum src_format, GLenum src_type,
+                                             const void* src_data, std::vector<uint32_t>& scratch) {
+    if (matchesStorageLayout(storage, src_format, src_type)) return static_cast<const uint8_t*>(src_data);
+
+    const int texelBytes = textureTexelBytes(storage);
+    const size_t count = (size_t)w * h;
+    uint8_t* out = nullptr;
+    if (texelBytes && src_format == GL_RED && (src_type == GL_FLOAT || src_type == GL_HALF_FLOAT)) {
+        // 浮点单通道数据不经过 RGBA8，保留 R16F / R32F 的精度与范围
+        scratch.resize((count * texelBytes + 3) / 4);
+        out = reinterpret_cast<uint8_t*>(scratch.data());
+        for (size_t i = 0; i < count; ++i) {
+            const float v = src_type == GL_FLOAT ? static_cast<const float*>(src_data)[i]
+                                                 : halfToFloat(static_cast<const uint16_t*>(src_data)[i]);
+            storeTexel(storage, out + i * texelBytes, Vec4(v, 0.0f, 0.0f, 1.0f));
         }
+        return out;
+    }
+
+    // 其余来源先转换为 RGBA8：RGBA8 与压缩格式直接使用，紧凑格式再逐 texel 打包
+    if (!convertToInternalFormat(src_data, w, h, src_format, src_type, scratch)) return nullptr;
+    if (!texelBytes || storage == GL_RGBA8) return reinterpret_cast<const uint8_t*>(scratch.data());
+
+    std::vector<uint32_t> rgba;
+    rgba.swap(scratch);
+    scratch.resize((count * texelBytes + 3) / 4);
+    out = reinterpret_cast<uint8_t*>(scratch.data());
+    constexpr float k = 1.0f / 255.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t c = rgba[i];
+        storeTexel(storage, out + i * texelBytes,
+                   Vec4((c & 0xFF) * k, ((c >> 8) & 0xFF) * k, ((c >> 16) & 0xFF) * k, (c >> 24) * k));
     }
+    return out;
+}
+
+void SoftRenderContext::glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei w, GLsizei h, GLenum format, GLenum type, const void* p) {
+    flushDeferredDraws(); // 延迟的 Draw 可能仍在采样旧内容
+    auto* tex = getTexture(m_activeTextureUnit); if(!tex) return;
+
+    if (target != GL_TEXTURE_2D) {
+        LOG_WARN("glTexSubImage2D: Only GL_TEXTURE_2D is supported for target.");
+        return;
+    }
+    if (level < 0 || level >= static_cast<GLint>(tex->mipLevels.size())) {
+        LOG_ERROR("glTexSubImage2D: Level " + std::to_string(level) + " has not been defined.");
+        return;
+    }
+    const TextureObject::MipLevelInfo info = tex->mipLevels[level];
+    if (xoffset < 0 || yoffset < 0 || w < 0 || h < 0 || xoffset + w > info.width || yoffset + h > info.height) {
+        LOG_ERROR("glTexSubImage2D: Region exceeds the bounds of level " + std::to_string(level) + ".");
+        return;
+    }
+    const int texelBytes = textureTexelBytes(tex->format);
+    if (!texelBytes && ((xoffset | yoffset) & 3 || ((w & 3) && xoffset + w != info.width) || ((h & 3) && yoffset + h != info.height))) {
+        LOG_ERROR("glTexSubImage2D: Compressed textures require a region aligned to 4x4 blocks.");
+        return;
+    }
+    if (w == 0 || h == 0 || !p) return;
+
+    std::vector<uint32_t> scratch;
+    const uint8_t* packed = packPixels(tex->format, w, h, format, type, p, scratch);
+    if (!packed) {
+        LOG_ERROR("glTexSubImage2D: Failed to convert source pixel data.");
+        return;
+    }
+
+    uint32_t* levelBase = tex->data.data() + info.offset;
+    const int blocksPerRow = (info.width + 3) / 4;
+    if (texelBytes) {
+        writeTexelRect(packed, w, h, texelBytes, reinterpret_cast<uint8_t*>(levelBase), blocksPerRow, xoffset, yoffset);
+    } else {
+        // 每 4 行是一串连续的块，整串编码 (到达层级边缘的块复制边缘像素补齐)
+        const uint32_t* pixels = reinterpret_cast<const uint32_t*>(packed);
+        const int words = textureBlockWords(tex->format);
+        for (int row = 0; row < h; row += 4) {
+            uint32_t* blocks = levelBase + ((size_t)((yoffset + row) >> 2) * blocksPerRow + (xoffset >> 2)) * words;
+            encodeTextureImage(tex->format, pixels + (size_t)row * w, w, std::min(4, h - row), blocks);
+        }
+        invalidateDecodedBlocks();
+    }
+    tex->markLevelDirty(level, xoffset, yoffset, w, h);
+}
+
+void SoftRenderContext::glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei w, GLsizei h, GLint border, GLsizei imageSize, const void* data) {
+    flushDeferredDraws();
+    auto* tex = getTexture(m_activeTextureUnit); if(!tex) return;
+
+    if (target != GL_TEXTURE_2D) {
+        LOG_WARN("glCompressedTexImage2D: Only GL_TEXTURE_2D is supported for target.");
+        return;
+    }
+    if (border != 0) {
+        LOG_WARN("glCompressedTexImage2D: Border must be 0.");
+        return;
+    }
+    if (!isCompressedTextureFormat(internalformat)) {
+        LOG_ERROR("glCompressedTexImage2D: Unsupported compressed internalformat " + std::to_string(internalformat) + ".");
+        return;
+    }
+    // 数据为按行优先排列的 4x4 块，与内部存储完全一致，直接拷贝
+    const size_t bytes = textureImageWords(internalformat, w, h) * sizeof(uint32_t);
+    if (imageSize < 0 || (size_t)imageSize != bytes) {
+        LOG_ERROR("glCompressedTexImage2D: imageSize " + std::to_string(imageSize) + " does not match " + std::to_string(bytes) + " bytes of block data.");
+        return;
+    }
+
+    uint32_t* destBase = defineTextureLevel(tex, level, w, h, internalformat, "glCompressedTexImage2D");
+    if (!destBase) return;
+    if (data) std::memcpy(destBase, data, bytes);
+    invalidateDecodedBlocks();
 }
 
 void SoftRenderContext::glTexParameteri(GLenum target, GLenum pname, GLint param) {
     if (target != GL_TEXTURE_2D) return;
+    flushDeferredDraws();
     TextureObject* tex = getTexture(m_activeTextureUnit);
     if (!tex) return;
 
@@ -300,6 +728,7 @@ void SoftRenderContext::glTexParameteri(GLenum target, GLenum pname, GLint param
 
 void SoftRenderContext::glTexParameterf(GLenum target, GLenum pname, GLfloat param) {
     if (target != GL_TEXTURE_2D) return;
+    flushDeferredDraws();
     TextureObject* tex = getTexture(m_activeTextureUnit);
     if (!tex) return;
 
@@ -317,6 +746,7 @@ void SoftRenderContext::glTexParameterf(GLenum target, GLenum pname, GLfloat par
 
 void SoftRenderContext::glTexParameteriv(GLenum target, GLenum pname, const GLint* params) {
     if (target != GL_TEXTURE_2D || !params) return;
+    flushDeferredDraws();
     TextureObject* tex = getTexture(m_activeTextureUnit);
     if (!tex) return;
 
@@ -335,6 +765,7 @@ void SoftRenderContext::glTexParameteriv(GLenum target, GLenum pname, const GLin
 
 void SoftRenderContext::glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params) {
     if (target != GL_TEXTURE_2D || !params) return;
+    flushDeferredDraws();
     TextureObject* tex = getTexture(m_activeTextureUnit);
     if (!tex) return;
 
@@ -350,6 +781,7 @@ void SoftRenderContext::glTexParameterfv(GLenum target, GLenum pname, const GLfl
 }
 
 void SoftRenderContext::glGenerateMipmap(GLenum target) {
+    flushDeferredDraws();
     if (target != GL_TEXTURE_2D) {
         LOG_WARN("glGenerateMipmap: Only GL_TEXTURE_2D is supported.");
         return;
@@ -357,10 +789,24 @@ void SoftRenderContext::glGenerateMipmap(GLenum target) {
     
     TextureObject* tex = getTexture(m_activeTextureUnit);
     if (tex) {
-        tex->generateMipmaps();
+        generateTextureMipmaps(tex);
     } else {
         LOG_WARN("glGenerateMipmap: No texture bound to active unit.");
     }
 }
 
+void SoftRenderContext::generateTextureMipmaps(TextureObject* tex) {
+    // Level 1 不到并行阈值时整条链都串行，不必创建工作线程
+    const bool parallel = !tex->mipLevels.empty() &&
+                          (size_t)tex->mipLevels[0].width * tex->mipLevels[0].height >= 4 * TextureObject::MIPMAP_PARALLEL_MIN_TEXELS;
+    tex->generateMipmaps(parallel ? acquireJobSystem() : nullptr);
+}
+
+void SoftRenderContext::setTextureSRGBMipmap(GLuint texture, bool enabled) {
+    TextureObject* tex = getTextureObject(texture);
+    if (!tex || tex->srgbMipmaps == enabled) return;
+    tex->srgbMipmaps = enabled;
+    tex->mipChainValid = false;
+}
+
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 namespace tinygl {
 
-VOut SoftRenderContext::lerpVertex(const VOut& a, const VOut& b, float t) {
+VOut SoftRenderContext::lerpVertex(const VOut& a, const VOut& b, float t, int varyingCount) {
     VOut res;
     // 1. 插值位置 (Clip Space)
     res.pos = a.pos * (1.0f - t) + b.pos * t;
@@ -11,9 +11,10 @@ VOut SoftRenderContext::lerpVertex(const VOut& a, const VOut& b, float t) {
     // 注意：这里的插值是线性的，但在投影后是不正确的。
     // 不过由于我们是在 Clip Space (4D) 进行裁剪，还未进行透视除法，
     // 所以直接线性插值属性是数学上正确的 (Rational Linear Interpolation)。
-    for (int i = 0; i < MAX_VARYINGS; ++i) {
+    for (int i = 0; i < varyingCount; ++i) {
         res.ctx.varyings[i] = a.ctx.varyings[i] * (1.0f - t) + b.ctx.varyings[i] * t;
     }
+    res.pointSize = a.pointSize * (1.0f - t) + b.pointSize * t;
     return res;
 }
 
@@ -92,6 +93,13 @@ bool SoftRenderContext::convertToInternalFormat(const void* src_data, GLsizei sr
                 dst_pixels[i] = (0xFF << 24) | (0 << 16) | (0 << 8) | r; // AABBGGRR
             }
             return true;
+        } else if (src_format == GL_RG) {
+            for (size_t i = 0; i < pixel_count; ++i) {
+                uint8_t r = src_bytes[i * 2 + 0];
+                uint8_t g = src_bytes[i * 2 + 1];
+                dst_pixels[i] = (0xFF << 24) | (g << 8) | r; // AABBGGRR
+            }
+            return true;
         } else {
             LOG_ERROR("Unsupported source format with GL_UNSIGNED_BYTE type.");
             return false;
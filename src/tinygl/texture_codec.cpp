@@ -0,0 +1,537 @@
+#include <tinygl/core/texture_codec.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+
+namespace tinygl {
+
+namespace {
+
+inline uint32_t packRGBA(int r, int g, int b, int a) {
+    return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+}
+inline int channelOf(uint32_t c, int ch) { return (int)((c >> (ch * 8)) & 0xFF); }
+inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+inline int colorError(uint32_t a, uint32_t b) {
+    int err = 0;
+    for (int ch = 0; ch < 3; ++ch) {
+        const int d = channelOf(a, ch) - channelOf(b, ch);
+        err += d * d;
+    }
+    return err;
+}
+
+// ------------------------------------------
+// BC1 / BC3 (S3TC)
+// ------------------------------------------
+// 颜色块：word0 = color0 | color1 << 16 (RGB565)，word1 = 16 个 2-bit 索引 (texel i 位于 bit 2i)
+
+inline uint32_t expand565(uint32_t c) {
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    return packRGBA((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255);
+}
+
+inline uint32_t quantize565(const float* rgb) {
+    const int r = std::clamp((int)(rgb[0] * (31.0f / 255.0f) + 0.5f), 0, 31);
+    const int g = std::clamp((int)(rgb[1] * (63.0f / 255.0f) + 0.5f), 0, 63);
+    const int b = std::clamp((int)(rgb[2] * (31.0f / 255.0f) + 0.5f), 0, 31);
+    return (uint32_t)((r << 11) | (g << 5) | b);
+}
+
+// fourColor 为 false 且 color0 <= color1 时为 3 色模式，第 4 项为黑色 (punchAlpha 时为全透明)
+void buildColorPalette(uint32_t c0, uint32_t c1, bool fourColor, bool punchAlpha, uint32_t* palette) {
+    const uint32_t e0 = expand565(c0), e1 = expand565(c1);
+    palette[0] = e0;
+    palette[1] = e1;
+    int p2[3], p3[3];
+    const bool interp4 = fourColor || c0 > c1;
+    for (int ch = 0; ch < 3; ++ch) {
+        const int a = channelOf(e0, ch), b = channelOf(e1, ch);
+        p2[ch] = interp4 ? (2 * a + b) / 3 : (a + b) / 2;
+        p3[ch] = (a + 2 * b) / 3;
+    }
+    palette[2] = packRGBA(p2[0], p2[1], p2[2], 255);
+    if (interp4) palette[3] = packRGBA(p3[0], p3[1], p3[2], 255);
+    else palette[3] = punchAlpha ? 0u : packRGBA(0, 0, 0, 255);
+}
+
+void decodeColorBlock(const uint32_t* block, uint32_t* texels, bool fourColor, bool punchAlpha) {
+    uint32_t palette[4];
+    buildColorPalette(block[0] & 0xFFFF, block[0] >> 16, fourColor, punchAlpha, palette);
+    const uint32_t indices = block[1];
+    for (int i = 0; i < 16; ++i) texels[i] = palette[(indices >> (2 * i)) & 3];
+}
+
+// 端点取主轴 (协方差矩阵幂迭代) 上投影的两端，再向内收缩 1/16 以降低量化误差
+// punchAlpha 时 alpha < 128 的 texel 使用 3 色模式的透明索引
+void encodeColorBlock(const uint32_t* texels, uint32_t* block, bool fourColor, bool punchAlpha) {
+    bool opaque[16];
+    int opaqueCount = 0;
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        opaque[i] = !punchAlpha || channelOf(texels[i], 3) >= 128;
+        if (!opaque[i]) continue;
+        ++opaqueCount;
+        for (int ch = 0; ch < 3; ++ch) mean[ch] += (float)channelOf(texels[i], ch);
+    }
+    if (opaqueCount == 0) { // 全透明：c0 == c1 (3 色模式)，索引全为 3
+        block[0] = 0;
+        block[1] = 0xFFFFFFFFu;
+        return;
+    }
+    for (float& m : mean) m /= (float)opaqueCount;
+
+    float cov[6] = {0, 0, 0, 0, 0, 0}; // rr, rg, rb, gg, gb, bb
+    for (int i = 0; i < 16; ++i) {
+        if (!opaque[i]) continue;
+        const float r = channelOf(texels[i], 0) - mean[0];
+        const float g = channelOf(texels[i], 1) - mean[1];
+        const float b = channelOf(texels[i], 2) - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iter = 0; iter < 4; ++iter) {
+        const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        const float m = std::max({std::abs(x), std::abs(y), std::abs(z)});
+        if (m < 1e-6f) break; // 纯色块：保持初值，投影全为 0
+        axis[0] = x / m; axis[1] = y / m; axis[2] = z / m;
+    }
+    float tMin = 0.0f, tMax = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        if (!opaque[i]) continue;
+        float t = 0.0f;
+        for (int ch = 0; ch < 3; ++ch) t += (channelOf(texels[i], ch) - mean[ch]) * axis[ch];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    const float axisLen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    const float inset = (tMax - tMin) / 16.0f;
+    float hi[3], lo[3];
+    for (int ch = 0; ch < 3; ++ch) {
+        hi[ch] = mean[ch] + axis[ch] * (tMax - inset) / axisLen2;
+        lo[ch] = mean[ch] + axis[ch] * (tMin + inset) / axisLen2;
+    }
+    uint32_t c0 = quantize565(hi), c1 = quantize565(lo);
+
+    // 4 色模式要求 c0 > c1，含透明 texel 时要求 c0 <= c1 (3 色模式)
+    const bool threeColor = opaqueCount < 16;
+    if (threeColor ? c0 > c1 : c0 < c1) std::swap(c0, c1);
+
+    uint32_t palette[4];
+    buildColorPalette(c0, c1, fourColor, punchAlpha, palette);
+    const int candidates = (!fourColor && c0 <= c1) ? 3 : 4; // 3 色模式下索引 3 只给透明 texel
+    uint32_t indices = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 3;
+        if (opaque[i]) {
+            int bestErr = INT_MAX;
+            for (int k = 0; k < candidates; ++k) {
+                const int err = colorError(texels[i], palette[k]);
+                if (err < bestErr) { bestErr = err; best = k; }
+            }
+        }
+        indices |= (uint32_t)best << (2 * i);
+    }
+    block[0] = c0 | (c1 << 16);
+    block[1] = indices;
+}
+
+// BC3 Alpha 块：a0 | a1 << 8 | 48-bit 索引 (texel i 位于 bit 3i)
+void buildAlphaPalette(int a0, int a1, int* palette) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i <= 6; ++i) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    } else {
+        for (int i = 1; i <= 4; ++i) palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void decodeAlphaBlock(const uint32_t* block, uint32_t* texels) {
+    int palette[8];
+    buildAlphaPalette(block[0] & 0xFF, (block[0] >> 8) & 0xFF, palette);
+    const uint64_t indices = (block[0] >> 16) | ((uint64_t)block[1] << 16);
+    for (int i = 0; i < 16; ++i) {
+        texels[i] = (texels[i] & 0x00FFFFFFu) | ((uint32_t)palette[(indices >> (3 * i)) & 7] << 24);
+    }
+}
+
+void encodeAlphaBlock(const uint32_t* texels, uint32_t* block) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max(a0, channelOf(texels[i], 3));
+        a1 = std::min(a1, channelOf(texels[i], 3));
+    }
+    int palette[8];
+    buildAlphaPalette(a0, a1, palette); // a0 > a1 为 8 值插值模式，相等时索引全为 0
+    uint64_t indices = 0;
+    if (a0 > a1) {
+        for (int i = 0; i < 16; ++i) {
+            const int a = channelOf(texels[i], 3);
+            int best = 0, bestErr = INT_MAX;
+            for (int k = 0; k < 8; ++k) {
+                const int err = std::abs(palette[k] - a);
+                if (err < bestErr) { bestErr = err; best = k; }
+            }
+            indices |= (uint64_t)best << (3 * i);
+        }
+    }
+    block[0] = (uint32_t)a0 | ((uint32_t)a1 << 8) | (uint32_t)(indices << 16);
+    block[1] = (uint32_t)(indices >> 16);
+}
+
+// ------------------------------------------
+// ETC2 RGB / EAC Alpha
+// ------------------------------------------
+// 64-bit 块按大端字节序存储；像素索引按列优先 (i = x * 4 + y)
+
+constexpr int ETC_MODIFIERS[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+constexpr int ETC_DISTANCES[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+constexpr int EAC_MODIFIERS[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},   {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},   {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},   {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},   {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},     {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+inline uint64_t loadBigEndian64(const uint32_t* words) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words);
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | bytes[i];
+    return v;
+}
+
+inline void storeBigEndian64(uint64_t v, uint32_t* words) {
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(words);
+    for (int i = 7; i >= 0; --i) { bytes[i] = (uint8_t)v; v >>= 8; }
+}
+
+// 取 [hi, hi - count + 1] 位段
+inline int bitField(uint64_t bits, int hi, int count) {
+    return (int)((bits >> (hi - count + 1)) & ((1u << count) - 1));
+}
+inline int extend4(int v) { return (v << 4) | v; }
+inline int extend5(int v) { return (v << 3) | (v >> 2); }
+inline int extend6(int v) { return (v << 2) | (v >> 4); }
+inline int extend7(int v) { return (v << 1) | (v >> 6); }
+
+inline uint32_t offsetColor(const int* c, int d) {
+    return packRGBA(clamp255(c[0] + d), clamp255(c[1] + d), clamp255(c[2] + d), 255);
+}
+
+// T / H 模式：2-bit 索引直接选取 4 个调色板颜色
+void decodeEtcPaintColors(uint64_t bits, const uint32_t* paint, uint32_t* texels) {
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int i = x * 4 + y;
+            texels[y * 4 + x] = paint[(((bits >> (16 + i)) & 1) << 1) | ((bits >> i) & 1)];
+        }
+    }
+}
+
+void decodeEtcTMode(uint64_t bits, uint32_t* texels) {
+    const int c1[3] = {extend4((bitField(bits, 60, 2) << 2) | bitField(bits, 57, 2)),
+                       extend4(bitField(bits, 55, 4)), extend4(bitField(bits, 51, 4))};
+    const int c2[3] = {extend4(bitField(bits, 47, 4)), extend4(bitField(bits, 43, 4)), extend4(bitField(bits, 39, 4))};
+    const int d = ETC_DISTANCES[(bitField(bits, 35, 2) << 1) | bitField(bits, 32, 1)];
+    const uint32_t paint[4] = {offsetColor(c1, 0), offsetColor(c2, d), offsetColor(c2, 0), offsetColor(c2, -d)};
+    decodeEtcPaintColors(bits, paint, texels);
+}
+
+void decodeEtcHMode(uint64_t bits, uint32_t* texels) {
+    const int c1[3] = {extend4(bitField(bits, 62, 4)),
+                       extend4((bitField(bits, 58, 3) << 1) | bitField(bits, 52, 1)),
+                       extend4((bitField(bits, 51, 1) << 3) | bitField(bits, 49, 3))};
+    const int c2[3] = {extend4(bitField(bits, 46, 4)), extend4(bitField(bits, 42, 4)), extend4(bitField(bits, 38, 4))};
+    const int v1 = (c1[0] << 16) | (c1[1] << 8) | c1[2];
+    const int v2 = (c2[0] << 16) | (c2[1] << 8) | c2[2];
+    const int d = ETC_DISTANCES[(bitField(bits, 34, 1) << 2) | (bitField(bits, 32, 1) << 1) | (v1 >= v2 ? 1 : 0)];
+    const uint32_t paint[4] = {offsetColor(c1, d), offsetColor(c1, -d), offsetColor(c2, d), offsetColor(c2, -d)};
+    decodeEtcPaintColors(bits, paint, texels);
+}
+
+void decodeEtcPlanarMode(uint64_t bits, uint32_t* texels) {
+    const int o[3] = {extend6(bitField(bits, 62, 6)),
+                      extend7((bitField(bits, 56, 1) << 6) | bitField(bits, 54, 6)),
+                      extend6((bitField(bits, 48, 1) << 5) | (bitField(bits, 44, 2) << 3) | bitField(bits, 41, 3))};
+    const int h[3] = {extend6((bitField(bits, 38, 5) << 1) | bitField(bits, 32, 1)),
+                      extend7(bitField(bits, 31, 7)), extend6(bitField(bits, 24, 6))};
+    const int v[3] = {extend6(bitField(bits, 18, 6)), extend7(bitField(bits, 12, 7)), extend6(bitField(bits, 5, 6))};
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            int c[3];
+            for (int ch = 0; ch < 3; ++ch) {
+                c[ch] = clamp255((x * (h[ch] - o[ch]) + y * (v[ch] - o[ch]) + 4 * o[ch] + 2) >> 2);
+            }
+            texels[y * 4 + x] = packRGBA(c[0], c[1], c[2], 255);
+        }
+    }
+}
+
+void decodeEtcColorBlock(uint64_t bits, uint32_t* texels) {
+    int base[2][3];
+    if (bits & (1ull << 33)) {
+        // 差分模式；基色 + 差值溢出 [0, 31] 时为 ETC2 新增的 T / H / Planar 模式 (依次检查 R / G / B)
+        int q1[3], q2[3];
+        for (int ch = 0; ch < 3; ++ch) {
+            q1[ch] = bitField(bits, 63 - ch * 8, 5);
+            const int d = bitField(bits, 58 - ch * 8, 3);
+            q2[ch] = q1[ch] + (d >= 4 ? d - 8 : d);
+        }
+        if (q2[0] < 0 || q2[0] > 31) { decodeEtcTMode(bits, texels); return; }
+        if (q2[1] < 0 || q2[1] > 31) { decodeEtcHMode(bits, texels); return; }
+        if (q2[2] < 0 || q2[2] > 31) { decodeEtcPlanarMode(bits, texels); return; }
+        for (int ch = 0; ch < 3; ++ch) {
+            base[0][ch] = extend5(q1[ch]);
+            base[1][ch] = extend5(q2[ch]);
+        }
+    } else { // 独立模式
+        for (int ch = 0; ch < 3; ++ch) {
+            base[0][ch] = extend4(bitField(bits, 63 - ch * 8, 4));
+            base[1][ch] = extend4(bitField(bits, 59 - ch * 8, 4));
+        }
+    }
+
+    const int tables[2] = {bitField(bits, 39, 3), bitField(bits, 36, 3)};
+    const bool flip = (bits >> 32) & 1;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int i = x * 4 + y;
+            const int sub = flip ? (y >= 2) : (x >= 2);
+            int mod = ETC_MODIFIERS[tables[sub]][(bits >> i) & 1];
+            if ((bits >> (16 + i)) & 1) mod = -mod;
+            texels[y * 4 + x] = offsetColor(base[sub], mod);
+        }
+    }
+}
+
+// 子块 (flip 决定 2x4 / 4x2) 在给定基色下选出误差最小的修正表，索引写入 msb / lsb
+int fitEtcSubblock(const uint32_t* texels, bool flip, int sub, const int* base, int& table, uint32_t& msb, uint32_t& lsb) {
+    int bestErr = INT_MAX;
+    for (int t = 0; t < 8; ++t) {
+        int err = 0;
+        uint32_t m = 0, l = 0;
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                if ((flip ? (y >= 2) : (x >= 2)) != (sub != 0)) continue;
+                const int i = x * 4 + y;
+                int best = 0, bestPixelErr = INT_MAX;
+                for (int k = 0; k < 4; ++k) {
+                    const int mod = (k & 2) ? -ETC_MODIFIERS[t][k & 1] : ETC_MODIFIERS[t][k & 1];
+                    const int e = colorError(texels[y * 4 + x], offsetColor(base, mod));
+                    if (e < bestPixelErr) { bestPixelErr = e; best = k; }
+                }
+                err += bestPixelErr;
+                m |= (uint32_t)(best >> 1) << i;
+                l |= (uint32_t)(best & 1) << i;
+            }
+        }
+        if (err < bestErr) {
+            bestErr = err;
+            table = t;
+            msb = m;
+            lsb = l;
+        }
+    }
+    return bestErr;
+}
+
+// 只使用与 ETC1 兼容的独立 / 差分模式 (差值钳制到 [-4, 3]，不会意外落入 T / H / Planar)
+uint64_t encodeEtcColorBlock(const uint32_t* texels) {
+    uint64_t bestBits = 0;
+    int64_t bestErr = INT64_MAX;
+    for (int flip = 0; flip < 2; ++flip) {
+        float avg[2][3] = {};
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                const int sub = flip ? (y >= 2) : (x >= 2);
+                for (int ch = 0; ch < 3; ++ch) avg[sub][ch] += channelOf(texels[y * 4 + x], ch) / 8.0f;
+            }
+        }
+        for (int diff = 0; diff < 2; ++diff) {
+            int base[2][3];
+            uint64_t bits = ((uint64_t)diff << 33) | ((uint64_t)flip << 32);
+            for (int ch = 0; ch < 3; ++ch) {
+                if (diff) {
+                    const int q1 = std::clamp((int)(avg[0][ch] * (31.0f / 255.0f) + 0.5f), 0, 31);
+                    const int q2 = std::clamp((int)(avg[1][ch] * (31.0f / 255.0f) + 0.5f), 0, 31);
+                    const int d = std::clamp(q2 - q1, -4, 3);
+                    base[0][ch] = extend5(q1);
+                    base[1][ch] = extend5(q1 + d);
+                    bits |= ((uint64_t)q1 << (59 - ch * 8)) | ((uint64_t)(d & 7) << (56 - ch * 8));
+                } else {
+                    const int q1 = std::clamp((int)(avg[0][ch] * (15.0f / 255.0f) + 0.5f), 0, 15);
+                    const int q2 = std::clamp((int)(avg[1][ch] * (15.0f / 255.0f) + 0.5f), 0, 15);
+                    base[0][ch] = extend4(q1);
+                    base[1][ch] = extend4(q2);
+                    bits |= ((uint64_t)q1 << (60 - ch * 8)) | ((uint64_t)q2 << (56 - ch * 8));
+                }
+            }
+            int64_t err = 0;
+            for (int sub = 0; sub < 2; ++sub) {
+                int table = 0;
+                uint32_t msb = 0, lsb = 0;
+                err += fitEtcSubblock(texels, flip != 0, sub, base[sub], table, msb, lsb);
+                bits |= ((uint64_t)table << (sub ? 34 : 37)) | ((uint64_t)msb << 16) | lsb;
+            }
+            if (err < bestErr) {
+                bestErr = err;
+                bestBits = bits;
+            }
+        }
+    }
+    return bestBits;
+}
+
+void decodeEacAlphaBlock(uint64_t bits, uint32_t* texels) {
+    const int base = (int)(bits >> 56);
+    const int multiplier = (int)((bits >> 52) & 15);
+    const int* modifiers = EAC_MODIFIERS[(bits >> 48) & 15];
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int i = x * 4 + y;
+            const int a = clamp255(base + modifiers[(bits >> (45 - 3 * i)) & 7] * multiplier);
+            uint32_t& t = texels[y * 4 + x];
+            t = (t & 0x00FFFFFFu) | ((uint32_t)a << 24);
+        }
+    }
+}
+
+// 每张修正表按 alpha 范围估算乘数 (及其相邻值)，基值取范围中点
+uint64_t encodeEacAlphaBlock(const uint32_t* texels) {
+    int minA = 255, maxA = 0;
+    for (int i = 0; i < 16; ++i) {
+        minA = std::min(minA, channelOf(texels[i], 3));
+        maxA = std::max(maxA, channelOf(texels[i], 3));
+    }
+    uint64_t bestBits = 0;
+    int bestErr = INT_MAX;
+    for (int t = 0; t < 16 && bestErr > 0; ++t) {
+        const int* modifiers = EAC_MODIFIERS[t];
+        const int span = modifiers[7] - modifiers[3];
+        const int guess = (maxA - minA + span / 2) / span;
+        for (int multiplier = std::max(1, guess - 1); multiplier <= std::min(15, guess + 1); ++multiplier) {
+            const int base = clamp255((int)std::lround((minA + maxA) * 0.5f - (modifiers[3] + modifiers[7]) * multiplier * 0.5f));
+            int err = 0;
+            uint64_t indices = 0;
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    const int a = channelOf(texels[y * 4 + x], 3);
+                    int best = 0, bestPixelErr = INT_MAX;
+                    for (int k = 0; k < 8; ++k) {
+                        const int e = std::abs(clamp255(base + modifiers[k] * multiplier) - a);
+                        if (e < bestPixelErr) { bestPixelErr = e; best = k; }
+                    }
+                    err += bestPixelErr * bestPixelErr;
+                    indices |= (uint64_t)best << (45 - 3 * (x * 4 + y));
+                }
+            }
+            if (err < bestErr) {
+                bestErr = err;
+                bestBits = ((uint64_t)base << 56) | ((uint64_t)multiplier << 52) | ((uint64_t)t << 48) | indices;
+            }
+        }
+    }
+    return bestBits;
+}
+
+// ------------------------------------------
+// 解码块缓存
+// ------------------------------------------
+static_assert((TEXTURE_BLOCK_CACHE_SIZE & (TEXTURE_BLOCK_CACHE_SIZE - 1)) == 0, "TEXTURE_BLOCK_CACHE_SIZE must be a power of 2");
+
+struct DecodedBlockCache {
+    const uint32_t* tags[TEXTURE_BLOCK_CACHE_SIZE] = {};
+    uint32_t epochs[TEXTURE_BLOCK_CACHE_SIZE] = {};
+    alignas(16) uint32_t texels[TEXTURE_BLOCK_CACHE_SIZE][16];
+};
+
+thread_local DecodedBlockCache t_blockCache;
+std::atomic<uint32_t> g_blockCacheEpoch{1}; // 缓存项 epoch 为 0 表示空
+
+} // namespace
+
+void decodeTextureBlock(GLenum format, const uint32_t* block, uint32_t* texels) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: decodeColorBlock(block, texels, false, false); break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: decodeColorBlock(block, texels, false, true); break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            decodeColorBlock(block + 2, texels, true, false);
+            decodeAlphaBlock(block, texels);
+            break;
+        case GL_COMPRESSED_RGB8_ETC2: decodeEtcColorBlock(loadBigEndian64(block), texels); break;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            decodeEtcColorBlock(loadBigEndian64(block + 2), texels);
+            decodeEacAlphaBlock(loadBigEndian64(block), texels);
+            break;
+        case GL_RGBA8: std::copy(block, block + 16, texels); break;
+        default: std::fill(texels, texels + 16, 0u); break;
+    }
+}
+
+void encodeTextureBlock(GLenum format, const uint32_t* texels, uint32_t* block) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: encodeColorBlock(texels, block, false, false); break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: encodeColorBlock(texels, block, false, true); break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            encodeAlphaBlock(texels, block);
+            encodeColorBlock(texels, block + 2, true, false);
+            break;
+        case GL_COMPRESSED_RGB8_ETC2: storeBigEndian64(encodeEtcColorBlock(texels), block); break;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            storeBigEndian64(encodeEacAlphaBlock(texels), block);
+            storeBigEndian64(encodeEtcColorBlock(texels), block + 2);
+            break;
+        case GL_RGBA8: std::copy(texels, texels + 16, block); break;
+        default: break;
+    }
+}
+
+void encodeTextureImage(GLenum format, const uint32_t* pixels, int w, int h, uint32_t* blocks) {
+    const int words = textureBlockWords(format);
+    if (words == 0 || w <= 0 || h <= 0) return;
+    const int blocksX = (w + 3) / 4, blocksY = (h + 3) / 4;
+    uint32_t texels[16];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            for (int ly = 0; ly < 4; ++ly) {
+                const int y = std::min(by * 4 + ly, h - 1);
+                for (int lx = 0; lx < 4; ++lx) {
+                    texels[ly * 4 + lx] = pixels[(size_t)y * w + std::min(bx * 4 + lx, w - 1)];
+                }
+            }
+            encodeTextureBlock(format, texels, blocks + ((size_t)by * blocksX + bx) * words);
+        }
+    }
+}
+
+const uint32_t* decodeTextureBlockCached(GLenum format, const uint32_t* block) {
+    DecodedBlockCache& cache = t_blockCache;
+    const uint32_t epoch = g_blockCacheEpoch.load(std::memory_order_relaxed);
+    // 块地址至少 8 字节对齐，Fibonacci 散列让同一行相邻的块落在不同槽位
+    const uint64_t key = (uint64_t)reinterpret_cast<uintptr_t>(block) >> 3;
+    const size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (TEXTURE_BLOCK_CACHE_SIZE - 1);
+    if (cache.tags[slot] != block || cache.epochs[slot] != epoch) {
+        decodeTextureBlock(format, block, cache.texels[slot]);
+        cache.tags[slot] = block;
+        cache.epochs[slot] = epoch;
+    }
+    return cache.texels[slot];
+}
+
+void invalidateDecodedBlocks() {
+    // 跳过 0 (空槽位标记)
+    if (g_blockCacheEpoch.fetch_add(1, std::memory_order_relaxed) + 1 == 0) g_blockCacheEpoch.store(1, std::memory_order_relaxed);
+}
+
+} // namespace tinygl
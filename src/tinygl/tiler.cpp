@@ -32,12 +32,6 @@ void TileBinningSystem::BinTriangle(const TriangleData& tri, uint16_t pipelineId
     float maxX = std::max({tri.p[0].x, tri.p[1].x, tri.p[2].x});
     float maxY = std::max({tri.p[0].y, tri.p[1].y, tri.p[2].y});
 
-    // Clip against screen bounds
-    int minTx = std::max(0, static_cast<int>(minX) / m_tileSize);
-    int minTy = std::max(0, static_cast<int>(minY) / m_tileSize);
-    int maxTx = std::min(m_gridWidth - 1, static_cast<int>(maxX) / m_tileSize);
-    int maxTy = std::min(m_gridHeight - 1, static_cast<int>(maxY) / m_tileSize);
-
     // 2. Add command to all covered tiles
     TileCommand cmd;
     cmd.type = TileCommand::DRAW_TRIANGLE;
@@ -45,6 +39,16 @@ void TileBinningSystem::BinTriangle(const TriangleData& tri, uint16_t pipelineId
     cmd.dataIndex = dataOffset;
     cmd.uniformOffset = uniformOffset;
 
+    BinRect(static_cast<int>(minX), static_cast<int>(minY), static_cast<int>(maxX), static_cast<int>(maxY), cmd);
+}
+
+void TileBinningSystem::BinRect(int minX, int minY, int maxX, int maxY, const TileCommand& cmd) {
+    // Clip against screen bounds
+    int minTx = std::max(0, minX / m_tileSize);
+    int minTy = std::max(0, minY / m_tileSize);
+    int maxTx = std::min(m_gridWidth - 1, maxX / m_tileSize);
+    int maxTy = std::min(m_gridHeight - 1, maxY / m_tileSize);
+
     for (int y = minTy; y <= maxTy; ++y) {
         for (int x = minTx; x <= maxTx; ++x) {
             // Note: simple bounding box binning is conservative.
@@ -52,7 +56,6 @@ void TileBinningSystem::BinTriangle(const TriangleData& tri, uint16_t pipelineId
             m_tiles[y * m_gridWidth + x].commands.push_back(cmd);
         }
     }
-    // LOG_INFO("Binned triangle to " + std::to_string((maxTx-minTx+1)*(maxTy-minTy+1)) + " tiles");
 }
 
 } // namespace tinygl
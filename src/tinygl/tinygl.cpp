@@ -22,6 +22,12 @@ void SoftRenderContext::glClearColor(float r, float g, float b, float a) {
 
 
 void SoftRenderContext::glClear(uint32_t buffersToClear) {
+    flushDeferredDraws();
+    if (m_boundFramebuffer) {
+        if (!refreshFramebufferAttachment()) return;
+        if (buffersToClear & GL_COLOR_BUFFER_BIT) framebuffers.get(m_boundFramebuffer)->dirty = true;
+    }
+
     int minX = 0, minY = 0, maxX = fbWidth, maxY = fbHeight;
     if (m_state.scissorTest) {
         minX = std::max(0, m_state.scissor.x);
@@ -32,54 +38,430 @@ void SoftRenderContext::glClear(uint32_t buffersToClear) {
 
     if (minX >= maxX || minY >= maxY) return;
 
-    bool fullClear = (minX == 0 && minY == 0 && maxX == fbWidth && maxY == fbHeight);
-
-    if (buffersToClear & GL_COLOR_BUFFER_BIT) {
-        uint8_t R = (uint8_t)(std::clamp(m_clearColor.x, 0.0f, 1.0f) * 255);
-        uint8_t G = (uint8_t)(std::clamp(m_clearColor.y, 0.0f, 1.0f) * 255);
-        uint8_t B = (uint8_t)(std::clamp(m_clearColor.z, 0.0f, 1.0f) * 255);
-        uint8_t A = (uint8_t)(std::clamp(m_clearColor.w, 0.0f, 1.0f) * 255);
-        uint32_t clearColorInt = (A << 24) | (B << 16) | (G << 8) | R;
-        
-        if (fullClear) {
-            std::fill_n(m_colorBufferPtr, fbWidth * fbHeight, clearColorInt);
+    uint8_t R = (uint8_t)(std::clamp(m_clearColor.x, 0.0f, 1.0f) * 255);
+    uint8_t G = (uint8_t)(std::clamp(m_clearColor.y, 0.0f, 1.0f) * 255);
+    uint8_t B = (uint8_t)(std::clamp(m_clearColor.z, 0.0f, 1.0f) * 255);
+    uint8_t A = (uint8_t)(std::clamp(m_clearColor.w, 0.0f, 1.0f) * 255);
+    uint32_t clearColorInt = (A << 24) | (B << 16) | (G << 8) | R;
+    // Color mask also affects glClear
+    uint32_t writeMask = (buffersToClear & GL_COLOR_BUFFER_BIT) ? m_state.colorWriteMask() : 0;
+    // NOTE: glClear is NOT affected by glDepthMask in standard OpenGL, 
+    // but it IS affected by it in some old versions. 
+    // OpenGL 4.6 says: "The masked subset of the color, depth, and stencil buffers are cleared"
+    // So we should respect the masks.
+    bool clearDepth = (buffersToClear & GL_DEPTH_BUFFER_BIT) && m_state.depthMask;
+    uint8_t stencilMask = (buffersToClear & GL_STENCIL_BUFFER_BIT) ? m_state.stencilWriteMask : 0;
+    uint8_t clearStencil = (uint8_t)(m_state.clearStencil & 0xFF);
+    if (writeMask == 0 && !clearDepth && stencilMask == 0) return;
+
+    // 快速清除：无掩码的清除对完整覆盖的 Tile 只记录清除值；带掩码或只覆盖部分 Tile 时先执行 Tile 的待定清除再直接写入
+    const uint8_t lazyBits = (writeMask == 0xFFFFFFFFu ? TILE_CLEAR_COLOR : 0) |
+                             (clearDepth ? TILE_CLEAR_DEPTH : 0) |
+                             (stencilMask == 0xFF ? TILE_CLEAR_STENCIL : 0);
+    const bool lazyAllowed = m_fastClear && (writeMask == 0 || writeMask == 0xFFFFFFFFu) && (stencilMask == 0 || stencilMask == 0xFF);
+
+    auto clearSpan = [&](uint32_t* p, size_t n) {
+        if (writeMask == 0xFFFFFFFFu) {
+            std::fill_n(p, n, clearColorInt);
         } else {
-            for (int y = minY; y < maxY; ++y) {
-                std::fill_n(m_colorBufferPtr + y * fbWidth + minX, maxX - minX, clearColorInt);
+            for (size_t i = 0; i < n; ++i) p[i] = maskedColor(clearColorInt, p[i], writeMask);
+        }
+    };
+
+    const DepthStencilView ds = depthStencilView();
+    const float hizDepth = ds.quantize(m_state.clearDepth);
+    const size_t S = m_sampleCount;
+    const int T = 1 << FRAMEBUFFER_TILE_SHIFT;
+    for (int ty = minY / T; ty <= (maxY - 1) / T; ++ty) {
+        for (int tx = minX / T; tx <= (maxX - 1) / T; ++tx) {
+            const int x0 = tx * T, y0 = ty * T;
+            const int x1 = std::min(x0 + T, (int)fbWidth), y1 = std::min(y0 + T, (int)fbHeight);
+            const int cx0 = std::max(x0, minX), cy0 = std::max(y0, minY);
+            const int cx1 = std::min(x1, maxX), cy1 = std::min(y1, maxY);
+            TileClearState& tile = m_clearTiles[ty * m_clearTilesX + tx];
+
+            if (lazyAllowed && cx0 == x0 && cy0 == y0 && cx1 == x1 && cy1 == y1) {
+                tile.pending |= lazyBits;
+                if (lazyBits & TILE_CLEAR_COLOR) tile.color = clearColorInt;
+                if (lazyBits & TILE_CLEAR_STENCIL) tile.stencil = clearStencil;
+                if (lazyBits & TILE_CLEAR_DEPTH) {
+                    tile.depth = m_state.clearDepth;
+                    for (int by = y0 / RASTER_BLOCK_SIZE; by <= (y1 - 1) / RASTER_BLOCK_SIZE; ++by) {
+                        float* row = hizBuffer.data() + by * m_hizWidth;
+                        std::fill(row + x0 / RASTER_BLOCK_SIZE, row + (x1 - 1) / RASTER_BLOCK_SIZE + 1, hizDepth);
+                    }
+                }
+                m_clearPending = true;
+                continue;
+            }
+
+            if (tile.pending) materializeTile(tx, ty);
+            if (writeMask != 0) {
+                if (m_sampleCount > 1) {
+                    // MSAA：清除多重采样缓冲，呈现时再 resolve
+                    uint32_t* samples = m_sampleColorBuffer.data();
+                    m_pixelLayout.forEachRun(cx0, cy0, cx1, cy1, [&](size_t offset, size_t n) {
+                        clearSpan(samples + offset * S, n * S);
+                    });
+                } else {
+                    m_colorLayout.forEachRun(cx0, cy0, cx1, cy1, [&](size_t offset, size_t n) {
+                        clearSpan(m_colorBufferPtr + offset, n);
+                    });
+                }
+            }
+            if (clearDepth || stencilMask) {
+                // 按深度格式清除；D24S8 的深度与模板在同一个字中一次写完
+                m_pixelLayout.forEachRun(cx0, cy0, cx1, cy1, [&](size_t offset, size_t n) {
+                    ds.clear(offset * S, n * S, clearDepth, m_state.clearDepth, stencilMask, clearStencil);
+                });
+                if (clearDepth) rebuildHiZ(cx0, cy0, cx1, cy1);
             }
         }
     }
-    if (buffersToClear & GL_DEPTH_BUFFER_BIT) {
-        // NOTE: glClear is NOT affected by glDepthMask in standard OpenGL, 
-        // but it IS affected by it in some old versions. 
-        // OpenGL 4.6 says: "The masked subset of the color, depth, and stencil buffers are cleared"
-        // So we should respect the masks.
-        if (m_state.depthMask) {
-            if (fullClear) {
-                std::fill(depthBuffer.begin(), depthBuffer.end(), m_state.clearDepth);
-            } else {
-                for (int y = minY; y < maxY; ++y) {
-                    std::fill_n(depthBuffer.data() + y * fbWidth + minX, maxX - minX, m_state.clearDepth);
-                }
+
+    if (writeMask != 0) {
+        if (m_sampleCount > 1) m_resolvePending = true;
+        else if (m_tiledFramebuffer && !m_boundFramebuffer) m_linearizePending = true;
+    }
+}
+
+void SoftRenderContext::materializeTile(int tx, int ty, uint8_t mask) {
+    TileClearState& tile = m_clearTiles[ty * m_clearTilesX + tx];
+    const uint8_t bits = tile.pending & mask;
+    if (!bits) return;
+    const int T = 1 << FRAMEBUFFER_TILE_SHIFT;
+    const int x0 = tx * T, y0 = ty * T;
+    const int x1 = std::min(x0 + T, (int)fbWidth), y1 = std::min(y0 + T, (int)fbHeight);
+    const size_t S = m_sampleCount;
+
+    if (bits & TILE_CLEAR_COLOR) {
+        uint32_t* target = S > 1 ? m_sampleColorBuffer.data() : m_colorBufferPtr;
+        const SurfaceLayout& layout = S > 1 ? m_pixelLayout : m_colorLayout;
+        if (target) {
+            layout.forEachRun(x0, y0, x1, y1, [&](size_t offset, size_t n) {
+                std::fill_n(target + offset * S, n * S, tile.color);
+            });
+        }
+    }
+    if (bits & (TILE_CLEAR_DEPTH | TILE_CLEAR_STENCIL)) {
+        const DepthStencilView ds = depthStencilView();
+        const bool depth = (bits & TILE_CLEAR_DEPTH) != 0;
+        const uint8_t stencilMask = (bits & TILE_CLEAR_STENCIL) ? 0xFF : 0;
+        m_pixelLayout.forEachRun(x0, y0, x1, y1, [&](size_t offset, size_t n) {
+            ds.clear(offset * S, n * S, depth, tile.depth, stencilMask, tile.stencil);
+        });
+    }
+    tile.pending &= ~bits;
+}
+
+void SoftRenderContext::materializeAllTiles() {
+    if (!m_clearPending) return;
+    // FBO 颜色附件的地址可能因纹理重新分配而失效，先重新获取 (附件无效时只执行深度/模板)
+    if (m_boundFramebuffer) refreshFramebufferAttachment();
+    for (int ty = 0; ty < m_clearTilesY; ++ty) {
+        for (int tx = 0; tx < m_clearTilesX; ++tx) materializeTile(tx, ty);
+    }
+    m_clearPending = false;
+}
+
+void SoftRenderContext::setDepthFormat(GLenum format) {
+    if (!isSupportedDepthFormat(format)) {
+        LOG_WARN("setDepthFormat: unsupported depth format " + std::to_string(format));
+        return;
+    }
+    if (format == m_depthFormat) return;
+    flushDeferredDraws();
+    materializeAllTiles();
+    m_depthFormat = format;
+    allocateDepthStencil(m_pixelLayout.size(fbHeight) * m_sampleCount);
+    std::fill(hizBuffer.begin(), hizBuffer.end(), depthStencilView().quantize(m_state.clearDepth));
+}
+
+void SoftRenderContext::allocateDepthStencil(size_t count) {
+    const float z = m_state.clearDepth;
+    const uint8_t s = (uint8_t)(m_state.clearStencil & 0xFF);
+    std::vector<float>().swap(depthBuffer);
+    std::vector<uint32_t>().swap(depthBuffer24);
+    std::vector<uint16_t>().swap(depthBuffer16);
+    std::vector<uint8_t>().swap(stencilBuffer);
+    switch (m_depthFormat) {
+        case GL_DEPTH_COMPONENT16: depthBuffer16.assign(count, (uint16_t)DepthStencilView::encode16(z)); break;
+        case GL_DEPTH_COMPONENT24: depthBuffer24.assign(count, DepthStencilView::encode24(z)); break;
+        case GL_DEPTH24_STENCIL8:  depthBuffer24.assign(count, (DepthStencilView::encode24(z) << 8) | s); break;
+        default:                   depthBuffer.assign(count, z); break;
+    }
+    if (m_depthFormat != GL_DEPTH24_STENCIL8) stencilBuffer.assign(count, s);
+}
+
+JobSystem* SoftRenderContext::acquireJobSystem() {
+    if (!m_jobSystem) {
+        m_jobSystem = std::make_unique<JobSystem>();
+        m_jobSystem->Init();
+    }
+    return m_jobSystem.get();
+}
+
+void SoftRenderContext::setParallelRasterEnabled(bool enabled) {
+    if (enabled == m_parallelRaster) return;
+    if (enabled) {
+        acquireJobSystem();
+        m_parallelTiler.Init(fbWidth, fbHeight, PARALLEL_TILE_SIZE);
+    } else {
+        glFinish();
+    }
+    m_parallelRaster = enabled;
+}
+
+void SoftRenderContext::glFinish() {
+    if (m_deferredDraws.empty()) return;
+
+    int gridW = m_parallelTiler.GetGridWidth();
+    int gridH = m_parallelTiler.GetGridHeight();
+    int tileSize = m_parallelTiler.GetTileSize();
+
+    // 每个 Tile 由一个 Worker 独占，Tile 内按录制顺序执行，保证逐像素的图元顺序
+    // Tile 与 Hi-Z 块对齐，深度/模板/颜色/Hi-Z 的写入都不会跨 Tile
+    m_jobSystem->ParallelFor(0, gridW * gridH, [&](int tileIndex) {
+        Tile& tile = m_parallelTiler.GetTile(tileIndex % gridW, tileIndex / gridW);
+        const std::vector<TileCommand>& cmds = tile.commands;
+        if (cmds.empty()) return;
+
+        Rect tileRect = { (tileIndex % gridW) * tileSize, (tileIndex / gridW) * tileSize, tileSize, tileSize };
+
+        // 同一 Draw 的连续命令一起提交，只拷贝一次 Shader
+        for (size_t i = 0; i < cmds.size();) {
+            size_t j = i + 1;
+            while (j < cmds.size() && cmds[j].pipelineId == cmds[i].pipelineId) ++j;
+
+            DeferredDrawBase& draw = *m_deferredDraws[cmds[i].pipelineId];
+            RasterState tileState = draw.state;
+            int x0 = tileRect.x, y0 = tileRect.y;
+            int x1 = tileRect.x + tileRect.w, y1 = tileRect.y + tileRect.h;
+            if (tileState.scissorTest) {
+                x0 = std::max(x0, tileState.scissor.x);
+                y0 = std::max(y0, tileState.scissor.y);
+                x1 = std::min(x1, tileState.scissor.x + tileState.scissor.w);
+                y1 = std::min(y1, tileState.scissor.y + tileState.scissor.h);
+            }
+            if (x0 < x1 && y0 < y1) {
+                tileState.scissorTest = true;
+                tileState.scissor = {x0, y0, x1 - x0, y1 - y0};
+                draw.rasterize(*this, &cmds[i], j - i, tileState);
             }
+            i = j;
         }
+    });
+
+    m_parallelTiler.Reset();
+    m_deferredDraws.clear();
+    m_deferredDrawOpen = false;
+    m_deferredTriangleCount = 0;
+}
+
+void SoftRenderContext::setSampleCount(int samples) {
+    if (m_boundFramebuffer) {
+        LOG_WARN("setSampleCount: only the default framebuffer can be multisampled; bind framebuffer 0 first.");
+        return;
     }
-    if (buffersToClear & GL_STENCIL_BUFFER_BIT) {
-        uint8_t s = (uint8_t)(m_state.clearStencil & 0xFF);
-        // Stencil mask also affects glClear
-        if (m_state.stencilWriteMask != 0) {
-             if (fullClear && m_state.stencilWriteMask == 0xFF) {
-                std::fill(stencilBuffer.begin(), stencilBuffer.end(), s);
-            } else {
-                for (int y = minY; y < maxY; ++y) {
-                    uint8_t* row = stencilBuffer.data() + y * fbWidth + minX;
-                    for (int x = 0; x < (maxX - minX); ++x) {
-                        row[x] = (row[x] & ~m_state.stencilWriteMask) | (s & m_state.stencilWriteMask);
-                    }
+    if (samples != 1 && samples != MSAA_SAMPLES) {
+        LOG_WARN("setSampleCount: unsupported sample count " + std::to_string(samples) + ", expected 1 or " + std::to_string(MSAA_SAMPLES));
+        return;
+    }
+    if (samples == m_sampleCount) return;
+    flushDeferredDraws();
+    materializeAllTiles();
+
+    const size_t pixels = m_pixelLayout.size(fbHeight);
+    if (samples > 1) {
+        // 当前颜色复制到每个采样点，保证开启 MSAA 前绘制的内容在 resolve 后不变
+        m_sampleCount = samples;
+        fillSamplesFromColor();
+    } else {
+        if (m_resolvePending) resolveMultisample();
+        std::vector<uint32_t>().swap(m_sampleColorBuffer);
+        m_sampleCount = samples;
+    }
+    m_resolvePending = false;
+
+    allocateDepthStencil(pixels * samples);
+    std::fill(hizBuffer.begin(), hizBuffer.end(), depthStencilView().quantize(m_state.clearDepth));
+}
+
+void SoftRenderContext::fillSamplesFromColor() {
+    const size_t pixels = m_pixelLayout.size(fbHeight);
+    const int S = m_sampleCount;
+    m_sampleColorBuffer.resize(pixels * S);
+    for (size_t i = 0; i < pixels; ++i) {
+        std::fill_n(m_sampleColorBuffer.data() + i * S, S, m_colorBufferPtr[i]);
+    }
+}
+
+// 每像素 4 个连续采样点 (16 字节)，按通道求和后 (sum + 2) >> 2 四舍五入
+static void resolveSpan(uint32_t* dst, const uint32_t* src, int pixels) {
+    int i = 0;
+#if defined(__ARM_NEON) || defined(__aarch64__)
+    for (; i + 2 <= pixels; i += 2) {
+        // 两个像素：ab = 像素 i 的 4 个采样点，cd = 像素 i + 1 的 4 个采样点
+        uint8x16_t ab = vld1q_u8((const uint8_t*)(src + i * 4));
+        uint8x16_t cd = vld1q_u8((const uint8_t*)(src + i * 4 + 4));
+        uint16x8_t sAB = vaddl_u8(vget_low_u8(ab), vget_high_u8(ab)); // s0+s2, s1+s3
+        uint16x8_t sCD = vaddl_u8(vget_low_u8(cd), vget_high_u8(cd));
+        uint16x4_t pA = vadd_u16(vget_low_u16(sAB), vget_high_u16(sAB));
+        uint16x4_t pC = vadd_u16(vget_low_u16(sCD), vget_high_u16(sCD));
+        uint8x8_t out = vrshrn_n_u16(vcombine_u16(pA, pC), 2);
+        vst1_u8((uint8_t*)(dst + i), out);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(2);
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i sum[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(src + (i + k) * 4));
+            __m128i s = _mm_add_epi16(_mm_unpacklo_epi8(p, zero), _mm_unpackhi_epi8(p, zero)); // s0+s2, s1+s3
+            sum[k] = _mm_add_epi16(s, _mm_srli_si128(s, 8));                                    // 低 64 位为 4 采样和
+        }
+        __m128i lo = _mm_unpacklo_epi64(sum[0], sum[1]);
+        __m128i hi = _mm_unpacklo_epi64(sum[2], sum[3]);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 2);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < pixels; ++i) {
+        const uint8_t* s = (const uint8_t*)(src + i * 4);
+        uint8_t* d = (uint8_t*)(dst + i);
+        for (int c = 0; c < 4; ++c) {
+            d[c] = (uint8_t)((s[c] + s[4 + c] + s[8 + c] + s[12 + c] + 2) >> 2);
+        }
+    }
+}
+
+void SoftRenderContext::resolveMultisample() {
+    static_assert(MSAA_SAMPLES == 4, "resolveMultisample assumes 4 samples per pixel");
+    m_resolvePending = false;
+    if (m_sampleCount <= 1) return;
+    if (m_tiledFramebuffer) m_linearizePending = true;
+
+    // 默认帧缓冲的颜色与采样缓冲布局相同；按 Tile 处理，颜色仍待快速清除的 Tile 直接写入清除值
+    const uint32_t* src = m_sampleColorBuffer.data();
+    uint32_t* dst = m_colorBufferPtr;
+    const int T = 1 << FRAMEBUFFER_TILE_SHIFT;
+    for (int ty = 0; ty < m_clearTilesY; ++ty) {
+        for (int tx = 0; tx < m_clearTilesX; ++tx) {
+            const TileClearState& tile = m_clearTiles[ty * m_clearTilesX + tx];
+            const int x0 = tx * T, y0 = ty * T;
+            const int x1 = std::min(x0 + T, (int)fbWidth), y1 = std::min(y0 + T, (int)fbHeight);
+            m_pixelLayout.forEachRun(x0, y0, x1, y1, [&](size_t offset, size_t n) {
+                if (tile.pending & TILE_CLEAR_COLOR) {
+                    std::fill_n(dst + offset, n, tile.color);
+                } else {
+                    resolveSpan(dst + offset, src + offset * MSAA_SAMPLES, (int)n);
+                }
+            });
+        }
+    }
+}
+
+// 32-bit 像素的连续拷贝，每次 4 像素 (16 字节)
+static inline void copyPixels(uint32_t* dst, const uint32_t* src, int n) {
+    int i = 0;
+#if defined(__ARM_NEON) || defined(__aarch64__)
+    for (; i + 4 <= n; i += 4) vst1q_u32(dst + i, vld1q_u32(src + i));
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128((__m128i*)(dst + i), _mm_loadu_si128((const __m128i*)(src + i)));
+#endif
+    for (; i < n; ++i) dst[i] = src[i];
+}
+
+void SoftRenderContext::linearizeColorBuffer(bool toLinear) {
+    m_linearizePending = false;
+    if (!m_tiledFramebuffer) return;
+    // FBO 绑定期间默认帧缓冲保存在 m_defaultSurface 中
+    const bool fboBound = m_boundFramebuffer != 0;
+    uint32_t* tiled = fboBound ? m_defaultSurface.color : m_colorBufferPtr;
+    const SurfaceLayout& layout = fboBound ? m_defaultSurface.colorLayout : m_colorLayout;
+    const std::vector<TileClearState>& tiles = fboBound ? m_defaultSurface.clearTiles : m_clearTiles;
+    const int tilesX = fboBound ? m_defaultSurface.clearTilesX : m_clearTilesX;
+    const int w = fboBound ? m_defaultSurface.width : fbWidth;
+    const int h = fboBound ? m_defaultSurface.height : fbHeight;
+    uint32_t* linear = m_presentBufferPtr;
+
+    // 每个 Tile 行在两侧都是连续内存，整行 SIMD 拷贝；从未绘制的 Tile 直接以清除值填充呈现缓冲
+    const int T = 1 << FRAMEBUFFER_TILE_SHIFT;
+    for (int y0 = 0; y0 < h; y0 += T) {
+        for (int x0 = 0; x0 < w; x0 += T) {
+            const TileClearState& tile = tiles[(y0 / T) * tilesX + x0 / T];
+            const bool cleared = toLinear && (tile.pending & TILE_CLEAR_COLOR);
+            layout.forEachSpan(x0, y0, std::min(x0 + T, w), std::min(y0 + T, h), [&](size_t offset, int x, int y, int n) {
+                uint32_t* row = linear + (size_t)y * w + x;
+                if (cleared) {
+                    std::fill_n(row, n, tile.color);
+                } else if (toLinear) {
+                    copyPixels(row, tiled + offset, n);
+                } else {
+                    copyPixels(tiled + offset, row, n);
+                }
+            });
+        }
+    }
+}
+
+void SoftRenderContext::storeColorBuffer(bool force) {
+    // FBO 绑定期间默认帧缓冲已在绑定前 resolve，只可能因为 setExternalBuffer 需要重新线性化
+    if (!m_boundFramebuffer) {
+        if (m_resolvePending || (force && m_sampleCount > 1)) {
+            resolveMultisample();
+        } else if (m_clearPending && m_sampleCount == 1 && !m_tiledFramebuffer) {
+            // 行主序单采样：颜色存储就是呈现缓冲，直接写入仍待快速清除的 Tile。
+            // 同一 Tile 行中清除值相同的相邻 Tile 合并为整段，逐行一次填充
+            const int T = 1 << FRAMEBUFFER_TILE_SHIFT;
+            for (int ty = 0; ty < m_clearTilesY; ++ty) {
+                TileClearState* tiles = m_clearTiles.data() + ty * m_clearTilesX;
+                const int y0 = ty * T, y1 = std::min(y0 + T, (int)fbHeight);
+                for (int tx = 0; tx < m_clearTilesX;) {
+                    if (!(tiles[tx].pending & TILE_CLEAR_COLOR)) { ++tx; continue; }
+                    const uint32_t color = tiles[tx].color;
+                    int end = tx;
+                    do {
+                        tiles[end++].pending &= ~TILE_CLEAR_COLOR;
+                    } while (end < m_clearTilesX && (tiles[end].pending & TILE_CLEAR_COLOR) && tiles[end].color == color);
+                    const int x0 = tx * T, x1 = std::min(end * T, (int)fbWidth);
+                    for (int y = y0; y < y1; ++y) std::fill_n(m_colorBufferPtr + (size_t)y * fbWidth + x0, x1 - x0, color);
+                    tx = end;
                 }
             }
         }
     }
+    if (m_linearizePending || (force && m_tiledFramebuffer && !m_boundFramebuffer)) linearizeColorBuffer();
+}
+
+void SoftRenderContext::updateHiZBlock(int bx, int by) {
+    int x0 = bx * RASTER_BLOCK_SIZE;
+    int y0 = by * RASTER_BLOCK_SIZE;
+    int x1 = std::min(x0 + RASTER_BLOCK_SIZE, (int)fbWidth);
+    int y1 = std::min(y0 + RASTER_BLOCK_SIZE, (int)fbHeight);
+
+    // MSAA 下取块内所有采样点的最大深度
+    const int S = m_sampleCount;
+    const DepthStencilView ds = depthStencilView();
+    float maxZ = -DEPTH_INFINITY;
+    for (int y = y0; y < y1; ++y) {
+        // 块不会跨越分块布局的 Tile，一行的采样点连续
+        const size_t row = m_pixelLayout.index(x0, y) * S;
+        for (size_t i = 0; i < (size_t)(x1 - x0) * S; ++i) {
+            maxZ = std::max(maxZ, ds.load(row + i));
+        }
+    }
+    hizBuffer[by * m_hizWidth + bx] = maxZ;
+}
+
+void SoftRenderContext::rebuildHiZ(int minX, int minY, int maxX, int maxY) {
+    for (int by = minY / RASTER_BLOCK_SIZE; by <= (maxY - 1) / RASTER_BLOCK_SIZE; ++by) {
+        for (int bx = minX / RASTER_BLOCK_SIZE; bx <= (maxX - 1) / RASTER_BLOCK_SIZE; ++bx) {
+            updateHiZBlock(bx, by);
+        }
+    }
 }
 
 void SoftRenderContext::printContextState() {
@@ -154,6 +536,7 @@ void SoftRenderContext::printContextState() {
             LOG_INFO("  Texture #" + std::to_string(i) + 
                      ": " + std::to_string(tex->width) + "x" + std::to_string(tex->height) + 
                      ", MipLevels=" + std::to_string(tex->mipLevels.size()) +
+                     ", Format=" + std::to_string(tex->format) +
                      ", WrapS=" + std::to_string(tex->wrapS) +
                      ", WrapT=" + std::to_string(tex->wrapT) +
                      ", MinFilter=" + std::to_string(tex->minFilter) + 
@@ -174,6 +557,14 @@ void SoftRenderContext::printContextState() {
     LOG_INFO("Depth Test Enabled: " + std::string(m_state.depthTest ? "TRUE" : "FALSE"));
     LOG_INFO("Depth Mask: " + std::string(m_state.depthMask ? "TRUE" : "FALSE"));
     LOG_INFO("Depth Func: " + std::to_string(m_state.depthFunc));
+    LOG_INFO("Color Mask (RGBA): " + std::to_string(m_state.colorMask[0]) + ", " +
+             std::to_string(m_state.colorMask[1]) + ", " +
+             std::to_string(m_state.colorMask[2]) + ", " +
+             std::to_string(m_state.colorMask[3]));
+    LOG_INFO("MSAA Samples: " + std::to_string(m_sampleCount));
+    LOG_INFO("Depth Format: " + GLenumToString(m_depthFormat));
+    LOG_INFO("Tiled Framebuffer: " + std::string(m_tiledFramebuffer ? "TRUE" : "FALSE"));
+    LOG_INFO("Bound Framebuffer: " + std::to_string(m_boundFramebuffer));
     
     LOG_INFO("Stencil Test Enabled: " + std::string(m_state.stencilTest ? "TRUE" : "FALSE"));
     LOG_INFO("Stencil Func: " + std::to_string(m_state.stencilFunc) + 
@@ -186,6 +577,15 @@ void SoftRenderContext::printContextState() {
     LOG_INFO("Stencil Write Mask: " + std::to_string(m_state.stencilWriteMask));
     
     LOG_INFO("Cull Face Enabled: " + std::string(m_state.cullFace ? "TRUE" : "FALSE"));
+    LOG_INFO("Parallel Raster: " + std::string(m_parallelRaster ? "TRUE" : "FALSE") +
+             ", Deferred Draws: " + std::to_string(m_deferredDraws.size()));
+
+    LOG_INFO("--- Vertex Cache ---");
+    const VertexCacheStats& vcStats = m_vertexCache.getStats();
+    LOG_INFO("Enabled: " + std::string(m_vertexCacheEnabled ? "TRUE" : "FALSE") +
+             ", Hits: " + std::to_string(vcStats.hits) +
+             ", Misses: " + std::to_string(vcStats.misses) +
+             ", HitRate: " + std::to_string(vcStats.hitRate()));
     LOG_INFO("=============================");
 }
 
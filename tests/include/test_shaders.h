@@ -0,0 +1,74 @@
+#pragma once
+#include <tinygl/tinygl.h>
+
+namespace tests {
+
+// 顶点色着色器：位置 (attrib 0) 经 mvp 变换，颜色 (attrib 1) 作为唯一的 Varying 插值输出
+struct VertexColorShader : public tinygl::ShaderBuiltins {
+    static constexpr int kVaryings = 1; // Color
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = false;
+    tinygl::SimdMat4 mvp;
+
+    VertexColorShader() { mvp.load(tinygl::Mat4::Identity()); }
+
+    void vertex(const tinygl::Vec4* attribs, tinygl::ShaderContext& outCtx) {
+        outCtx.varyings[0] = attribs[1];
+        float posArr[4] = {attribs[0].x, attribs[0].y, attribs[0].z, 1.0f};
+        float outArr[4];
+        mvp.transformPoint(tinygl::Simd4f::load(posArr)).store(outArr);
+        gl_Position = tinygl::Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+    }
+
+    void fragment(const tinygl::ShaderContext& inCtx) {
+        gl_FragColor = inCtx.varyings[0];
+    }
+};
+
+// 单色着色器：位置 (attrib 0) 经 mvp 变换，片元输出统一的 color，没有 Varying
+// 供只关心覆盖、深度或混合结果的离屏检查与演示共用
+struct FlatColorShader : public tinygl::ShaderBuiltins {
+    static constexpr int kVaryings = 0;
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = false;
+    tinygl::SimdMat4 mvp;
+    tinygl::Vec4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    FlatColorShader() { mvp.load(tinygl::Mat4::Identity()); }
+
+    void vertex(const tinygl::Vec4* attribs, tinygl::ShaderContext&) {
+        float posArr[4] = {attribs[0].x, attribs[0].y, attribs[0].z, 1.0f};
+        float outArr[4];
+        mvp.transformPoint(tinygl::Simd4f::load(posArr)).store(outArr);
+        gl_Position = tinygl::Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+    }
+
+    void fragment(const tinygl::ShaderContext&) {
+        gl_FragColor = color;
+    }
+};
+
+// 纹理着色器：位置 (attrib 0) 经 mvp 变换，UV (attrib 1) 插值后按 rho 选择 Mip 采样 texture
+struct TexturedShader : public tinygl::ShaderBuiltins {
+    static constexpr int kVaryings = 1; // UV
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = false;
+    tinygl::TextureObject* texture = nullptr;
+    tinygl::SimdMat4 mvp;
+
+    TexturedShader() { mvp.load(tinygl::Mat4::Identity()); }
+
+    void vertex(const tinygl::Vec4* attribs, tinygl::ShaderContext& outCtx) {
+        outCtx.varyings[0] = attribs[1];
+        float posArr[4] = {attribs[0].x, attribs[0].y, attribs[0].z, 1.0f};
+        float outArr[4];
+        mvp.transformPoint(tinygl::Simd4f::load(posArr)).store(outArr);
+        gl_Position = tinygl::Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+    }
+
+    void fragment(const tinygl::ShaderContext& inCtx) {
+        gl_FragColor = texture->sample(inCtx.varyings[0].x, inCtx.varyings[0].y, inCtx.rho);
+    }
+};
+
+} // namespace tests
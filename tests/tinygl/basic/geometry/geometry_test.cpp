@@ -47,6 +47,8 @@ class GeometryTest : public ITinyGLTestCase {
     float rotationSpeed = 30.0f; // Degrees per second
     size_t indexCount = 0;
     int lastShape = -1;
+    int useVertexCache = 1;
+    VertexCacheStats cacheStats;
     Camera camera;
 
     void updateGeometry(SoftRenderContext& ctx) {
@@ -144,6 +146,13 @@ public:
         snprintf(buf, sizeof(buf), "Vertices: %zu", indexCount);
         mu_label(ctx, buf);
 
+        mu_checkbox(ctx, "Vertex Cache", &useVertexCache);
+        snprintf(buf, sizeof(buf), "VS Invocations: %llu / %llu",
+                 (unsigned long long)cacheStats.misses, (unsigned long long)(cacheStats.hits + cacheStats.misses));
+        mu_label(ctx, buf);
+        snprintf(buf, sizeof(buf), "Cache Hit Rate: %.1f%%", cacheStats.hitRate() * 100.0f);
+        mu_label(ctx, buf);
+
         snprintf(buf, sizeof(buf), "Pos: %.2f, %.2f, %.2f", camera.position.x, camera.position.y, camera.position.z);
         mu_label(ctx, buf);
     }
@@ -166,7 +175,11 @@ public:
         
         ctx.glEnable(GL_DEPTH_TEST);
         ctx.glBindVertexArray(vao);
+        ctx.setVertexCacheEnabled(useVertexCache != 0);
+        ctx.resetVertexCacheStats();
         ctx.glDrawElements(shader, GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, 0);
+        cacheStats = ctx.getVertexCacheStats();
+        ctx.setVertexCacheEnabled(true);
     }
 };
 
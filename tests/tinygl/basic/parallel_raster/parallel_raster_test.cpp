@@ -0,0 +1,158 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// 顺序敏感的混合场景：一圈互相重叠的半透明三角形 (SRC_ALPHA, ONE_MINUS_SRC_ALPHA)，
+// 再叠加顶点落在视口外的大三角形 (ADDITIVE)：前三个在 Guard Band 内不裁剪、横跨所有分箱 Tile，最后一个越过 Guard Band 需要裁剪
+class ParallelScene {
+public:
+    static constexpr int FAN_TRIANGLES = 16;
+    static constexpr int LARGE_TRIANGLES = 4;
+
+    void init(SoftRenderContext& ctx) {
+        std::vector<float> vertices;
+        auto push = [&](float x, float y, float z, float r, float g, float b, float a) {
+            const float v[] = {x, y, z, r, g, b, a};
+            vertices.insert(vertices.end(), std::begin(v), std::end(v));
+        };
+        for (int i = 0; i < FAN_TRIANGLES; ++i) {
+            float a = i * 6.2831853f / FAN_TRIANGLES;
+            float r = 0.5f + 0.5f * std::cos(a), g = 0.5f + 0.5f * std::sin(a), b = (i % 2) ? 0.9f : 0.1f;
+            push(0.1f * std::cos(a * 3.0f), 0.1f * std::sin(a * 3.0f), 0.0f, r, g, b, 0.6f);
+            push(std::cos(a) * 0.95f, std::sin(a) * 0.95f, 0.0f, r, g, b, 0.6f);
+            push(std::cos(a + 1.7f) * 0.95f, std::sin(a + 1.7f) * 0.95f, 0.0f, g, b, r, 0.6f);
+        }
+        push(-2.7f, -2.7f, 0.0f, 0.3f, 0.0f, 0.0f, 0.5f);
+        push(3.3f, -1.9f, 0.0f, 0.0f, 0.3f, 0.0f, 0.5f);
+        push(0.2f, 3.2f, 0.0f, 0.0f, 0.0f, 0.3f, 0.5f);
+        push(-2.5f, 2.9f, 0.0f, 0.2f, 0.2f, 0.0f, 0.5f);
+        push(-3.6f, -1.3f, 0.0f, 0.0f, 0.2f, 0.2f, 0.5f);
+        push(3.9f, 0.7f, 0.0f, 0.2f, 0.0f, 0.2f, 0.5f);
+        push(-0.73f, -3.1f, 0.0f, 0.1f, 0.1f, 0.1f, 0.5f);
+        push(2.6f, 2.6f, 0.0f, 0.1f, 0.2f, 0.1f, 0.5f);
+        push(-1.9f, 0.37f, 0.0f, 0.2f, 0.1f, 0.1f, 0.5f);
+        push(-9.0f, -0.4f, 0.0f, 0.1f, 0.1f, 0.2f, 0.5f);
+        push(7.0f, -6.0f, 0.0f, 0.1f, 0.1f, 0.2f, 0.5f);
+        push(0.5f, 8.0f, 0.0f, 0.1f, 0.1f, 0.2f, 0.5f);
+
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, false, 7 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 4, GL_FLOAT, false, 7 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, float angle) {
+        ctx.glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glEnable(GL_BLEND);
+        ctx.glBindVertexArray(m_vao);
+        m_shader.mvp.load(Mat4::RotateZ(angle));
+
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, FAN_TRIANGLES * 3);
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, FAN_TRIANGLES * 3, LARGE_TRIANGLES * 3);
+        // 再画一遍扇形：结果依赖于与上面大三角形的先后顺序
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, FAN_TRIANGLES * 3);
+
+        ctx.glDisable(GL_BLEND);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0;
+    tests::VertexColorShader m_shader;
+};
+
+class ParallelRasterTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyParallel();
+    }
+
+    // 离屏验证：尺寸不是 PARALLEL_TILE_SIZE 的整数倍，并行立即模式与串行光栅化的帧缓冲必须逐像素一致
+    void verifyParallel() {
+        const int w = 300, h = 200;
+        SoftRenderContext ctx(w, h);
+        ParallelScene scene;
+        scene.init(ctx);
+
+        bool allMatch = true;
+        int firstMismatch = -1;
+        for (float angle : {0.0f, 10.0f, 47.0f}) {
+            ctx.setParallelRasterEnabled(false);
+            scene.render(ctx, angle);
+            std::vector<uint32_t> serial(ctx.getColorBuffer(), ctx.getColorBuffer() + w * h);
+
+            ctx.setParallelRasterEnabled(true);
+            scene.render(ctx, angle);
+            const uint32_t* parallel = ctx.getColorBuffer();
+            for (int i = 0; i < w * h && firstMismatch < 0; ++i) {
+                if (parallel[i] != serial[i]) firstMismatch = i;
+            }
+            allMatch = allMatch && firstMismatch < 0;
+        }
+
+        ctx.setParallelRasterEnabled(false);
+        scene.destroy(ctx);
+
+        if (allMatch) {
+            std::cout << "Parallel Raster Test: parallel and serial framebuffers identical (" << w << "x" << h << ")" << std::endl;
+        } else {
+            std::cerr << "Test Failed: parallel raster differs from serial at pixel (" << firstMismatch % w << ", "
+                      << firstMismatch / w << ")" << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+        ctx.setParallelRasterEnabled(false);
+    }
+
+    void onUpdate(float dt) override {
+        m_angle += dt * 20.0f;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Parallel Immediate Mode");
+
+        int parallel = m_parallel ? 1 : 0;
+        if (mu_checkbox(ctx, "Parallel Raster", &parallel)) m_parallel = parallel != 0;
+        mu_label(ctx, "The image must not change when toggling.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        if (ctx.isParallelRasterEnabled() != m_parallel) ctx.setParallelRasterEnabled(m_parallel);
+        m_scene.render(ctx, m_angle);
+        ctx.glFinish();
+    }
+
+private:
+    ParallelScene m_scene;
+    bool m_parallel = true;
+    float m_angle = 0.0f;
+};
+
+static TestRegistrar registrar("Basic", "ParallelRaster", []() -> ITinyGLTestCase* { return new ParallelRasterTest(); });
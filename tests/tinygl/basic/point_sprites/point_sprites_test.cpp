@@ -0,0 +1,278 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// 点精灵：gl_PointSize 由粒子大小按透视缩放，片元用 gl_PointCoord 做圆形软边
+struct SpriteShader : public ShaderBuiltins {
+    static constexpr int kVaryings = 1; // Color
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = true;
+    SimdMat4 mvp;
+    float pixelScale = 1.0f; // 视口高度 / (2 * tan(fov / 2))：世界尺寸 -> 像素
+    bool round = true;       // false 时直接输出 gl_PointCoord (用于验证)
+
+    void vertex(const Vec4* attribs, ShaderContext& outCtx) {
+        outCtx.varyings[0] = attribs[1];
+        float posArr[4] = {attribs[0].x, attribs[0].y, attribs[0].z, 1.0f};
+        float outArr[4];
+        mvp.transformPoint(Simd4f::load(posArr)).store(outArr);
+        gl_Position = Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+        gl_PointSize = attribs[2].x * pixelScale / outArr[3];
+    }
+
+    void fragment(const ShaderContext& inCtx) {
+        if (!round) {
+            gl_FragColor = Vec4(gl_PointCoord.x, gl_PointCoord.y, 0.0f, 1.0f);
+            return;
+        }
+        float dx = gl_PointCoord.x * 2.0f - 1.0f;
+        float dy = gl_PointCoord.y * 2.0f - 1.0f;
+        float r2 = dx * dx + dy * dy;
+        if (r2 > 1.0f) {
+            discard();
+            return;
+        }
+        Vec4 c = inCtx.varyings[0];
+        gl_FragColor = Vec4(c.x, c.y, c.z, 1.0f - r2);
+    }
+};
+
+// 粒子喷泉：每帧在 CPU 上积分后整体上传，一次 GL_POINTS 绘制
+class ParticleScene {
+public:
+    static constexpr int FLOATS_PER_PARTICLE = 7; // Position (3) + Color (3) + Size (1)
+
+    void init(SoftRenderContext& ctx, int count) {
+        m_particles.resize(count);
+        for (int i = 0; i < count; ++i) respawn(m_particles[i], (float)i / count * LIFETIME);
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        const GLsizei stride = FLOATS_PER_PARTICLE * sizeof(float);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+        ctx.glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(2);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void update(float dt) {
+        for (Particle& p : m_particles) {
+            advance(p, dt);
+            if (p.age >= LIFETIME) respawn(p, p.age - LIFETIME);
+        }
+    }
+
+    void render(SoftRenderContext& ctx, const Mat4& mvp, float pixelScale, float sizeScale) {
+        m_vertices.clear();
+        for (const Particle& p : m_particles) {
+            float fade = 1.0f - p.age / LIFETIME;
+            const float v[FLOATS_PER_PARTICLE] = {p.pos.x, p.pos.y, p.pos.z, p.color.x * fade, p.color.y * fade, p.color.z * fade,
+                                                  p.size * sizeScale};
+            m_vertices.insert(m_vertices.end(), v, v + FLOATS_PER_PARTICLE);
+        }
+        ctx.glBindVertexArray(m_vao);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), m_vertices.data(), GL_DYNAMIC_DRAW);
+
+        // 加法混合，不写深度 (粒子之间无需排序)
+        ctx.glEnable(GL_PROGRAM_POINT_SIZE);
+        ctx.glEnable(GL_BLEND);
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        ctx.glDisable(GL_DEPTH_TEST);
+        m_shader.mvp.load(mvp);
+        m_shader.pixelScale = pixelScale;
+        ctx.glDrawArrays(m_shader, GL_POINTS, 0, (GLsizei)m_particles.size());
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glDisable(GL_BLEND);
+        ctx.glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+
+    int count() const { return (int)m_particles.size(); }
+
+private:
+    static constexpr float LIFETIME = 3.0f;
+
+    struct Particle {
+        Vec4 pos, vel, color;
+        float size = 0.1f;
+        float age = 0.0f;
+    };
+
+    void respawn(Particle& p, float age) {
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        p.pos = Vec4(0.0f, -1.0f, 0.0f, 0.0f);
+        p.vel = Vec4(u(m_rng) * 0.6f, 3.0f + u(m_rng) * 0.5f, u(m_rng) * 0.6f, 0.0f);
+        p.color = Vec4(1.0f, 0.5f + 0.3f * u(m_rng), 0.2f, 1.0f);
+        p.size = 0.08f + 0.04f * u(m_rng);
+        p.age = 0.0f;
+        advance(p, age);
+    }
+
+    // 重力 g = 3 下的匀加速运动
+    static void advance(Particle& p, float dt) {
+        p.age += dt;
+        p.pos = p.pos + p.vel * dt + Vec4(0.0f, -1.5f * dt * dt, 0.0f, 0.0f);
+        p.vel.y -= 3.0f * dt;
+    }
+
+    std::vector<Particle> m_particles;
+    std::vector<float> m_vertices;
+    std::mt19937 m_rng{7};
+    GLuint m_vao = 0, m_vbo = 0;
+    SpriteShader m_shader;
+};
+
+class PointSpritesTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx, m_count);
+        verifySprites();
+    }
+
+    // 离屏验证 (64x64，屏幕中心一个点)：
+    // 1. GL_PROGRAM_POINT_SIZE 下 gl_PointSize = 16 覆盖 16x16 像素，gl_PointCoord 从左上角 (0, 0) 增长到右下角 (1, 1)
+    // 2. 关闭 GL_PROGRAM_POINT_SIZE 后改用 glPointSize(4)
+    // 3. 圆形精灵 discard 四角，覆盖面积约为 pi * 8^2
+    void verifySprites() {
+        const int size = 64;
+        SoftRenderContext ctx(size, size);
+        const float point[] = {0.0f, 0.0f, 0.0f,   1.0f, 1.0f, 1.0f,   16.0f};
+        GLuint vao = 0, vbo = 0;
+        ctx.glGenVertexArrays(1, &vao);
+        ctx.glBindVertexArray(vao);
+        ctx.glGenBuffers(1, &vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(point), point, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+        ctx.glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(6 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(2);
+
+        SpriteShader shader;
+        shader.mvp.load(Mat4::Identity());
+        auto draw = [&](bool programPointSize, bool round) {
+            ctx.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            if (programPointSize) ctx.glEnable(GL_PROGRAM_POINT_SIZE); else ctx.glDisable(GL_PROGRAM_POINT_SIZE);
+            shader.round = round;
+            ctx.glDrawArrays(shader, GL_POINTS, 0, 1);
+            return ctx.getColorBuffer();
+        };
+        auto coverage = [&](const uint32_t* pixels, int& minX, int& minY, int& maxX, int& maxY) {
+            int covered = 0;
+            minX = minY = size;
+            maxX = maxY = -1;
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    if (pixels[y * size + x] == pixels[0]) continue;
+                    ++covered;
+                    minX = std::min(minX, x); maxX = std::max(maxX, x);
+                    minY = std::min(minY, y); maxY = std::max(maxY, y);
+                }
+            }
+            return covered;
+        };
+
+        bool ok = true;
+        int minX, minY, maxX, maxY;
+        const uint32_t* pixels = draw(true, false);
+        int covered = coverage(pixels, minX, minY, maxX, maxY);
+        Vec4 topLeft = ColorUtils::Uint32ToFloat(pixels[minY * size + minX]);
+        Vec4 bottomRight = ColorUtils::Uint32ToFloat(pixels[maxY * size + maxX]);
+        if (maxX - minX + 1 != 16 || maxY - minY + 1 != 16 || covered != 16 * 16 ||
+            topLeft.x > 0.1f || topLeft.y > 0.1f || bottomRight.x < 0.9f || bottomRight.y < 0.9f) {
+            std::cerr << "Test Failed: gl_PointSize sprite covers " << (maxX - minX + 1) << "x" << (maxY - minY + 1)
+                      << ", gl_PointCoord top-left (" << topLeft.x << ", " << topLeft.y << ") bottom-right ("
+                      << bottomRight.x << ", " << bottomRight.y << ")" << std::endl;
+            ok = false;
+        }
+
+        ctx.glPointSize(4.0f);
+        covered = coverage(draw(false, false), minX, minY, maxX, maxY);
+        if (maxX - minX + 1 != 4 || maxY - minY + 1 != 4) {
+            std::cerr << "Test Failed: glPointSize(4) sprite covers " << (maxX - minX + 1) << "x" << (maxY - minY + 1) << std::endl;
+            ok = false;
+        }
+        ctx.glPointSize(1.0f);
+
+        covered = coverage(draw(true, true), minX, minY, maxX, maxY);
+        if (covered < 180 || covered > 230) {
+            std::cerr << "Test Failed: round sprite covers " << covered << " pixels (expected about 201)" << std::endl;
+            ok = false;
+        }
+
+        ctx.glDisable(GL_PROGRAM_POINT_SIZE);
+        ctx.glDeleteBuffers(1, &vbo);
+        ctx.glDeleteVertexArrays(1, &vao);
+        if (ok) std::cout << "Point Sprites Test: gl_PointSize, glPointSize and gl_PointCoord verified" << std::endl;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onUpdate(float dt) override {
+        if (m_animate) m_scene.update(dt);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Point Sprite Particles");
+
+        int animate = m_animate ? 1 : 0;
+        if (mu_checkbox(ctx, "Animate", &animate)) m_animate = animate != 0;
+        mu_label(ctx, "Size Scale");
+        mu_slider(ctx, &m_sizeScale, 0.25f, 4.0f);
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Particles: %d", m_scene.count());
+        mu_label(ctx, buf);
+        snprintf(buf, sizeof(buf), "Draw: %.3f ms", m_lastMs);
+        mu_label(ctx, buf);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        const auto& vp = ctx.glGetViewport();
+        const float fov = 45.0f;
+        Mat4 proj = Mat4::Perspective(fov, (float)vp.w / (float)vp.h, 0.1f, 100.0f);
+        Mat4 view = Mat4::LookAt(Vec4(0.0f, 1.0f, 5.0f, 1.0f), Vec4(0.0f, 0.5f, 0.0f, 1.0f), Vec4(0.0f, 1.0f, 0.0f, 0.0f));
+        const float pixelScale = (float)vp.h / (2.0f * std::tan(fov * 0.5f * 3.14159265f / 180.0f));
+
+        ctx.glClearColor(0.02f, 0.02f, 0.05f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto start = std::chrono::high_resolution_clock::now();
+        m_scene.render(ctx, proj * view, pixelScale, m_sizeScale);
+        ctx.glFinish();
+        auto end = std::chrono::high_resolution_clock::now();
+        m_lastMs = std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+private:
+    ParticleScene m_scene;
+    int m_count = 2000;
+    bool m_animate = true;
+    float m_sizeScale = 1.0f;
+    float m_lastMs = 0.0f;
+};
+
+static TestRegistrar registrar("Basic", "PointSprites", []() -> ITinyGLTestCase* { return new PointSpritesTest(); });
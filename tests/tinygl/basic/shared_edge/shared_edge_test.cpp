@@ -0,0 +1,160 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+struct HalfAlphaShader : public ShaderBuiltins {
+    Vec4 color = {1.0f, 1.0f, 1.0f, 0.5f};
+
+    void vertex(const Vec4* attribs, ShaderContext&) {
+        gl_Position = Vec4(attribs[0].x, attribs[0].y, 0.0f, 1.0f);
+    }
+
+    void fragment(const ShaderContext&) {
+        gl_FragColor = color;
+    }
+};
+
+// 以 (cx, cy) 为中心的三角形扇覆盖整个视口，相邻三角形共享从中心出发的边。
+// 加法混合 (SRC_ALPHA, ONE) 下每次覆盖使 R 通道增加 128：恰好覆盖一次为 128，重复覆盖为 255，遗漏为 0
+class SharedEdgeScene {
+public:
+    void init(SoftRenderContext& ctx) {
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    // cx, cy 为窗口坐标 (像素)，spokes 条辐条均匀落在视口边框上，phase 为起点沿边框的偏移 (0..1)
+    void render(SoftRenderContext& ctx, int w, int h, float cx, float cy, int spokes, float phase) {
+        std::vector<Vec4> rim;
+        const float perimeter = 2.0f * (w + h);
+        for (int i = 0; i < spokes; ++i) {
+            float t = std::fmod((i + phase) * perimeter / spokes, perimeter);
+            if (t < w) rim.push_back(Vec4(t, 0, 0, 0));
+            else if ((t -= w) < h) rim.push_back(Vec4((float)w, t, 0, 0));
+            else if ((t -= h) < w) rim.push_back(Vec4(w - t, (float)h, 0, 0));
+            else rim.push_back(Vec4(0, h - (t - w), 0, 0));
+        }
+        // 四个角必须在扇上，否则扇形无法覆盖整个视口
+        const Vec4 corners[4] = {Vec4(0, 0, 0, 0), Vec4((float)w, 0, 0, 0), Vec4((float)w, (float)h, 0, 0), Vec4(0, (float)h, 0, 0)};
+        std::vector<Vec4> ring;
+        for (int c = 0; c < 4; ++c) {
+            ring.push_back(corners[c]);
+            for (const Vec4& p : rim) {
+                const bool onSide = (c == 0 && p.y == 0 && p.x > 0) || (c == 1 && p.x == w && p.y > 0) ||
+                                    (c == 2 && p.y == h && p.x < w) || (c == 3 && p.x == 0 && p.y < h && p.y > 0);
+                if (onSide) ring.push_back(p);
+            }
+        }
+
+        std::vector<float> vertices;
+        auto push = [&](float x, float y) {
+            vertices.push_back(x / w * 2.0f - 1.0f);
+            vertices.push_back(y / h * 2.0f - 1.0f);
+        };
+        for (size_t i = 0; i < ring.size(); ++i) {
+            const Vec4& a = ring[i];
+            const Vec4& b = ring[(i + 1) % ring.size()];
+            push(cx, cy);
+            push(a.x, a.y);
+            push(b.x, b.y);
+        }
+
+        ctx.glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glEnable(GL_BLEND);
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+        // 缓冲大小随配置变化，重新指定属性使 VAO 重新解析数据指针
+        ctx.glVertexAttribPointer(0, 2, GL_FLOAT, false, 2 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, (GLsizei)(vertices.size() / 2));
+        ctx.glDisable(GL_BLEND);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0;
+    HalfAlphaShader m_shader;
+};
+
+class SharedEdgeTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyCoverage();
+    }
+
+    // 离屏验证：中心点分别落在像素中心、像素角与任意亚像素位置，辐条包含水平、垂直与各种斜率的共享边
+    void verifyCoverage() {
+        const int w = 64, h = 48;
+        SoftRenderContext ctx(w, h);
+        SharedEdgeScene scene;
+        scene.init(ctx);
+
+        struct Config { float cx, cy; int spokes; float phase; };
+        const Config configs[] = {
+            {32.5f, 24.5f, 8, 0.0f},   // 像素中心，辐条经过像素中心
+            {32.0f, 24.0f, 8, 0.0f},   // 像素角
+            {20.37f, 17.81f, 13, 0.29f},
+            {40.5f, 10.0f, 28, 0.5f},
+            {0.5f, 47.5f, 6, 0.13f},   // 靠近视口角
+        };
+
+        int doubleHits = 0, misses = 0;
+        for (const Config& c : configs) {
+            scene.render(ctx, w, h, c.cx, c.cy, c.spokes, c.phase);
+            const uint32_t* pixels = ctx.getColorBuffer();
+            for (int i = 0; i < w * h; ++i) {
+                const uint32_t r = (pixels[i] >> ColorUtils::SHIFT_R) & 0xFF;
+                if (r == 0) ++misses;
+                else if (r != 128) ++doubleHits;
+            }
+        }
+        scene.destroy(ctx);
+
+        if (doubleHits == 0 && misses == 0) {
+            std::cout << "Shared Edge Test: every pixel covered exactly once by the triangle fans." << std::endl;
+        } else {
+            std::cerr << "Test Failed: " << doubleHits << " pixels covered twice, " << misses << " pixels missed" << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onUpdate(float dt) override {
+        m_phase = std::fmod(m_phase + dt * 0.05f, 1.0f);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Top-Left Fill Rule");
+        mu_label(ctx, "Uniform grey: no seams, no bright edges.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        m_scene.render(ctx, ctx.getWidth(), ctx.getHeight(), ctx.getWidth() * 0.5f + 0.5f, ctx.getHeight() * 0.5f, 24, m_phase);
+    }
+
+private:
+    SharedEdgeScene m_scene;
+    float m_phase = 0.0f;
+};
+
+static TestRegistrar registrar("Basic", "SharedEdge", []() -> ITinyGLTestCase* { return new SharedEdgeTest(); });
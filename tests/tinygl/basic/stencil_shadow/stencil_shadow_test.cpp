@@ -0,0 +1,202 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <framework/geometry.h>
+#include <framework/camera.h>
+#include <algorithm>
+#include <iostream>
+
+using namespace tinygl;
+using namespace framework;
+
+// Z-Fail (Carmack's Reverse) 模板阴影体：
+// 阴影体背面深度测试失败 +1，正面深度测试失败 -1，最终模板值非 0 的像素位于阴影中。
+// 阴影体落在地面之后的背面全部被深度遮挡，Hi-Z / Early-Z 若提前剔除这些片元就会丢掉 stencilPassDepthFail 操作。
+struct ShadowShader : ShaderBuiltins {
+    SimdMat4 mvp;
+    Vec4 color;
+
+    inline void vertex(const Vec4* attribs, ShaderContext& outCtx) {
+        float posArr[4] = {attribs[0].x, attribs[0].y, attribs[0].z, attribs[0].w};
+        float outArr[4];
+        mvp.transformPoint(Simd4f::load(posArr)).store(outArr);
+        outCtx.varyings[0] = attribs[1]; // Normal
+        gl_Position = Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+    }
+
+    void fragment(const ShaderContext& inCtx) {
+        const Vec4& n = inCtx.varyings[0];
+        float diffuse = std::max(0.0f, n.y * 0.8f + n.z * 0.6f);
+        gl_FragColor = Vec4(color.x * (0.3f + 0.7f * diffuse), color.y * (0.3f + 0.7f * diffuse),
+                            color.z * (0.3f + 0.7f * diffuse), color.w);
+    }
+};
+
+// 场景：地面 + 悬空方块 + 方块在竖直向下的方向光下的阴影体 (封闭长方体，穿过地面)
+class ShadowVolumeScene {
+public:
+    void init(SoftRenderContext& ctx) {
+        m_cube = geometry::createCube(0.5f);
+
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, m_cube.allAttributes.size() * sizeof(float), m_cube.allAttributes.data(), GL_STATIC_DRAW);
+
+        ctx.glGenBuffers(1, &m_ebo);
+        ctx.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        ctx.glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_cube.indices.size() * sizeof(uint32_t), m_cube.indices.data(), GL_STATIC_DRAW);
+
+        // Attributes: Pos(4), Norm(3), Tan(3), Bitan(3), UV(2)
+        GLsizei stride = 15 * sizeof(float);
+        ctx.glVertexAttribPointer(0, 4, GL_FLOAT, false, stride, (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 3, GL_FLOAT, false, stride, (void*)(4 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteVertexArrays(1, &m_vao);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteBuffers(1, &m_ebo);
+    }
+
+    void render(SoftRenderContext& ctx, const Mat4& viewProj, bool showVolume) {
+        ctx.glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        ctx.glClearStencil(0);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glDepthFunc(GL_LESS);
+
+        // 1. 场景：写入颜色与深度
+        Mat4 floorModel = Mat4::Translate(0.0f, -0.05f, 0.0f) * Mat4::Scale(4.0f, 0.1f, 4.0f);
+        Mat4 occluderModel = Mat4::Translate(0.0f, 1.5f, 0.0f);
+        drawCube(ctx, viewProj * floorModel, Vec4(0.9f, 0.9f, 0.9f, 1.0f));
+        drawCube(ctx, viewProj * occluderModel, Vec4(0.9f, 0.3f, 0.2f, 1.0f));
+
+        // 2. 阴影体：只写模板，背面/正面分两遍 (Z-Fail)，混合 (GL_ZERO, GL_ONE) 保持颜色不变
+        // 阴影体从方块底面 (y = 1) 向下延伸到地面以下 (y = -1)
+        Mat4 volumeModel = Mat4::Scale(1.0f, 2.0f, 1.0f);
+        ctx.glEnable(GL_BLEND);
+        ctx.glBlendFunc(GL_ZERO, GL_ONE);
+        ctx.glDepthMask(GL_FALSE);
+        ctx.glEnable(GL_STENCIL_TEST);
+        ctx.glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        ctx.glStencilMask(0xFF);
+        ctx.glEnable(GL_CULL_FACE);
+
+        ctx.glCullFace(GL_FRONT);
+        ctx.glStencilOp(GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+        drawCube(ctx, viewProj * volumeModel, Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+        ctx.glCullFace(GL_BACK);
+        ctx.glStencilOp(GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+        drawCube(ctx, viewProj * volumeModel, Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+        ctx.glDepthMask(GL_TRUE);
+
+        // 3. 模板非 0 的像素叠加半透明黑色 (全屏四边形)
+        ctx.glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+        ctx.glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        drawCube(ctx, Mat4::Scale(2.0f, 2.0f, 0.5f), Vec4(0.0f, 0.0f, 0.0f, 0.5f)); // 只保留朝向屏幕的 +Z 面
+        ctx.glDisable(GL_CULL_FACE);
+        ctx.glDisable(GL_STENCIL_TEST);
+
+        // 可选：把阴影体本身以半透明显示出来
+        if (showVolume) {
+            ctx.glEnable(GL_DEPTH_TEST);
+            ctx.glDepthMask(GL_FALSE);
+            drawCube(ctx, viewProj * volumeModel, Vec4(0.2f, 0.4f, 1.0f, 0.25f));
+            ctx.glDepthMask(GL_TRUE);
+        }
+        ctx.glDisable(GL_BLEND);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    void drawCube(SoftRenderContext& ctx, const Mat4& mvp, const Vec4& color) {
+        m_shader.mvp.load(mvp);
+        m_shader.color = color;
+        ctx.glDrawElements(m_shader, GL_TRIANGLES, m_cube.indices.size(), GL_UNSIGNED_INT, 0);
+    }
+
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0;
+    Geometry m_cube;
+    ShadowShader m_shader;
+};
+
+class StencilShadowTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        camera = Camera({.position = Vec4(0.0f, 3.0f, 5.0f, 1.0f), .pitch = -30.0f});
+        m_scene.init(ctx);
+        verifyZFail();
+    }
+
+    // 离屏渲染一帧：方块正下方的地面必须在阴影中，旁边的地面必须被照亮
+    void verifyZFail() {
+        const int size = 64;
+        SoftRenderContext ctx(size, size);
+        ShadowVolumeScene scene;
+        scene.init(ctx);
+
+        Mat4 viewProj = Mat4::Perspective(45.0f, 1.0f, 0.1f, 100.0f) *
+                        Mat4::LookAt(Vec4(0.0f, 3.0f, 5.0f, 1.0f), Vec4(0.0f, 0.0f, 0.0f, 1.0f), Vec4(0.0f, 1.0f, 0.0f, 0.0f));
+        scene.render(ctx, viewProj, false);
+
+        // 世界原点投影到画面中心；(1.5, 0, 0) 与原点在同一行
+        Vec4 litClip = viewProj * Vec4(1.5f, 0.0f, 0.0f, 1.0f);
+        int litX = (int)((litClip.x / litClip.w * 0.5f + 0.5f) * size);
+        const uint32_t* pixels = ctx.getColorBuffer();
+        float shadowed = ColorUtils::Uint32ToFloat(pixels[(size / 2) * size + size / 2]).x;
+        float lit = ColorUtils::Uint32ToFloat(pixels[(size / 2) * size + litX]).x;
+        scene.destroy(ctx);
+
+        if (shadowed < lit * 0.75f) {
+            std::cout << "Stencil Shadow Test: z-fail shadow OK (shadowed " << shadowed << ", lit " << lit << ")" << std::endl;
+        } else {
+            std::cerr << "Test Failed: z-fail shadow missing (shadowed " << shadowed << ", lit " << lit << ")" << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+        ctx.glDisable(GL_STENCIL_TEST);
+    }
+
+    void onEvent(const SDL_Event& e) override {
+        camera.ProcessEvent(e);
+    }
+
+    void onUpdate(float dt) override {
+        camera.Update(dt);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Stencil Shadow Volume (Z-Fail)");
+
+        int check = m_showVolume ? 1 : 0;
+        if (mu_checkbox(ctx, "Show Shadow Volume", &check)) {
+            m_showVolume = check != 0;
+        }
+        mu_label(ctx, "WASD + Mouse(RMB) to fly.");
+        mu_label(ctx, "Fly into the volume: z-fail stays correct.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        m_scene.render(ctx, camera.GetProjectionMatrix() * camera.GetViewMatrix(), m_showVolume);
+    }
+
+private:
+    ShadowVolumeScene m_scene;
+    Camera camera;
+    bool m_showVolume = false;
+};
+
+static TestRegistrar registrar("Basic", "StencilShadow", []() -> ITinyGLTestCase* { return new StencilShadowTest(); });
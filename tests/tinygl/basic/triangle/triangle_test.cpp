@@ -6,6 +6,7 @@ using namespace tinygl;
 using namespace framework;
 
 struct TriangleShader : public ShaderBuiltins {
+    static constexpr int kVaryings = 1; // Only the interpolated color
     float scale = 1.0f;
     
     void vertex(const Vec4* attribs, ShaderContext& outCtx) {
@@ -0,0 +1,202 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <framework/geometry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// 球体 (glPolygonMode 切换实心/线框) + 两端都伸出视口之外的 GL_LINES 准星：
+// 准星线段必须经过 clipLine 裁剪后才能绘制
+class WireframeScene {
+public:
+    void init(SoftRenderContext& ctx) {
+        Geometry geo = geometry::createSphere(1.0f, 24);
+        ctx.glGenVertexArrays(1, &m_sphereVao);
+        ctx.glBindVertexArray(m_sphereVao);
+        ctx.glGenBuffers(1, &m_sphereVbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_sphereVbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, geo.allAttributes.size() * sizeof(float), geo.allAttributes.data(), GL_STATIC_DRAW);
+        ctx.glGenBuffers(1, &m_sphereEbo);
+        ctx.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_sphereEbo);
+        ctx.glBufferData(GL_ELEMENT_ARRAY_BUFFER, geo.indices.size() * sizeof(uint32_t), geo.indices.data(), GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 15 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        m_indexCount = (GLsizei)geo.indices.size();
+
+        // 水平线 y = 0.5 与对角线，端点都在 [-1, 1] 之外
+        const float lines[] = {
+            -3.0f,  0.5f, 0.0f,   3.0f, 0.5f, 0.0f,
+            -2.0f, -2.0f, 0.0f,   2.0f, 2.0f, 0.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_lineVao);
+        ctx.glBindVertexArray(m_lineVao);
+        ctx.glGenBuffers(1, &m_lineVbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_lineVbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(lines), lines, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_sphereVbo);
+        ctx.glDeleteBuffers(1, &m_sphereEbo);
+        ctx.glDeleteVertexArrays(1, &m_sphereVao);
+        ctx.glDeleteBuffers(1, &m_lineVbo);
+        ctx.glDeleteVertexArrays(1, &m_lineVao);
+    }
+
+    void clear(SoftRenderContext& ctx) {
+        ctx.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    void renderSphere(SoftRenderContext& ctx, const Mat4& mvp, bool wireframe) {
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+        ctx.glBindVertexArray(m_sphereVao);
+        m_shader.mvp.load(mvp);
+        m_shader.color = Vec4(0.9f, 0.9f, 0.9f, 1.0f);
+        ctx.glDrawElements(m_shader, GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+        ctx.glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
+
+    void renderCrosshair(SoftRenderContext& ctx) {
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glBindVertexArray(m_lineVao);
+        m_shader.mvp.load(Mat4::Identity());
+        m_shader.color = Vec4(1.0f, 0.3f, 0.2f, 1.0f);
+        ctx.glDrawArrays(m_shader, GL_LINES, 0, 4);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+    GLsizei indexCount() const { return m_indexCount; }
+
+private:
+    GLuint m_sphereVao = 0, m_sphereVbo = 0, m_sphereEbo = 0;
+    GLuint m_lineVao = 0, m_lineVbo = 0;
+    GLsizei m_indexCount = 0;
+    tests::FlatColorShader m_shader;
+};
+
+class WireframeTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyWireframe();
+    }
+
+    // 离屏验证：
+    // 1. 线框球的像素都落在实心球的覆盖范围内 (允许 1 像素)，且少于实心球
+    // 2. 两端都在视口外的 GL_LINES 准星经裁剪后画出：水平线覆盖整行，对角线穿过中心
+    void verifyWireframe() {
+        const int size = 128;
+        SoftRenderContext ctx(size, size);
+        WireframeScene scene;
+        scene.init(ctx);
+        const Mat4 mvp = Mat4::Perspective(45.0f, 1.0f, 0.1f, 100.0f) * Mat4::Translate(0.0f, 0.0f, -4.0f) * Mat4::RotateX(30.0f);
+
+        scene.clear(ctx);
+        scene.renderSphere(ctx, mvp, false);
+        std::vector<uint32_t> filled(ctx.getColorBuffer(), ctx.getColorBuffer() + size * size);
+        scene.clear(ctx);
+        scene.renderSphere(ctx, mvp, true);
+        const uint32_t* wire = ctx.getColorBuffer();
+
+        const uint32_t background = filled[0];
+        auto nearFilled = [&](int x, int y) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx >= 0 && nx < size && ny >= 0 && ny < size && filled[ny * size + nx] != background) return true;
+                }
+            }
+            return false;
+        };
+        int filledPixels = 0, wirePixels = 0, strayPixels = 0;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (filled[y * size + x] != background) ++filledPixels;
+                if (wire[y * size + x] == background) continue;
+                ++wirePixels;
+                if (!nearFilled(x, y)) ++strayPixels;
+            }
+        }
+
+        scene.clear(ctx);
+        scene.renderCrosshair(ctx);
+        const uint32_t* lines = ctx.getColorBuffer();
+        int rowPixels = 0;
+        const int row = size / 4; // NDC y = 0.5
+        for (int x = 0; x < size; ++x) {
+            if (lines[row * size + x] != background || lines[(row - 1) * size + x] != background) ++rowPixels;
+        }
+        bool diagonalHit = false;
+        for (int y = size / 2 - 1; y <= size / 2; ++y) {
+            for (int x = size / 2 - 1; x <= size / 2; ++x) diagonalHit |= lines[y * size + x] != background;
+        }
+        scene.destroy(ctx);
+
+        const bool wireOk = wirePixels > 0 && wirePixels < filledPixels && strayPixels == 0;
+        const bool linesOk = rowPixels == size && diagonalHit;
+        if (wireOk && linesOk) {
+            std::cout << "Wireframe Test: " << wirePixels << " wire pixels inside " << filledPixels
+                      << " filled pixels, clipped GL_LINES drawn" << std::endl;
+        } else {
+            std::cerr << "Test Failed: wireframe pixels " << wirePixels << " (stray " << strayPixels << ") vs filled " << filledPixels
+                      << ", clipped line row coverage " << rowPixels << "/" << size << ", diagonal " << diagonalHit << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onUpdate(float dt) override {
+        m_rotation += dt * 30.0f;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "glPolygonMode(GL_LINE)");
+
+        int wire = m_wireframe ? 1 : 0;
+        if (mu_checkbox(ctx, "Wireframe", &wire)) m_wireframe = wire != 0;
+        int crosshair = m_crosshair ? 1 : 0;
+        if (mu_checkbox(ctx, "Clipped GL_LINES", &crosshair)) m_crosshair = crosshair != 0;
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Triangles: %d", (int)(m_scene.indexCount() / 3));
+        mu_label(ctx, buf);
+        snprintf(buf, sizeof(buf), "Sphere: %.3f ms", m_lastMs);
+        mu_label(ctx, buf);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        const auto& vp = ctx.glGetViewport();
+        Mat4 proj = Mat4::Perspective(45.0f, (float)vp.w / (float)vp.h, 0.1f, 100.0f);
+        Mat4 model = Mat4::Translate(0.0f, 0.0f, -4.0f) * Mat4::RotateY(m_rotation) * Mat4::RotateX(30.0f);
+
+        m_scene.clear(ctx);
+        auto start = std::chrono::high_resolution_clock::now();
+        m_scene.renderSphere(ctx, proj * model, m_wireframe);
+        ctx.glFinish();
+        auto end = std::chrono::high_resolution_clock::now();
+        m_lastMs = std::chrono::duration<float, std::milli>(end - start).count();
+        if (m_crosshair) m_scene.renderCrosshair(ctx);
+    }
+
+private:
+    WireframeScene m_scene;
+    bool m_wireframe = true;
+    bool m_crosshair = true;
+    float m_rotation = 0.0f;
+    float m_lastMs = 0.0f;
+};
+
+static TestRegistrar registrar("Basic", "Wireframe", []() -> ITinyGLTestCase* { return new WireframeTest(); });
@@ -0,0 +1,218 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <framework/geometry.h>
+#include <framework/camera.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// Z-Prepass：先用 glColorMask(GL_FALSE, ...) 只写深度，再以 GL_LEQUAL 绘制颜色，
+// 第二遍只有最终可见的片元执行 Fragment Shader。
+// Shader 声明不写 gl_FragDepth、不 discard，颜色全屏蔽的第一遍走 Depth-Only 路径 (完全不执行 Fragment Shader)。
+struct PrepassShader : ShaderBuiltins {
+    static constexpr int kVaryings = 1; // Normal
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = false;
+    SimdMat4 mvp;
+    Vec4 color;
+    std::atomic<int>* invocations = nullptr; // Fragment Shader 执行次数 (Draw 可能被延迟/拷贝，计数放在外部)
+
+    inline void vertex(const Vec4* attribs, ShaderContext& outCtx) {
+        float posArr[4] = {attribs[0].x, attribs[0].y, attribs[0].z, attribs[0].w};
+        float outArr[4];
+        mvp.transformPoint(Simd4f::load(posArr)).store(outArr);
+        outCtx.varyings[0] = attribs[1];
+        gl_Position = Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+    }
+
+    void fragment(const ShaderContext& inCtx) {
+        if (invocations) invocations->fetch_add(1, std::memory_order_relaxed);
+        const Vec4& n = inCtx.varyings[0];
+        float len = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z) + 1e-6f;
+        float ndl = std::max(0.0f, (n.x * 0.3f + n.y * 0.6f + n.z * 0.74f) / len);
+        // 模拟较重的着色：高次幂高光
+        float spec = std::pow(ndl, 32.0f);
+        float k = 0.2f + 0.8f * ndl;
+        gl_FragColor = Vec4(std::min(1.0f, color.x * k + spec), std::min(1.0f, color.y * k + spec),
+                            std::min(1.0f, color.z * k + spec), 1.0f);
+    }
+};
+
+// 场景：沿视线方向排列的多层球体阵列，层间互相遮挡产生大量 Overdraw
+class PrepassScene {
+public:
+    static constexpr int GRID = 5;
+    static constexpr int LAYERS = 4;
+
+    void init(SoftRenderContext& ctx) {
+        m_sphere = geometry::createSphere(0.45f, 24);
+
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, m_sphere.allAttributes.size() * sizeof(float), m_sphere.allAttributes.data(), GL_STATIC_DRAW);
+
+        ctx.glGenBuffers(1, &m_ebo);
+        ctx.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        ctx.glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_sphere.indices.size() * sizeof(uint32_t), m_sphere.indices.data(), GL_STATIC_DRAW);
+
+        // Attributes: Pos(4), Norm(3), Tan(3), Bitan(3), UV(2)
+        GLsizei stride = 15 * sizeof(float);
+        ctx.glVertexAttribPointer(0, 4, GL_FLOAT, false, stride, (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 3, GL_FLOAT, false, stride, (void*)(4 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+
+        m_shader.invocations = &m_invocations;
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteVertexArrays(1, &m_vao);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteBuffers(1, &m_ebo);
+    }
+
+    // 返回值：深度遍与颜色遍各自的 Fragment Shader 执行次数
+    struct Stats {
+        int depthPass = 0;
+        int colorPass = 0;
+    };
+
+    Stats render(SoftRenderContext& ctx, const Mat4& viewProj, bool prepass) {
+        Stats stats;
+        ctx.glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glEnable(GL_DEPTH_TEST);
+
+        if (prepass) {
+            // 1. 只写深度：颜色全屏蔽
+            ctx.glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            ctx.glDepthMask(GL_TRUE);
+            ctx.glDepthFunc(GL_LESS);
+            stats.depthPass = drawSpheres(ctx, viewProj);
+
+            // 2. 颜色：深度已就绪，只有等于最近深度的片元通过
+            ctx.glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            ctx.glDepthMask(GL_FALSE);
+            ctx.glDepthFunc(GL_LEQUAL);
+            stats.colorPass = drawSpheres(ctx, viewProj);
+
+            ctx.glDepthMask(GL_TRUE);
+            ctx.glDepthFunc(GL_LESS);
+        } else {
+            ctx.glDepthFunc(GL_LESS);
+            stats.colorPass = drawSpheres(ctx, viewProj);
+        }
+        return stats;
+    }
+
+private:
+    // 由远及近绘制 (Overdraw 的最坏情况)，返回本遍 Fragment Shader 执行次数
+    int drawSpheres(SoftRenderContext& ctx, const Mat4& viewProj) {
+        m_invocations = 0;
+        for (int layer = LAYERS - 1; layer >= 0; --layer) {
+            for (int y = 0; y < GRID; ++y) {
+                for (int x = 0; x < GRID; ++x) {
+                    float fx = (x - (GRID - 1) * 0.5f) * 0.7f + layer * 0.15f;
+                    float fy = (y - (GRID - 1) * 0.5f) * 0.7f - layer * 0.1f;
+                    float fz = -layer * 0.6f;
+                    m_shader.mvp.load(viewProj * Mat4::Translate(fx, fy, fz));
+                    m_shader.color = Vec4(0.3f + 0.15f * x, 0.3f + 0.15f * y, 0.4f + 0.15f * layer, 1.0f);
+                    ctx.glDrawElements(m_shader, GL_TRIANGLES, m_sphere.indices.size(), GL_UNSIGNED_INT, 0);
+                }
+            }
+        }
+        ctx.glFinish();
+        return m_invocations.load();
+    }
+
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0;
+    Geometry m_sphere;
+    PrepassShader m_shader;
+    std::atomic<int> m_invocations{0};
+};
+
+class ZPrepassTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        camera = Camera({.position = Vec4(0.0f, 0.0f, 4.0f, 1.0f)});
+        m_scene.init(ctx);
+        verifyPrepass();
+    }
+
+    // 离屏对比：Prepass 与单遍绘制的图像必须一致；深度遍不执行 Fragment Shader，颜色遍执行次数少于单遍
+    void verifyPrepass() {
+        const int size = 128;
+        SoftRenderContext ctx(size, size);
+        PrepassScene scene;
+        scene.init(ctx);
+        Mat4 viewProj = Mat4::Perspective(45.0f, 1.0f, 0.1f, 100.0f) * Mat4::Translate(0.0f, 0.0f, -4.0f);
+
+        PrepassScene::Stats single = scene.render(ctx, viewProj, false);
+        std::vector<uint32_t> reference(ctx.getColorBuffer(), ctx.getColorBuffer() + size * size);
+        PrepassScene::Stats twoPass = scene.render(ctx, viewProj, true);
+        const uint32_t* pixels = ctx.getColorBuffer();
+        int diff = 0;
+        for (int i = 0; i < size * size; ++i) diff += pixels[i] != reference[i];
+        scene.destroy(ctx);
+
+        if (diff == 0 && twoPass.depthPass == 0 && twoPass.colorPass < single.colorPass) {
+            std::cout << "Z-Prepass Test: image matches, fragment shader runs " << single.colorPass << " -> "
+                      << twoPass.colorPass << " (depth pass " << twoPass.depthPass << ")" << std::endl;
+        } else {
+            std::cerr << "Test Failed: Z-Prepass diff " << diff << " pixels, depth pass ran " << twoPass.depthPass
+                      << " fragment shaders, color pass " << twoPass.colorPass << " vs single pass " << single.colorPass << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onEvent(const SDL_Event& e) override {
+        camera.ProcessEvent(e);
+    }
+
+    void onUpdate(float dt) override {
+        camera.Update(dt);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Z-Prepass (glColorMask depth-only pass)");
+
+        int check = m_prepass ? 1 : 0;
+        if (mu_checkbox(ctx, "Enable Z-Prepass", &check)) {
+            m_prepass = check != 0;
+        }
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Depth pass FS: %d", m_stats.depthPass);
+        mu_label(ctx, buf);
+        snprintf(buf, sizeof(buf), "Color pass FS: %d", m_stats.colorPass);
+        mu_label(ctx, buf);
+        mu_label(ctx, "WASD + Mouse(RMB) to fly.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        m_stats = m_scene.render(ctx, camera.GetProjectionMatrix() * camera.GetViewMatrix(), m_prepass);
+    }
+
+private:
+    PrepassScene m_scene;
+    PrepassScene::Stats m_stats;
+    Camera camera;
+    bool m_prepass = true;
+};
+
+static TestRegistrar registrar("Basic", "ZPrepass", []() -> ITinyGLTestCase* { return new ZPrepassTest(); });
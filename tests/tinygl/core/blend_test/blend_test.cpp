@@ -0,0 +1,100 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <tinygl/core/blend.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace tinygl;
+
+// 定点混合自检：对每种 FixedBlendMode 穷举 (src, dst, alpha)，
+// blendFixed4 (SIMD) 必须与 blendFixed (标量) 逐位一致，且两者与浮点 applyBlending 相差不超过 1 LSB
+class BlendTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext&) override {
+        struct Case {
+            FixedBlendMode mode;
+            GLenum src, dst;
+            const char* name;
+        };
+        const Case cases[] = {
+            {FIXED_BLEND_ALPHA, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, "ALPHA"},
+            {FIXED_BLEND_PREMULTIPLIED, GL_ONE, GL_ONE_MINUS_SRC_ALPHA, "PREMULTIPLIED"},
+            {FIXED_BLEND_ADDITIVE, GL_ONE, GL_ONE, "ADDITIVE"},
+            {FIXED_BLEND_ADDITIVE_ALPHA, GL_SRC_ALPHA, GL_ONE, "ADDITIVE_ALPHA"},
+            {FIXED_BLEND_MULTIPLY, GL_DST_COLOR, GL_ZERO, "MULTIPLY"},
+            {FIXED_BLEND_MULTIPLY, GL_ZERO, GL_SRC_COLOR, "MULTIPLY (ZERO, SRC_COLOR)"},
+        };
+
+        bool ok = true;
+        for (const Case& c : cases) {
+            SoftRenderContext::RasterState state;
+            state.blendEnabled = true;
+            state.blend.srcRGB = state.blend.srcAlpha = c.src;
+            state.blend.dstRGB = state.blend.dstAlpha = c.dst;
+
+            if (classifyFixedBlend(c.src, c.dst, c.src, c.dst, GL_FUNC_ADD, GL_FUNC_ADD) != c.mode ||
+                SoftRenderContext::fixedBlendMode(state) != c.mode) {
+                std::cerr << "Test Failed: " << c.name << " was not classified as its fixed-point mode" << std::endl;
+                ok = false;
+                continue;
+            }
+
+            long simdMismatches = 0, refMismatches = 0;
+            for (uint32_t a = 0; a < 256; ++a) {
+                for (uint32_t s = 0; s < 256; ++s) {
+                    const uint32_t src = (a << 24) | (s * 0x010101u);
+                    const uint32_t srcs[4] = {src, src, src, src};
+                    for (uint32_t d0 = 0; d0 < 256; d0 += 4) {
+                        uint32_t dsts[4], simd[4];
+                        for (int i = 0; i < 4; ++i) dsts[i] = (d0 + i) * 0x01010101u;
+                        blendFixed4(c.mode, srcs, dsts, simd);
+                        for (int i = 0; i < 4; ++i) {
+                            const uint32_t scalar = blendFixed(c.mode, src, dsts[i]);
+                            if (simd[i] != scalar) ++simdMismatches;
+                            const uint32_t ref = ColorUtils::FloatToUint32(SoftRenderContext::applyBlending(
+                                ColorUtils::Uint32ToFloat(src), ColorUtils::Uint32ToFloat(dsts[i]), state));
+                            if (!withinOneLsb(scalar, ref)) ++refMismatches;
+                        }
+                    }
+                }
+            }
+
+            if (simdMismatches != 0 || refMismatches != 0) {
+                std::cerr << "Test Failed: " << c.name << " blendFixed4 != blendFixed in " << simdMismatches
+                          << " cases, > 1 LSB from applyBlending in " << refMismatches << " cases" << std::endl;
+                ok = false;
+            }
+        }
+
+        // 方程或 RGB/Alpha 因子不一致的组合必须回退到浮点路径
+        if (classifyFixedBlend(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_FUNC_SUBTRACT, GL_FUNC_ADD) != FIXED_BLEND_NONE ||
+            classifyFixedBlend(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO, GL_FUNC_ADD, GL_FUNC_ADD) != FIXED_BLEND_NONE ||
+            classifyFixedBlend(GL_ONE_MINUS_DST_ALPHA, GL_ONE, GL_ONE_MINUS_DST_ALPHA, GL_ONE, GL_FUNC_ADD, GL_FUNC_ADD) != FIXED_BLEND_NONE) {
+            std::cerr << "Test Failed: unsupported blend state was classified as a fixed-point mode" << std::endl;
+            ok = false;
+        }
+
+        if (ok) std::cout << "Blend Test: fixed-point SIMD, scalar and float blending agree for all inputs." << std::endl;
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        ctx.glClearColor(0, 0, 1, 1);
+        ctx.glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    void destroy(SoftRenderContext&) override {}
+    void onUpdate(float) override {}
+    void onEvent(const SDL_Event&) override {}
+    void onGui(mu_Context*, const Rect&) override {}
+
+private:
+    static bool withinOneLsb(uint32_t a, uint32_t b) {
+        for (int c = 0; c < 32; c += 8) {
+            if (std::abs((int)((a >> c) & 0xFF) - (int)((b >> c) & 0xFF)) > 1) return false;
+        }
+        return true;
+    }
+};
+
+static TestRegistrar registry(TINYGL_TEST_GROUP, "BlendVerify", []() { return new BlendTest(); });
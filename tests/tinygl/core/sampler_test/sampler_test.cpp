@@ -0,0 +1,137 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace tinygl;
+
+namespace {
+
+// 标量参考：逐 texel 取数、逐通道 mix，对应向量化之前的 sampleBilinear / 三线性实现
+Vec4 referenceTexel(const TextureObject& tex, int level, int x, int y) {
+    const auto& info = tex.mipLevels[level];
+    const size_t blocksPerRow = (info.width + 3) / 4;
+    const uint32_t p = tex.data[info.offset + ((y / 4) * blocksPerRow + (x / 4)) * 16 + (y % 4) * 4 + (x % 4)];
+    return Vec4((p & 0xFF) / 255.0f, ((p >> 8) & 0xFF) / 255.0f, ((p >> 16) & 0xFF) / 255.0f, (p >> 24) / 255.0f);
+}
+
+template <typename WrapS, typename WrapT>
+Vec4 referenceBilinear(const TextureObject& tex, int level, float uw, float vw) {
+    const auto& info = tex.mipLevels[level];
+    const int w = info.width, h = info.height;
+    const float uImg = uw * w - 0.5f, vImg = vw * h - 0.5f;
+    const int x0 = (int)std::floor(uImg), y0 = (int)std::floor(vImg);
+    const float s = uImg - x0, t = vImg - y0;
+
+    auto fetch = [&](int x, int y) {
+        const int xw = WrapS::applyInt(x, w), yw = WrapT::applyInt(y, h);
+        if (WrapS::checkBorderInt(xw, w) || WrapT::checkBorderInt(yw, h)) return tex.borderColor;
+        return referenceTexel(tex, level, xw, yw);
+    };
+    return mix(mix(fetch(x0, y0), fetch(x0 + 1, y0), s), mix(fetch(x0, y0 + 1), fetch(x0 + 1, y0 + 1), s), t);
+}
+
+// GL_LINEAR 放大 / GL_LINEAR_MIPMAP_LINEAR 缩小
+template <typename WrapS, typename WrapT>
+Vec4 referenceSample(const TextureObject& tex, float u, float v, float rho) {
+    if (WrapS::checkBorder(u) || WrapT::checkBorder(v)) return tex.borderColor;
+    const float uw = WrapS::apply(u), vw = WrapT::apply(v);
+
+    float level = 0.0f;
+    if (rho > 0.0f) level = std::log2(rho * (float)std::max(tex.mipLevels[0].width, tex.mipLevels[0].height));
+    level = std::clamp(level + tex.lodBias, tex.minLOD, tex.maxLOD);
+    if (level <= 0.0f) return referenceBilinear<WrapS, WrapT>(tex, 0, uw, vw);
+
+    const int maxLevel = (int)tex.mipLevels.size() - 1;
+    level = std::clamp(level, 0.0f, (float)maxLevel);
+    const int l0 = (int)std::floor(level);
+    const int l1 = std::min(l0 + 1, maxLevel);
+    return mix(referenceBilinear<WrapS, WrapT>(tex, l0, uw, vw), referenceBilinear<WrapS, WrapT>(tex, l1, uw, vw), level - l0);
+}
+
+} // namespace
+
+// 向量化 sample (2x2 足迹 SIMD 解包与加权) 与标量参考逐通道比较：
+// 所有 Wrap 模式，坐标落在 texel 中心、texel 边界与任意小数位置，包括跨 4x4 块与越过纹理边缘的足迹
+class SamplerTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext&) override {
+        // 尺寸不是 4 的整数倍：最后一列 / 行的块未填满，Mip 链包含奇数尺寸
+        const int w = 37, h = 29;
+        std::vector<uint32_t> pixels(w * h);
+        std::mt19937 rng(2024);
+        for (auto& p : pixels) p = rng();
+
+        SoftRenderContext ctx(16, 16);
+        GLuint texId = 0;
+        ctx.glGenTextures(1, &texId);
+        ctx.glBindTexture(GL_TEXTURE_2D, texId);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        ctx.glGenerateMipmap(GL_TEXTURE_2D);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        const float border[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+        ctx.glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border);
+        const TextureObject& tex = *ctx.getTextureObject(texId);
+
+        const float maxError = 1e-5f;
+        float worst = 0.0f;
+        bool ok = true;
+        auto run = [&](GLenum wrapS, GLenum wrapT, const char* name, auto reference) {
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
+            float modeWorst = 0.0f;
+            const float fractions[] = {0.0f, 0.5f, 0.25f, 0.731f, 0.999f};
+            const float rhos[] = {0.0f, 0.6f / w, 1.0f / w, 2.7f / w, 5.0f / w, 13.0f / w, 1.0f};
+            // 覆盖 [-1.5, 2.5) 的纹理坐标，越过两侧边缘
+            for (int ty = -h * 3 / 2; ty < h * 5 / 2; ty += 3) {
+                for (int tx = -w * 3 / 2; tx < w * 5 / 2; tx += 2) {
+                    const float fu = fractions[(tx + 100 * w) % 5], fv = fractions[(ty + 100 * h + 2) % 5];
+                    const float u = (tx + fu) / w, v = (ty + fv) / h;
+                    for (float rho : rhos) {
+                        const Vec4 a = tex.sample(u, v, rho);
+                        const Vec4 b = reference(tex, u, v, rho);
+                        modeWorst = std::max({modeWorst, std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z), std::abs(a.w - b.w)});
+                    }
+                }
+            }
+            worst = std::max(worst, modeWorst);
+            if (modeWorst > maxError) {
+                std::cerr << "Test Failed: " << name << " SIMD sample differs from scalar reference by " << modeWorst << std::endl;
+                ok = false;
+            }
+        };
+
+        using Repeat = WrapPolicy<GL_REPEAT>;
+        using Edge = WrapPolicy<GL_CLAMP_TO_EDGE>;
+        using Mirror = WrapPolicy<GL_MIRRORED_REPEAT>;
+        using Border = WrapPolicy<GL_CLAMP_TO_BORDER>;
+        // 混合模式只支持 REPEAT 与 CLAMP_TO_EDGE 的组合 (selectSampler)
+        run(GL_REPEAT, GL_REPEAT, "REPEAT", referenceSample<Repeat, Repeat>);
+        run(GL_REPEAT, GL_CLAMP_TO_EDGE, "REPEAT / CLAMP_TO_EDGE", referenceSample<Repeat, Edge>);
+        run(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, "CLAMP_TO_EDGE", referenceSample<Edge, Edge>);
+        run(GL_CLAMP_TO_EDGE, GL_REPEAT, "CLAMP_TO_EDGE / REPEAT", referenceSample<Edge, Repeat>);
+        run(GL_MIRRORED_REPEAT, GL_MIRRORED_REPEAT, "MIRRORED_REPEAT", referenceSample<Mirror, Mirror>);
+        run(GL_CLAMP_TO_BORDER, GL_CLAMP_TO_BORDER, "CLAMP_TO_BORDER", referenceSample<Border, Border>);
+
+        ctx.glDeleteTextures(1, &texId);
+
+        if (ok) std::cout << "Sampler Test: SIMD bilinear / trilinear sampling matches the scalar reference (max error " << worst << ")" << std::endl;
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        ctx.glClearColor(0, 0, 1, 1);
+        ctx.glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    void destroy(SoftRenderContext&) override {}
+    void onUpdate(float) override {}
+    void onEvent(const SDL_Event&) override {}
+    void onGui(mu_Context*, const Rect&) override {}
+};
+
+static TestRegistrar registry(TINYGL_TEST_GROUP, "SamplerVerify", []() { return new SamplerTest(); });
@@ -0,0 +1,163 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <iostream>
+
+using namespace tinygl;
+using namespace framework;
+
+// 远处两块几乎重合的平面 (红色在后、绿色在前) + 左半屏的模板标记：
+// 深度精度不足时出现 Z-Fighting (红色穿透)；D24S8 下深度写入不能破坏打包在同一个字里的模板值
+class DepthFormatScene {
+public:
+    void init(SoftRenderContext& ctx) {
+        const float vertices[] = {
+            -1.0f, -1.0f, 0.0f,   1.0f, -1.0f, 0.0f,   1.0f,  1.0f, 0.0f,
+            -1.0f, -1.0f, 0.0f,   1.0f,  1.0f, 0.0f,  -1.0f,  1.0f, 0.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, false, 3 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, GLenum depthFormat, float distance, float gap, float aspect) {
+        // 切换格式会以清除值重置深度/模板
+        if (ctx.getDepthFormat() != depthFormat) ctx.setDepthFormat(depthFormat);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        ctx.glClearDepth(1.0f);
+        ctx.glClearStencil(0);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+        // 1. 模板：左半屏写 1 (不写颜色/深度)
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glEnable(GL_STENCIL_TEST);
+        ctx.glStencilFunc(GL_ALWAYS, 1, 0xFF);
+        ctx.glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        ctx.glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        draw(ctx, Mat4::Translate(-0.5f, 0.0f, 0.0f) * Mat4::Scale(0.5f, 1.0f, 1.0f), Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        ctx.glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        ctx.glDisable(GL_STENCIL_TEST);
+
+        // 2. 两块平面：先远 (红) 后近 (绿)，GL_LESS
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glDepthFunc(GL_LESS);
+        Mat4 proj = Mat4::Perspective(45.0f, aspect, 0.1f, 100.0f);
+        float extent = distance; // 45° FOV 下半高约 0.41 * distance，留出余量
+        draw(ctx, proj * Mat4::Translate(0.0f, 0.0f, -distance - gap) * Mat4::Scale(extent * aspect, extent, 1.0f), Vec4(1.0f, 0.0f, 0.0f, 1.0f));
+        draw(ctx, proj * Mat4::Translate(0.0f, 0.0f, -distance) * Mat4::Scale(extent * aspect, extent, 1.0f), Vec4(0.0f, 1.0f, 0.0f, 1.0f));
+
+        // 3. 模板为 1 的像素叠加半透明蓝色
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glEnable(GL_STENCIL_TEST);
+        ctx.glStencilFunc(GL_EQUAL, 1, 0xFF);
+        ctx.glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        ctx.glEnable(GL_BLEND);
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        draw(ctx, Mat4::Identity(), Vec4(0.0f, 0.0f, 1.0f, 0.5f));
+        ctx.glDisable(GL_BLEND);
+        ctx.glDisable(GL_STENCIL_TEST);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    void draw(SoftRenderContext& ctx, const Mat4& mvp, const Vec4& color) {
+        m_shader.mvp.load(mvp);
+        m_shader.color = color;
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 6);
+    }
+
+    GLuint m_vao = 0, m_vbo = 0;
+    tests::FlatColorShader m_shader;
+};
+
+class DepthFormatTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyFormats();
+    }
+
+    // 离屏逐格式验证：32F / D24 / D24S8 下前面的平面必须完整遮挡后面的平面，D16 下必然出现 Z-Fighting；
+    // 所有格式下模板标记都必须保持 (左半屏蓝绿混合、右半屏纯绿)
+    void verifyFormats() {
+        const int size = 64;
+        SoftRenderContext ctx(size, size);
+        DepthFormatScene scene;
+        scene.init(ctx);
+
+        struct Case { GLenum format; const char* name; bool expectFighting; };
+        const Case cases[] = {
+            {GL_DEPTH_COMPONENT32F, "D32F", false},
+            {GL_DEPTH_COMPONENT24, "D24", false},
+            {GL_DEPTH24_STENCIL8, "D24S8", false},
+            {GL_DEPTH_COMPONENT16, "D16", true},
+        };
+        bool ok = true;
+        for (const Case& c : cases) {
+            // 距离 20 处相隔 0.05：24 位深度相差约 200 个量化级，16 位深度量化到同一值
+            scene.render(ctx, c.format, 20.0f, 0.05f, 1.0f);
+            const uint32_t* pixels = ctx.getColorBuffer();
+            int fighting = 0, stencilErrors = 0;
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    Vec4 p = ColorUtils::Uint32ToFloat(pixels[y * size + x]);
+                    if (p.x > 0.25f) ++fighting;
+                    bool marked = x < size / 2;
+                    if (marked != (p.z > 0.25f)) ++stencilErrors;
+                }
+            }
+            if ((fighting > 0) != c.expectFighting || stencilErrors > 0) {
+                std::cerr << "Test Failed: depth format " << c.name << " z-fighting pixels " << fighting
+                          << ", stencil errors " << stencilErrors << std::endl;
+                ok = false;
+            }
+        }
+        ctx.setDepthFormat(GL_DEPTH_COMPONENT32F);
+        scene.destroy(ctx);
+        if (ok) std::cout << "Depth Format Test: D32F/D24/D24S8 resolve the gap, D16 fights, stencil preserved" << std::endl;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+        ctx.setDepthFormat(GL_DEPTH_COMPONENT32F);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Depth / Stencil Format");
+        if (mu_button(ctx, m_format == GL_DEPTH_COMPONENT32F ? "[D32F]" : "D32F")) m_format = GL_DEPTH_COMPONENT32F;
+        if (mu_button(ctx, m_format == GL_DEPTH_COMPONENT24 ? "[D24]" : "D24")) m_format = GL_DEPTH_COMPONENT24;
+        if (mu_button(ctx, m_format == GL_DEPTH24_STENCIL8 ? "[D24S8]" : "D24S8")) m_format = GL_DEPTH24_STENCIL8;
+        if (mu_button(ctx, m_format == GL_DEPTH_COMPONENT16 ? "[D16]" : "D16")) m_format = GL_DEPTH_COMPONENT16;
+
+        mu_label(ctx, "Distance");
+        mu_slider(ctx, &m_distance, 1.0f, 90.0f);
+        mu_label(ctx, "Plane Gap");
+        mu_slider(ctx, &m_gap, 0.001f, 0.5f);
+        mu_label(ctx, "Red = z-fighting, blue = stencil mask.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        const auto& vp = ctx.glGetViewport();
+        m_scene.render(ctx, m_format, m_distance, m_gap, (float)vp.w / (float)vp.h);
+    }
+
+private:
+    DepthFormatScene m_scene;
+    GLenum m_format = GL_DEPTH24_STENCIL8;
+    float m_distance = 20.0f;
+    float m_gap = 0.05f;
+};
+
+static TestRegistrar registrar("Framebuffer", "DepthFormat", []() -> ITinyGLTestCase* { return new DepthFormatTest(); });
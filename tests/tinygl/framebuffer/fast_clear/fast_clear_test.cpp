@@ -0,0 +1,164 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// 一帧内混合各种清除：整屏清除、Scissor 部分清除 (跨 Tile 边界)、带颜色掩码的清除、只清深度，
+// 每次清除后都绘制一个穿过清除边界的三角形，验证待定 Tile 在光栅化前被正确写入
+class FastClearScene {
+public:
+    void init(SoftRenderContext& ctx) {
+        const float vertices[] = {
+            -0.9f, -0.8f,   0.7f, -0.3f,   -0.2f, 0.9f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 2, GL_FLOAT, false, 2 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, float phase) {
+        const int w = ctx.getWidth(), h = ctx.getHeight();
+        ctx.glBindVertexArray(m_vao);
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glDepthFunc(GL_LESS);
+
+        // 1. 整屏清除 + 绘制
+        ctx.glClearColor(0.2f, 0.2f, 0.25f, 1.0f);
+        ctx.glClearDepth(1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        draw(ctx, Vec4(0.9f, 0.6f, 0.1f, 1.0f), 0.5f);
+
+        // 2. Scissor 部分清除：矩形不与 Tile 对齐
+        ctx.glEnable(GL_SCISSOR_TEST);
+        ctx.glScissor((int)(w * (0.1f + 0.1f * phase)), h / 5, w / 2, h / 2);
+        ctx.glClearColor(0.1f, 0.4f, 0.8f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ctx.glDisable(GL_SCISSOR_TEST);
+        draw(ctx, Vec4(0.2f, 0.9f, 0.3f, 1.0f), 0.6f); // 只在刚清除过深度的区域可见
+
+        // 3. 带颜色掩码的清除 (只清红色通道)
+        ctx.glColorMask(GL_TRUE, GL_FALSE, GL_FALSE, GL_FALSE);
+        ctx.glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT);
+        ctx.glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        // 4. 只清深度后再绘制：三角形必须覆盖之前的所有内容
+        ctx.glClear(GL_DEPTH_BUFFER_BIT);
+        draw(ctx, Vec4(0.5f, 0.1f, 0.6f, 1.0f), 0.9f);
+    }
+
+private:
+    void draw(SoftRenderContext& ctx, const Vec4& color, float depth) {
+        m_shader.color = color;
+        m_shader.mvp.load(Mat4::Translate(0.0f, 0.0f, depth * 2.0f - 1.0f));
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 3);
+    }
+
+    GLuint m_vao = 0, m_vbo = 0;
+    tests::FlatColorShader m_shader;
+};
+
+class FastClearTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyFastClear();
+    }
+
+    // 离屏验证：快速清除开/关在线性/分块布局、单采样/MSAA 下的读回结果 (getColorBuffer 与 setExternalBuffer) 必须完全一致
+    void verifyFastClear() {
+        const int w = 200, h = 130;
+        SoftRenderContext ctx(w, h);
+        FastClearScene scene;
+        scene.init(ctx);
+
+        auto renderImage = [&](bool fastClear, bool tiled, int samples, bool external) {
+            ctx.setFastClearEnabled(fastClear);
+            if (ctx.isTiledFramebufferEnabled() != tiled) ctx.setTiledFramebufferEnabled(tiled);
+            if (ctx.getSampleCount() != samples) ctx.setSampleCount(samples);
+            std::vector<uint32_t> image(w * h, 0);
+            if (external) ctx.setExternalBuffer(image.data());
+            scene.render(ctx, 0.3f);
+            const uint32_t* pixels = ctx.getColorBuffer();
+            if (external) {
+                ctx.setExternalBuffer(nullptr);
+            } else {
+                image.assign(pixels, pixels + w * h);
+            }
+            return image;
+        };
+
+        int failures = 0;
+        for (int tiled = 0; tiled < 2; ++tiled) {
+            for (int samples : {1, MSAA_SAMPLES}) {
+                std::vector<uint32_t> eager = renderImage(false, tiled, samples, false);
+                for (int external = 0; external < 2; ++external) {
+                    if (renderImage(true, tiled, samples, external) != eager) {
+                        std::cerr << "Test Failed: fast clear differs (tiled " << tiled << ", samples " << samples
+                                  << ", external buffer " << external << ")" << std::endl;
+                        ++failures;
+                    }
+                }
+            }
+        }
+        ctx.setSampleCount(1);
+        ctx.setTiledFramebufferEnabled(false);
+        ctx.setFastClearEnabled(true);
+        scene.destroy(ctx);
+        if (failures == 0) std::cout << "Fast Clear Test: lazy and eager clears identical in all layouts" << std::endl;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+        ctx.setFastClearEnabled(true);
+    }
+
+    void onUpdate(float dt) override {
+        m_phase += dt * 0.5f;
+        if (m_phase > 1.0f) m_phase -= 1.0f;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Lazy Per-Tile Fast Clear");
+
+        int fast = m_fastClear ? 1 : 0;
+        if (mu_checkbox(ctx, "Fast Clear", &fast)) m_fastClear = fast != 0;
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Scene (4 clears): %.3f ms", m_lastMs);
+        mu_label(ctx, buf);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        ctx.setFastClearEnabled(m_fastClear);
+        auto start = std::chrono::high_resolution_clock::now();
+        m_scene.render(ctx, m_phase);
+        ctx.glFinish();
+        auto end = std::chrono::high_resolution_clock::now();
+        m_lastMs = std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+private:
+    FastClearScene m_scene;
+    bool m_fastClear = true;
+    float m_phase = 0.0f;
+    float m_lastMs = 0.0f;
+};
+
+static TestRegistrar registrar("Framebuffer", "FastClear", []() -> ITinyGLTestCase* { return new FastClearTest(); });
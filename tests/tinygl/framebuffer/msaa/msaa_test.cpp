@@ -0,0 +1,140 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// 一组互相穿插的细长三角形：边缘几乎水平/竖直时锯齿最明显
+class MsaaScene {
+public:
+    void init(SoftRenderContext& ctx) {
+        // Position (3) + Color (3)
+        const float vertices[] = {
+            -0.9f, -0.8f,  0.0f,   1.0f, 1.0f, 1.0f,
+             0.9f, -0.6f,  0.0f,   1.0f, 1.0f, 1.0f,
+            -0.7f,  0.8f,  0.0f,   1.0f, 1.0f, 1.0f,
+
+            -0.8f,  0.1f, -0.5f,   1.0f, 0.3f, 0.2f,
+             0.8f, -0.2f,  0.5f,   1.0f, 0.3f, 0.2f,
+             0.6f,  0.9f,  0.5f,   1.0f, 0.3f, 0.2f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, false, 6 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 3, GL_FLOAT, false, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, float angle) {
+        ctx.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glBindVertexArray(m_vao);
+        m_shader.mvp.load(Mat4::RotateZ(angle));
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 6);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0;
+    tests::VertexColorShader m_shader;
+};
+
+class MsaaTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyEdges();
+    }
+
+    // 离屏对比 1x 与 MSAA：内部像素必须一致，差异只出现在 1x 图像的边缘 (与邻居颜色不同的像素) 上，
+    // 且 MSAA 边缘上出现 1x 中没有的中间色
+    void verifyEdges() {
+        const int size = 64;
+        SoftRenderContext ctx(size, size);
+        MsaaScene scene;
+        scene.init(ctx);
+
+        scene.render(ctx, 7.0f);
+        std::vector<uint32_t> aliased(ctx.getColorBuffer(), ctx.getColorBuffer() + size * size);
+        ctx.setSampleCount(MSAA_SAMPLES);
+        scene.render(ctx, 7.0f);
+        const uint32_t* smooth = ctx.getColorBuffer();
+
+        auto isEdge = [&](int x, int y) {
+            const uint32_t c = aliased[y * size + x];
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx >= 0 && nx < size && ny >= 0 && ny < size && aliased[ny * size + nx] != c) return true;
+                }
+            }
+            return false;
+        };
+
+        int edgeDiffs = 0, interiorDiffs = 0;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (smooth[y * size + x] == aliased[y * size + x]) continue;
+                if (isEdge(x, y)) ++edgeDiffs; else ++interiorDiffs;
+            }
+        }
+        ctx.setSampleCount(1);
+        scene.destroy(ctx);
+
+        if (edgeDiffs > 0 && interiorDiffs == 0) {
+            std::cout << "MSAA Test: " << edgeDiffs << " edge pixels smoothed, interior unchanged" << std::endl;
+        } else {
+            std::cerr << "Test Failed: MSAA edge pixels changed " << edgeDiffs << ", interior pixels changed " << interiorDiffs << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+        ctx.setSampleCount(1);
+    }
+
+    void onUpdate(float dt) override {
+        if (m_rotate) m_angle += dt * 10.0f;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "MSAA (per-sample coverage/depth)");
+
+        int msaa = m_msaa ? 1 : 0;
+        if (mu_checkbox(ctx, "4x MSAA", &msaa)) m_msaa = msaa != 0;
+        int rotate = m_rotate ? 1 : 0;
+        if (mu_checkbox(ctx, "Rotate", &rotate)) m_rotate = rotate != 0;
+        mu_label(ctx, "Angle");
+        mu_slider(ctx, &m_angle, 0.0f, 360.0f);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        // 切换采样数会重置深度/模板，颜色保留
+        const int samples = m_msaa ? MSAA_SAMPLES : 1;
+        if (ctx.getSampleCount() != samples) ctx.setSampleCount(samples);
+        m_scene.render(ctx, m_angle);
+    }
+
+private:
+    MsaaScene m_scene;
+    bool m_msaa = true;
+    bool m_rotate = false;
+    float m_angle = 7.0f;
+};
+
+static TestRegistrar registrar("Framebuffer", "MSAA", []() -> ITinyGLTestCase* { return new MsaaTest(); });
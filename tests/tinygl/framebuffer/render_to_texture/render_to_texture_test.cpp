@@ -0,0 +1,213 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace tinygl;
+using namespace framework;
+
+// 渲染到纹理的内容：按 gl_FragCoord 生成的单像素棋盘格 (最高频率，没有 Mipmap 时缩小采样必然走样)
+struct CheckerShader : public ShaderBuiltins {
+    static constexpr int kVaryings = 0;
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = false;
+    Vec4 colorA = {1.0f, 1.0f, 1.0f, 1.0f};
+    Vec4 colorB = {0.0f, 0.0f, 0.0f, 1.0f};
+    int cellSize = 1;
+
+    void vertex(const Vec4* attribs, ShaderContext&) {
+        gl_Position = Vec4(attribs[0].x, attribs[0].y, 0.0f, 1.0f);
+    }
+
+    void fragment(const ShaderContext&) {
+        int cx = (int)gl_FragCoord.x / cellSize;
+        int cy = (int)gl_FragCoord.y / cellSize;
+        gl_FragColor = ((cx + cy) & 1) ? colorA : colorB;
+    }
+};
+
+// 采样渲染结果的平面
+struct PlaneShader : public ShaderBuiltins {
+    static constexpr int kVaryings = 1; // UV
+    static constexpr bool kWritesFragDepth = false;
+    static constexpr bool kUsesDiscard = false;
+    TextureObject* texture = nullptr;
+    SimdMat4 mvp;
+    float uvScale = 1.0f;
+
+    void vertex(const Vec4* attribs, ShaderContext& outCtx) {
+        outCtx.varyings[0] = Vec4(attribs[0].x * 0.5f + 0.5f, attribs[0].y * 0.5f + 0.5f, 0.0f, 0.0f) * uvScale;
+        float posArr[4] = {attribs[0].x, attribs[0].y, 0.0f, 1.0f};
+        float outArr[4];
+        mvp.transformPoint(Simd4f::load(posArr)).store(outArr);
+        gl_Position = Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
+    }
+
+    void fragment(const ShaderContext& inCtx) {
+        gl_FragColor = texture->sample(inCtx.varyings[0].x, inCtx.varyings[0].y, inCtx.rho);
+    }
+};
+
+class RenderToTextureScene {
+public:
+    static constexpr int TEX_SIZE = 128;
+
+    void init(SoftRenderContext& ctx) {
+        // 全屏四边形 (两个三角形)，两个 Pass 共用
+        const float vertices[] = {
+            -1.0f, -1.0f,   1.0f, -1.0f,   1.0f,  1.0f,
+            -1.0f, -1.0f,   1.0f,  1.0f,  -1.0f,  1.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 2, GL_FLOAT, false, 2 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+
+        ctx.glGenTextures(1, &m_tex);
+        ctx.glBindTexture(GL_TEXTURE_2D, m_tex);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEX_SIZE, TEX_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+        ctx.glGenFramebuffers(1, &m_fbo);
+        ctx.glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+        ctx.glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_tex, 0);
+        m_complete = ctx.glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        ctx.glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        setAutoMipmap(ctx, true);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteFramebuffers(1, &m_fbo);
+        ctx.glDeleteTextures(1, &m_tex);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void setAutoMipmap(SoftRenderContext& ctx, bool enabled) { ctx.setFramebufferAutoMipmap(m_fbo, enabled); }
+    bool isComplete() const { return m_complete; }
+
+    // Pass 1：棋盘格渲染到纹理；解绑 FBO 时自动重建 Mipmap
+    void renderTexture(SoftRenderContext& ctx, const Vec4& colorA, int cellSize) {
+        const Viewport saved = ctx.glGetViewport();
+        ctx.glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+        ctx.glViewport(0, 0, TEX_SIZE, TEX_SIZE);
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glBindVertexArray(m_vao);
+        m_checker.colorA = colorA;
+        m_checker.cellSize = cellSize;
+        ctx.glDrawArrays(m_checker, GL_TRIANGLES, 0, 6);
+        ctx.glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        ctx.glViewport(saved.x, saved.y, saved.w, saved.h);
+    }
+
+    // Pass 2：把纹理重复铺在平面上缩小采样
+    void renderPlane(SoftRenderContext& ctx, const Mat4& mvp, float uvScale) {
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glBindVertexArray(m_vao);
+        m_plane.texture = ctx.getTextureObject(m_tex);
+        m_plane.mvp.load(mvp);
+        m_plane.uvScale = uvScale;
+        ctx.glDrawArrays(m_plane, GL_TRIANGLES, 0, 6);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0, m_tex = 0, m_fbo = 0;
+    bool m_complete = false;
+    CheckerShader m_checker;
+    PlaneShader m_plane;
+};
+
+class RenderToTextureTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyAutoMipmap();
+    }
+
+    // 离屏验证：单像素棋盘格渲染到纹理后以约 15 倍缩小采样，结果必须是均匀的平均色；
+    // 再次渲染 (换颜色) 后 Mipmap 必须随之更新
+    void verifyAutoMipmap() {
+        const int size = 64;
+        SoftRenderContext ctx(size, size);
+        RenderToTextureScene scene;
+        scene.init(ctx);
+
+        auto check = [&](const Vec4& colorA, const char* name) {
+            scene.renderTexture(ctx, colorA, 1);
+            ctx.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            ctx.glClear(GL_COLOR_BUFFER_BIT);
+            scene.renderPlane(ctx, Mat4::Identity(), 7.3f); // 非整数倍：避免采样点恰好落在两个纹素正中间
+            const uint32_t* pixels = ctx.getColorBuffer();
+            float maxError = 0.0f;
+            for (int i = 0; i < size * size; ++i) {
+                Vec4 c = ColorUtils::Uint32ToFloat(pixels[i]);
+                maxError = std::max({maxError, std::abs(c.x - colorA.x * 0.5f), std::abs(c.y - colorA.y * 0.5f),
+                                     std::abs(c.z - colorA.z * 0.5f)});
+            }
+            if (maxError > 0.05f) {
+                std::cerr << "Test Failed: render-to-texture " << name << " minified error " << maxError << std::endl;
+                return false;
+            }
+            return true;
+        };
+
+        bool ok = scene.isComplete();
+        if (!ok) std::cerr << "Test Failed: render-to-texture framebuffer incomplete" << std::endl;
+        ok = ok && check(Vec4(1.0f, 1.0f, 1.0f, 1.0f), "white/black");
+        ok = ok && check(Vec4(1.0f, 0.0f, 0.0f, 1.0f), "red/black (re-render)");
+        scene.destroy(ctx);
+        if (ok) std::cout << "Render-To-Texture Test: auto mipmaps follow FBO rendering" << std::endl;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onUpdate(float dt) override {
+        if (m_animate) m_time += dt;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Render-To-Texture + Auto Mipmap");
+
+        int autoMip = m_autoMipmap ? 1 : 0;
+        if (mu_checkbox(ctx, "Auto Mipmap", &autoMip)) m_autoMipmap = autoMip != 0;
+        int animate = m_animate ? 1 : 0;
+        if (mu_checkbox(ctx, "Animate", &animate)) m_animate = animate != 0;
+        mu_label(ctx, "Cell Size");
+        mu_slider(ctx, &m_cellSize, 1.0f, 16.0f);
+        mu_label(ctx, "Without auto mipmap the plane keeps stale mips.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        m_scene.setAutoMipmap(ctx, m_autoMipmap);
+        Vec4 color(0.5f + 0.5f * std::sin(m_time), 0.5f + 0.5f * std::sin(m_time + 2.1f), 0.5f + 0.5f * std::sin(m_time + 4.2f), 1.0f);
+        m_scene.renderTexture(ctx, color, (int)m_cellSize);
+
+        const auto& vp = ctx.glGetViewport();
+        Mat4 proj = Mat4::Perspective(60.0f, (float)vp.w / (float)vp.h, 0.1f, 100.0f);
+        Mat4 view = Mat4::LookAt(Vec4(0.0f, 1.5f, 3.0f, 1.0f), Vec4(0.0f, 0.0f, -6.0f, 1.0f), Vec4(0.0f, 1.0f, 0.0f, 0.0f));
+        // 平面躺在 y = 0 上向远处延伸
+        Mat4 model = Mat4::Translate(0.0f, 0.0f, -8.0f) * Mat4::RotateX(-90.0f) * Mat4::Scale(8.0f, 10.0f, 1.0f);
+        m_scene.renderPlane(ctx, proj * view * model, 16.0f);
+    }
+
+private:
+    RenderToTextureScene m_scene;
+    bool m_autoMipmap = true;
+    bool m_animate = true;
+    float m_cellSize = 1.0f;
+    float m_time = 0.0f;
+};
+
+static TestRegistrar registrar("Framebuffer", "RenderToTexture", []() -> ITinyGLTestCase* { return new RenderToTextureTest(); });
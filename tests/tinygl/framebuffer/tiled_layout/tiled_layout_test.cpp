@@ -0,0 +1,154 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+// 一圈半透明、互相穿插的三角形：覆盖深度测试、混合以及跨越多个 Tile 的边缘
+class TiledScene {
+public:
+    static constexpr int TRIANGLES = 12;
+
+    void init(SoftRenderContext& ctx) {
+        std::vector<float> vertices;
+        for (int i = 0; i < TRIANGLES; ++i) {
+            float a = i * 6.2831853f / TRIANGLES;
+            float z = (i % 3) * 0.3f - 0.3f;
+            float r = 0.5f + 0.5f * std::cos(a), g = 0.5f + 0.5f * std::sin(a), b = (i % 2) ? 1.0f : 0.2f;
+            const float tri[] = {
+                0.0f, 0.0f, -z,                                      r, g, b, 0.7f,
+                std::cos(a) * 0.95f, std::sin(a) * 0.95f, z,         r, g, b, 0.7f,
+                std::cos(a + 0.9f) * 0.95f, std::sin(a + 0.9f) * 0.95f, z, r, g, b, 0.7f,
+            };
+            vertices.insert(vertices.end(), std::begin(tri), std::end(tri));
+        }
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, false, 7 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 4, GL_FLOAT, false, 7 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, float angle) {
+        ctx.glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ctx.glEnable(GL_DEPTH_TEST);
+        ctx.glEnable(GL_BLEND);
+        ctx.glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        ctx.glBindVertexArray(m_vao);
+        m_shader.mvp.load(Mat4::RotateZ(angle));
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, TRIANGLES * 3);
+        ctx.glDisable(GL_BLEND);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0;
+    tests::VertexColorShader m_shader;
+};
+
+class TiledLayoutTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyLayouts();
+    }
+
+    // 离屏验证：尺寸不是 Tile 的整数倍，线性布局与分块布局的 getColorBuffer 结果必须逐像素一致；
+    // 分块布局下 setExternalBuffer 的外部缓冲同样得到线性化后的相同图像
+    void verifyLayouts() {
+        const int w = 150, h = 100;
+        SoftRenderContext ctx(w, h);
+        TiledScene scene;
+        scene.init(ctx);
+
+        scene.render(ctx, 10.0f);
+        std::vector<uint32_t> linear(ctx.getColorBuffer(), ctx.getColorBuffer() + w * h);
+
+        ctx.setTiledFramebufferEnabled(true);
+        scene.render(ctx, 10.0f);
+        const bool tiledMatches = std::memcmp(ctx.getColorBuffer(), linear.data(), linear.size() * sizeof(uint32_t)) == 0;
+
+        std::vector<uint32_t> external(w * h, 0);
+        ctx.setExternalBuffer(external.data());
+        scene.render(ctx, 10.0f);
+        const bool externalReturned = ctx.getColorBuffer() == external.data();
+        const bool externalMatches = external == linear;
+
+        // 切回线性布局：外部缓冲继续作为呈现目标
+        ctx.setTiledFramebufferEnabled(false);
+        scene.render(ctx, 10.0f);
+        ctx.getColorBuffer();
+        const bool linearExternalMatches = external == linear;
+
+        ctx.setExternalBuffer(nullptr);
+        scene.destroy(ctx);
+
+        if (tiledMatches && externalReturned && externalMatches && linearExternalMatches) {
+            std::cout << "Tiled Layout Test: tiled and linear readback identical (" << w << "x" << h << ")" << std::endl;
+        } else {
+            std::cerr << "Test Failed: tiled readback " << tiledMatches << ", external pointer " << externalReturned
+                      << ", tiled external " << externalMatches << ", linear external " << linearExternalMatches << std::endl;
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+        ctx.setExternalBuffer(nullptr);
+        ctx.setTiledFramebufferEnabled(false);
+    }
+
+    void onUpdate(float dt) override {
+        m_angle += dt * 20.0f;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Tile-Swizzled Framebuffer");
+
+        int tiled = m_tiled ? 1 : 0;
+        if (mu_checkbox(ctx, "Tiled Layout", &tiled)) m_tiled = tiled != 0;
+        int external = m_external ? 1 : 0;
+        if (mu_checkbox(ctx, "Present via setExternalBuffer", &external)) m_external = external != 0;
+        mu_label(ctx, "The image must not change when toggling.");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        // 布局只能在默认帧缓冲绑定时切换；深度/模板以清除值重置，颜色保留
+        if (ctx.isTiledFramebufferEnabled() != m_tiled) ctx.setTiledFramebufferEnabled(m_tiled);
+        const bool usingExternal = !m_externalBuffer.empty();
+        if (m_external != usingExternal) {
+            if (m_external) {
+                m_externalBuffer.assign((size_t)ctx.getWidth() * ctx.getHeight(), 0);
+                ctx.setExternalBuffer(m_externalBuffer.data());
+            } else {
+                ctx.setExternalBuffer(nullptr);
+                m_externalBuffer.clear();
+            }
+        }
+        m_scene.render(ctx, m_angle);
+    }
+
+private:
+    TiledScene m_scene;
+    std::vector<uint32_t> m_externalBuffer;
+    bool m_tiled = true;
+    bool m_external = false;
+    float m_angle = 0.0f;
+};
+
+static TestRegistrar registrar("Framebuffer", "TiledLayout", []() -> ITinyGLTestCase* { return new TiledLayoutTest(); });
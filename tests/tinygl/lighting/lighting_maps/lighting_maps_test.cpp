@@ -168,9 +168,10 @@ struct LightingMapsShader : public ShaderBuiltins {
         Vec4 uv = inCtx.varyings[2];
         Vec4 viewDir = normalize(viewPos - fragPos);
 
-        // Sample Textures
-        Vec4 diffMap = material.diffuseMap ? material.diffuseMap->sample(uv.x, uv.y) : Vec4(1,1,1,1);
-        Vec4 specMap = material.specularMap ? material.specularMap->sample(uv.x, uv.y) : Vec4(0.5,0.5,0.5,1);
+        // Sample Textures (UV 在 varyings[2]，LOD 由 Quad 偏导计算)
+        float rho = lodRho(2);
+        Vec4 diffMap = material.diffuseMap ? material.diffuseMap->sample(uv.x, uv.y, rho) : Vec4(1,1,1,1);
+        Vec4 specMap = material.specularMap ? material.specularMap->sample(uv.x, uv.y, rho) : Vec4(0.5,0.5,0.5,1);
 
         Vec4 result = Vec4(0,0,0,0);
         
@@ -0,0 +1,91 @@
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <iomanip>
+#include <cmath>
+#include <tinygl/tinygl.h>
+
+using namespace tinygl;
+
+using TrilinearSampler = Sampler<GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT>;
+
+// 模拟片元着色器的采样循环：UV 沿扫描线递增，rho 在几个 Mip 层级之间变化
+template <typename SampleFn>
+double runLoop(int samples, std::vector<Vec4>& results, SampleFn&& sample) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < samples; ++i) {
+        const float u = (i & 1023) * (1.0f / 1024.0f) * 3.0f;
+        const float v = (i >> 10) * (1.0f / 1024.0f) * 3.0f;
+        const float rho = 0.5f + (float)((i >> 4) & 7);
+        results[i] = sample(u, v, rho);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    const int SIZE = 512;
+    const int SAMPLES = 1024 * 1024;
+    const int TRIALS = 5;
+
+    std::cout << "[Function Pointer vs Typed Sampler] " << SIZE << "x" << SIZE
+              << " RGBA8, GL_LINEAR_MIPMAP_LINEAR, " << SAMPLES << " samples" << std::endl;
+
+    // 1. Texture Setup
+    std::vector<uint32_t> rawData(SIZE * SIZE);
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<uint32_t> dist;
+    for (auto& p : rawData) p = dist(rng);
+
+    SoftRenderContext ctx(16, 16);
+    GLuint texId = 0;
+    ctx.glGenTextures(1, &texId);
+    ctx.glBindTexture(GL_TEXTURE_2D, texId);
+    ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SIZE, SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, rawData.data());
+    ctx.glGenerateMipmap(GL_TEXTURE_2D);
+    ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    const TextureObject* tex = ctx.getTextureObject(texId);
+
+    TrilinearSampler sampler;
+    if (!sampler.bind(tex)) {
+        std::cerr << "Typed sampler did not match the texture parameters" << std::endl;
+        return 1;
+    }
+
+    std::vector<Vec4> pointerResults(SAMPLES), typedResults(SAMPLES);
+
+    // --- Benchmark activeSampler (indirect call) ---
+    double minTimePointer = 1e9;
+    for (int t = 0; t < TRIALS; ++t) {
+        minTimePointer = std::min(minTimePointer, runLoop(SAMPLES, pointerResults,
+                                                          [&](float u, float v, float rho) { return tex->sample(u, v, rho); }));
+    }
+
+    // --- Benchmark Sampler<...> (inlined FilterPolicy) ---
+    double minTimeTyped = 1e9;
+    for (int t = 0; t < TRIALS; ++t) {
+        minTimeTyped = std::min(minTimeTyped, runLoop(SAMPLES, typedResults,
+                                                      [&](float u, float v, float rho) { return sampler.sample(u, v, rho); }));
+    }
+
+    // 两条路径必须给出逐位相同的结果
+    int mismatches = 0;
+    for (int i = 0; i < SAMPLES; ++i) {
+        const Vec4& a = pointerResults[i];
+        const Vec4& b = typedResults[i];
+        if (a.x != b.x || a.y != b.y || a.z != b.z || a.w != b.w) ++mismatches;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Function Pointer Time: " << minTimePointer << " ms" << std::endl;
+    std::cout << "Typed Sampler Time:    " << minTimeTyped << " ms" << std::endl;
+    std::cout << "Speedup: " << minTimePointer / minTimeTyped << "x" << std::endl;
+    std::cout << "Mismatched Samples: " << mismatches << std::endl;
+
+    ctx.glDeleteTextures(1, &texId);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <tinygl/core/texture_codec.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+namespace {
+
+// 测试图像的 RGBA8 分量 (x, y 不同的组合覆盖 0~255)
+uint8_t channel(int x, int y, int c) {
+    static const int kx[4] = {19, 5, 33, 37}, ky[4] = {7, 31, 3, 13};
+    return (uint8_t)((x * kx[c] + y * ky[c] + c * 50) & 0xFF);
+}
+
+// 单通道浮点数据：超出 [0, 1] 的值也要原样保留
+float floatValue(int x, int y) {
+    return -2.5f + x * 0.37f + y * 0.71f;
+}
+
+struct FormatCase {
+    const char* name;
+    GLint internalformat;
+    GLenum format, type;
+    int texelBytes;
+    std::vector<uint8_t> pixels;                  // 行优先的客户端数据
+    std::function<Vec4(int, int)> expected;       // (x, y) 处 getTexelRaw 的期望值
+    float tolerance;
+};
+
+template <typename T>
+std::vector<uint8_t> makePixels(int w, int h, int components, const std::function<T(int, int, int)>& value) {
+    std::vector<uint8_t> bytes((size_t)w * h * components * sizeof(T));
+    T* out = reinterpret_cast<T*>(bytes.data());
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            for (int c = 0; c < components; ++c) out[((size_t)y * w + x) * components + c] = value(x, y, c);
+        }
+    }
+    return bytes;
+}
+
+float unorm(int x, int y, int c, float range) {
+    return std::round(channel(x, y, c) / 255.0f * range) / range;
+}
+
+// 每种紧凑格式分别走两条上传路径：与存储布局一致的客户端数据 (直接拷贝) 与需要 packPixels 转换的数据
+std::vector<FormatCase> makeCases(int w, int h) {
+    const auto rgba = makePixels<uint8_t>(w, h, 4, [](int x, int y, int c) { return channel(x, y, c); });
+    const auto floats = makePixels<float>(w, h, 1, [](int x, int y, int) { return floatValue(x, y); });
+    std::vector<FormatCase> cases;
+
+    cases.push_back({"R8 (GL_RED)", GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1,
+                     makePixels<uint8_t>(w, h, 1, [](int x, int y, int) { return channel(x, y, 0); }),
+                     [](int x, int y) { return Vec4(channel(x, y, 0) / 255.0f, 0.0f, 0.0f, 1.0f); }, 1e-6f});
+    cases.push_back({"R8 (GL_RGBA)", GL_R8, GL_RGBA, GL_UNSIGNED_BYTE, 1, rgba,
+                     [](int x, int y) { return Vec4(channel(x, y, 0) / 255.0f, 0.0f, 0.0f, 1.0f); }, 1e-6f});
+    cases.push_back({"RG8 (GL_RG)", GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2,
+                     makePixels<uint8_t>(w, h, 2, [](int x, int y, int c) { return channel(x, y, c); }),
+                     [](int x, int y) { return Vec4(channel(x, y, 0) / 255.0f, channel(x, y, 1) / 255.0f, 0.0f, 1.0f); }, 1e-6f});
+    cases.push_back({"RGB565 (5_6_5)", GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2,
+                     makePixels<uint16_t>(w, h, 1, [](int x, int y, int) {
+                         return (uint16_t)((channel(x, y, 0) >> 3) << 11 | (channel(x, y, 1) >> 2) << 5 | channel(x, y, 2) >> 3);
+                     }),
+                     [](int x, int y) {
+                         return Vec4((channel(x, y, 0) >> 3) / 31.0f, (channel(x, y, 1) >> 2) / 63.0f, (channel(x, y, 2) >> 3) / 31.0f, 1.0f);
+                     }, 1e-6f});
+    cases.push_back({"RGB565 (GL_RGBA)", GL_RGB565, GL_RGBA, GL_UNSIGNED_BYTE, 2, rgba,
+                     [](int x, int y) { return Vec4(unorm(x, y, 0, 31.0f), unorm(x, y, 1, 63.0f), unorm(x, y, 2, 31.0f), 1.0f); }, 1e-6f});
+    cases.push_back({"RGBA4 (4_4_4_4)", GL_RGBA4, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2,
+                     makePixels<uint16_t>(w, h, 1, [](int x, int y, int) {
+                         return (uint16_t)((channel(x, y, 0) >> 4) << 12 | (channel(x, y, 1) >> 4) << 8 |
+                                           (channel(x, y, 2) >> 4) << 4 | channel(x, y, 3) >> 4);
+                     }),
+                     [](int x, int y) {
+                         return Vec4((channel(x, y, 0) >> 4) / 15.0f, (channel(x, y, 1) >> 4) / 15.0f,
+                                     (channel(x, y, 2) >> 4) / 15.0f, (channel(x, y, 3) >> 4) / 15.0f);
+                     }, 1e-6f});
+    cases.push_back({"RGBA4 (GL_RGBA)", GL_RGBA4, GL_RGBA, GL_UNSIGNED_BYTE, 2, rgba,
+                     [](int x, int y) {
+                         return Vec4(unorm(x, y, 0, 15.0f), unorm(x, y, 1, 15.0f), unorm(x, y, 2, 15.0f), unorm(x, y, 3, 15.0f));
+                     }, 1e-6f});
+    cases.push_back({"R16F (GL_HALF_FLOAT)", GL_R16F, GL_RED, GL_HALF_FLOAT, 2,
+                     makePixels<uint16_t>(w, h, 1, [](int x, int y, int) { return floatToHalf(floatValue(x, y)); }),
+                     [](int x, int y) { return Vec4(halfToFloat(floatToHalf(floatValue(x, y))), 0.0f, 0.0f, 1.0f); }, 0.0f});
+    cases.push_back({"R16F (GL_FLOAT)", GL_R16F, GL_RED, GL_FLOAT, 2, floats,
+                     [](int x, int y) { return Vec4(halfToFloat(floatToHalf(floatValue(x, y))), 0.0f, 0.0f, 1.0f); }, 0.0f});
+    cases.push_back({"R32F (GL_FLOAT)", GL_R32F, GL_RED, GL_FLOAT, 4, floats,
+                     [](int x, int y) { return Vec4(floatValue(x, y), 0.0f, 0.0f, 1.0f); }, 0.0f});
+    cases.push_back({"R32F (GL_RGBA)", GL_R32F, GL_RGBA, GL_UNSIGNED_BYTE, 4, rgba,
+                     [](int x, int y) { return Vec4(channel(x, y, 0) / 255.0f, 0.0f, 0.0f, 1.0f); }, 1e-6f});
+    return cases;
+}
+
+float maxDiff(const Vec4& a, const Vec4& b) {
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z), std::abs(a.w - b.w)});
+}
+
+} // namespace
+
+// 同一张渐变图按 R8 / RG8 / RGB565 / RGBA4 / R16F / R32F / RGBA8 存储，画在一个四边形上
+class CompactScene {
+public:
+    static constexpr int FORMAT_COUNT = 7;
+    static constexpr GLint FORMATS[FORMAT_COUNT] = {GL_RGBA8, GL_R8, GL_RG8, GL_RGB565, GL_RGBA4, GL_R16F, GL_R32F};
+    static constexpr const char* NAMES[FORMAT_COUNT] = {"RGBA8", "R8", "RG8", "RGB565", "RGBA4", "R16F", "R32F"};
+
+    void init(SoftRenderContext& ctx) {
+        const float vertices[] = {
+            // Position (3) + UV (2)
+            -1.0f, -1.0f, 0.0f,   0.0f, 0.0f,
+             1.0f, -1.0f, 0.0f,   1.0f, 0.0f,
+             1.0f,  1.0f, 0.0f,   1.0f, 1.0f,
+            -1.0f, -1.0f, 0.0f,   0.0f, 0.0f,
+             1.0f,  1.0f, 0.0f,   1.0f, 1.0f,
+            -1.0f,  1.0f, 0.0f,   0.0f, 1.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+
+        const int size = 256;
+        std::vector<uint32_t> pixels((size_t)size * size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const uint32_t r = x, g = y, b = 255 - (x + y) / 2, a = 255;
+                pixels[(size_t)y * size + x] = (a << 24) | (b << 16) | (g << 8) | r;
+            }
+        }
+        ctx.glGenTextures(FORMAT_COUNT, m_textures);
+        for (int i = 0; i < FORMAT_COUNT; ++i) {
+            ctx.glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+            ctx.glTexImage2D(GL_TEXTURE_2D, 0, FORMATS[i], size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            ctx.glGenerateMipmap(GL_TEXTURE_2D);
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            m_bytes[i] = (size_t)size * size * textureTexelBytes(ctx.getTextureObject(m_textures[i])->format);
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteTextures(FORMAT_COUNT, m_textures);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, int formatIndex, const Mat4& mvp) {
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glBindVertexArray(m_vao);
+        m_shader.texture = ctx.getTextureObject(m_textures[formatIndex]);
+        m_shader.mvp.load(mvp);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 6);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+    size_t levelZeroBytes(int formatIndex) const { return m_bytes[formatIndex]; }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0;
+    GLuint m_textures[FORMAT_COUNT] = {};
+    size_t m_bytes[FORMAT_COUNT] = {};
+    tests::TexturedShader m_shader;
+};
+
+class CompactFormatsTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifyFormats();
+    }
+
+    // 离屏验证 (非 4 对齐的 13x7 图像)：
+    // 1. 每种紧凑格式按请求的格式存储，每 texel 占 textureTexelBytes 字节
+    // 2. 直接拷贝与 packPixels 转换两条路径的 getTexelRaw 读回都与按格式量化的期望值一致 (浮点格式保留 [0, 1] 之外的值)
+    // 3. glTexSubImage2D 只改写目标矩形，Level 1 按 2x2 平均后经 storeTexel 写回 (误差不超过半个量化步长)
+    void verifyFormats() {
+        const int w = 13, h = 7;
+        SoftRenderContext ctx(16, 16);
+        GLuint tex = 0;
+        ctx.glGenTextures(1, &tex);
+        ctx.glBindTexture(GL_TEXTURE_2D, tex);
+        TextureObject* obj = ctx.getTextureObject(tex);
+
+        int failures = 0;
+        for (const FormatCase& c : makeCases(w, h)) {
+            ctx.glTexImage2D(GL_TEXTURE_2D, 0, c.internalformat, w, h, 0, c.format, c.type, c.pixels.data());
+            if (obj->format != (GLenum)c.internalformat || textureTexelBytes(obj->format) != c.texelBytes ||
+                obj->data.size() * sizeof(uint32_t) != (size_t)((w + 3) / 4) * ((h + 3) / 4) * 16 * c.texelBytes) {
+                std::cerr << "Test Failed: " << c.name << " stored as format " << obj->format << " with "
+                          << obj->data.size() * sizeof(uint32_t) << " bytes" << std::endl;
+                ++failures;
+                continue;
+            }
+            float worst = 0.0f;
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) worst = std::max(worst, maxDiff(getTexelRaw(*obj, 0, x, y), c.expected(x, y)));
+            }
+            if (worst > c.tolerance) {
+                std::cerr << "Test Failed: " << c.name << " read back differs by " << worst << std::endl;
+                ++failures;
+            }
+        }
+
+        failures += verifySubImageAndMips(ctx, obj);
+        ctx.glDeleteTextures(1, &tex);
+        if (failures == 0) std::cout << "Compact Formats Test: all formats stored natively and read back exactly" << std::endl;
+    }
+
+    int verifySubImageAndMips(SoftRenderContext& ctx, TextureObject* obj) {
+        const int w = 13, h = 7;
+        const float steps[] = {1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 31.0f, 1.0f / 15.0f};
+        const GLint formats[] = {GL_R8, GL_RG8, GL_RGB565, GL_RGBA4};
+        const char* names[] = {"R8", "RG8", "RGB565", "RGBA4"};
+        const auto rgba = makePixels<uint8_t>(w, h, 4, [](int x, int y, int c) { return channel(x, y, c); });
+        const std::vector<uint8_t> patch(5 * 3 * 4, 0xFF);
+
+        int failures = 0;
+        for (int i = 0; i < 4; ++i) {
+            ctx.glTexImage2D(GL_TEXTURE_2D, 0, formats[i], w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            std::vector<Vec4> before((size_t)w * h);
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) before[(size_t)y * w + x] = getTexelRaw(*obj, 0, x, y);
+            }
+
+            // 跨块边界的 5x3 白色矩形
+            ctx.glTexSubImage2D(GL_TEXTURE_2D, 0, 2, 3, 5, 3, GL_RGBA, GL_UNSIGNED_BYTE, patch.data());
+            int wrong = 0;
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    const bool inside = x >= 2 && x < 7 && y >= 3 && y < 6;
+                    const Vec4 white = getTexelRaw(*obj, 0, x, y);
+                    const Vec4 expect = inside ? Vec4(1.0f, formats[i] == GL_R8 ? 0.0f : 1.0f,
+                                                      formats[i] == GL_R8 || formats[i] == GL_RG8 ? 0.0f : 1.0f, 1.0f)
+                                               : before[(size_t)y * w + x];
+                    if (maxDiff(white, expect) > 1e-6f) ++wrong;
+                }
+            }
+
+            ctx.glGenerateMipmap(GL_TEXTURE_2D);
+            float worst = 0.0f;
+            for (int y = 0; y < h / 2; ++y) {
+                for (int x = 0; x < w / 2; ++x) {
+                    const Vec4 avg = (getTexelRaw(*obj, 0, x * 2, y * 2) + getTexelRaw(*obj, 0, x * 2 + 1, y * 2) +
+                                      getTexelRaw(*obj, 0, x * 2, y * 2 + 1) + getTexelRaw(*obj, 0, x * 2 + 1, y * 2 + 1)) * 0.25f;
+                    worst = std::max(worst, maxDiff(getTexelRaw(*obj, 1, x, y), avg));
+                }
+            }
+            if (wrong != 0 || worst > steps[i] * 0.5f + 1e-5f) {
+                std::cerr << "Test Failed: " << names[i] << " sub-image mismatches " << wrong << ", level 1 error " << worst << std::endl;
+                ++failures;
+            }
+        }
+        return failures;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Native Compact Formats");
+
+        mu_layout_row(ctx, 4, (int[]){ 60, 60, 60, 60 }, 0);
+        for (int i = 0; i < CompactScene::FORMAT_COUNT; ++i) {
+            if (mu_button(ctx, CompactScene::NAMES[i])) m_format = i;
+        }
+
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Format: %s", CompactScene::NAMES[m_format]);
+        mu_label(ctx, buf);
+        snprintf(buf, sizeof(buf), "Level 0: %zu KB", m_scene.levelZeroBytes(m_format) / 1024);
+        mu_label(ctx, buf);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        const auto& vp = ctx.glGetViewport();
+        const float aspect = (float)vp.w / (float)vp.h;
+        ctx.glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_scene.render(ctx, m_format, Mat4::Scale(0.8f / aspect, 0.8f, 1.0f));
+    }
+
+private:
+    CompactScene m_scene;
+    int m_format = 1;
+};
+
+static TestRegistrar registrar("Texture", "Compact Formats", []() -> ITinyGLTestCase* { return new CompactFormatsTest(); });
@@ -0,0 +1,251 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <tinygl/core/texture_codec.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+namespace {
+
+// 离线烘焙 (与 AssetCooker::CookTexture 相同)：逐级 2x2 盒式降采样，每一级整体编码为 4x4 块
+std::vector<std::vector<uint32_t>> cookMipChain(GLenum format, std::vector<uint32_t> level, int w, int h) {
+    std::vector<std::vector<uint32_t>> chain;
+    while (true) {
+        std::vector<uint32_t> blocks(textureImageWords(format, w, h));
+        encodeTextureImage(format, level.data(), w, h, blocks.data());
+        chain.push_back(std::move(blocks));
+        if (w <= 1 && h <= 1) break;
+
+        const int nextW = std::max(1, w / 2), nextH = std::max(1, h / 2);
+        std::vector<uint32_t> next((size_t)nextW * nextH);
+        for (int y = 0; y < nextH; ++y) {
+            for (int x = 0; x < nextW; ++x) {
+                const int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+                const int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+                const uint32_t p[4] = {level[y0 * w + x0], level[y0 * w + x1], level[y1 * w + x0], level[y1 * w + x1]};
+                uint32_t out = 0;
+                for (int c = 0; c < 32; c += 8) {
+                    uint32_t sum = 2;
+                    for (uint32_t v : p) sum += (v >> c) & 0xFF;
+                    out |= (sum / 4) << c;
+                }
+                next[(size_t)y * nextW + x] = out;
+            }
+        }
+        level = std::move(next);
+        w = nextW;
+        h = nextH;
+    }
+    return chain;
+}
+
+} // namespace
+
+// 同一张图片的 RGBA8 / BC1 / ETC2 三份纹理，画在一个四边形上
+class CompressedScene {
+public:
+    static constexpr int FORMAT_COUNT = 3;
+    static constexpr GLenum FORMATS[FORMAT_COUNT] = {GL_RGBA8, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGB8_ETC2};
+
+    void init(SoftRenderContext& ctx, const std::vector<uint32_t>& pixels, int w, int h) {
+        const float vertices[] = {
+            // Position (3) + UV (2)
+            -1.0f, -1.0f, 0.0f,   0.0f, 0.0f,
+             1.0f, -1.0f, 0.0f,   1.0f, 0.0f,
+             1.0f,  1.0f, 0.0f,   1.0f, 1.0f,
+            -1.0f, -1.0f, 0.0f,   0.0f, 0.0f,
+             1.0f,  1.0f, 0.0f,   1.0f, 1.0f,
+            -1.0f,  1.0f, 0.0f,   0.0f, 1.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+
+        ctx.glGenTextures(FORMAT_COUNT, m_textures);
+        for (int i = 0; i < FORMAT_COUNT; ++i) {
+            ctx.glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+            m_bytes[i] = 0;
+            if (FORMATS[i] == GL_RGBA8) {
+                ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                ctx.glGenerateMipmap(GL_TEXTURE_2D);
+                m_bytes[i] = (size_t)w * h * 4;
+            } else {
+                const auto chain = cookMipChain(FORMATS[i], pixels, w, h);
+                for (size_t level = 0; level < chain.size(); ++level) {
+                    const GLsizei bytes = (GLsizei)(chain[level].size() * sizeof(uint32_t));
+                    ctx.glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, FORMATS[i], std::max(1, w >> level), std::max(1, h >> level),
+                                               0, bytes, chain[level].data());
+                    if (level == 0) m_bytes[i] = bytes;
+                }
+            }
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        }
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteTextures(FORMAT_COUNT, m_textures);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void render(SoftRenderContext& ctx, int formatIndex, const Mat4& mvp) {
+        ctx.glDisable(GL_DEPTH_TEST);
+        ctx.glBindVertexArray(m_vao);
+        m_shader.texture = ctx.getTextureObject(m_textures[formatIndex]);
+        m_shader.mvp.load(mvp);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 6);
+        ctx.glEnable(GL_DEPTH_TEST);
+    }
+
+    size_t levelZeroBytes(int formatIndex) const { return m_bytes[formatIndex]; }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0;
+    GLuint m_textures[FORMAT_COUNT] = {};
+    size_t m_bytes[FORMAT_COUNT] = {};
+    tests::TexturedShader m_shader;
+};
+
+class CompressedTextureTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        int w = 0, h = 0, channels = 0;
+        stbi_set_flip_vertically_on_load(true);
+        unsigned char* data = stbi_load("assets/container.jpg", &w, &h, &channels, 4);
+        std::vector<uint32_t> pixels;
+        if (data) {
+            pixels.resize((size_t)w * h);
+            std::memcpy(pixels.data(), data, pixels.size() * 4);
+            stbi_image_free(data);
+        } else {
+            w = h = 256;
+            pixels = makePattern(w, h);
+        }
+        m_scene.init(ctx, pixels, w, h);
+        verifyCompressed();
+    }
+
+    // 离屏验证：程序生成的平滑图案 1:1 绘制，BC1 / ETC2 与 RGBA8 的 PSNR 必须高于 30 dB，且不能与 RGBA8 完全相同
+    // (确认确实走了压缩数据的解码路径)
+    void verifyCompressed() {
+        const int size = 64;
+        SoftRenderContext ctx(size, size);
+        CompressedScene scene;
+        scene.init(ctx, makePattern(size, size), size, size);
+
+        std::vector<uint32_t> images[CompressedScene::FORMAT_COUNT];
+        for (int i = 0; i < CompressedScene::FORMAT_COUNT; ++i) {
+            ctx.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            ctx.glClear(GL_COLOR_BUFFER_BIT);
+            scene.render(ctx, i, Mat4::Identity());
+            images[i].assign(ctx.getColorBuffer(), ctx.getColorBuffer() + size * size);
+        }
+        scene.destroy(ctx);
+
+        bool ok = true;
+        for (int i = 1; i < CompressedScene::FORMAT_COUNT; ++i) {
+            const float psnr = computePsnr(images[0], images[i]);
+            if (psnr < 30.0f || images[i] == images[0]) {
+                std::cerr << "Test Failed: " << kFormatNames[i] << " PSNR " << psnr << " dB vs RGBA8" << std::endl;
+                ok = false;
+            } else {
+                m_verifiedPsnr[i] = psnr;
+            }
+        }
+        if (ok) std::cout << "Compressed Texture Test: BC1 " << m_verifiedPsnr[1] << " dB, ETC2 " << m_verifiedPsnr[2] << " dB vs RGBA8" << std::endl;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onUpdate(float dt) override {
+        if (m_animate) m_time += dt;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "Cooked Compressed Textures");
+        for (int i = 0; i < CompressedScene::FORMAT_COUNT; ++i) {
+            char label[32];
+            snprintf(label, sizeof(label), m_format == i ? "[%s]" : "%s", kFormatNames[i]);
+            if (mu_button(ctx, label)) m_format = i;
+        }
+        int animate = m_animate ? 1 : 0;
+        if (mu_checkbox(ctx, "Animate", &animate)) m_animate = animate != 0;
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Level 0: %zu KB", m_scene.levelZeroBytes(m_format) / 1024);
+        mu_label(ctx, buf);
+        if (m_format > 0) {
+            snprintf(buf, sizeof(buf), "Self-check PSNR: %.1f dB", m_verifiedPsnr[m_format]);
+            mu_label(ctx, buf);
+        }
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        const auto& vp = ctx.glGetViewport();
+        Mat4 proj = Mat4::Perspective(60.0f, (float)vp.w / (float)vp.h, 0.1f, 100.0f);
+        Mat4 model = Mat4::Translate(0.0f, 0.0f, -2.5f) * Mat4::RotateY(25.0f * std::sin(m_time * 0.5f)) * Mat4::RotateX(-20.0f);
+        ctx.glClearColor(0.15f, 0.15f, 0.15f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_scene.render(ctx, m_format, proj * model);
+    }
+
+private:
+    static constexpr const char* kFormatNames[CompressedScene::FORMAT_COUNT] = {"RGBA8", "BC1", "ETC2"};
+
+    // 平滑渐变叠加低频圆环：块内颜色近似共线，压缩误差小
+    static std::vector<uint32_t> makePattern(int w, int h) {
+        std::vector<uint32_t> pixels((size_t)w * h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const float u = (float)x / w, v = (float)y / h;
+                const float ring = 0.5f + 0.5f * std::sin(std::sqrt((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f)) * 25.0f);
+                const int r = (int)(255.0f * (0.2f + 0.6f * u * ring));
+                const int g = (int)(255.0f * (0.2f + 0.6f * v * ring));
+                const int b = (int)(255.0f * (0.3f + 0.5f * ring));
+                pixels[(size_t)y * w + x] = (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | 0xFF000000u;
+            }
+        }
+        return pixels;
+    }
+
+    static float computePsnr(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        double mse = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            for (int c = 0; c < 24; c += 8) {
+                const double d = (double)((a[i] >> c) & 0xFF) - (double)((b[i] >> c) & 0xFF);
+                mse += d * d;
+            }
+        }
+        mse /= (double)a.size() * 3.0;
+        return mse == 0.0 ? 99.0f : (float)(10.0 * std::log10(255.0 * 255.0 / mse));
+    }
+
+    CompressedScene m_scene;
+    int m_format = 1;
+    bool m_animate = true;
+    float m_time = 0.0f;
+    float m_verifiedPsnr[CompressedScene::FORMAT_COUNT] = {};
+};
+
+static TestRegistrar registrar("Texture", "Compressed", []() -> ITinyGLTestCase* { return new CompressedTextureTest(); });
@@ -16,6 +16,7 @@ struct Vertex {
 };
 
 struct CubeShader : public ShaderBuiltins {
+    static constexpr int kVaryings = 2; // uv, color
     TextureObject* texture = nullptr;
     SimdMat4 mvp; 
     Vec4 tintColor = {1.0f, 1.0f, 1.0f, 1.0f};
@@ -42,6 +43,15 @@ struct CubeShader : public ShaderBuiltins {
         gl_Position = Vec4(outArr[0], outArr[1], outArr[2], outArr[3]);
     }
 
+    // Batched Vertex Shader (SoA, 4 vertices per call)
+    void vertexBatch(const Vec4Packet* attribs, VertexBatchContext& outCtx) {
+        outCtx.varyings[0] = attribs[2]; // UV
+        outCtx.varyings[1] = attribs[1]; // Color
+
+        Vec4Packet pos(attribs[0].x, attribs[0].y, attribs[0].z, Simd4f(1.0f));
+        outCtx.gl_Position = mvp.transformPacket(pos);
+    }
+
     // Fragment Shader
     void fragment(ShaderContext& inCtx) {
         VS_Out in(inCtx.varyings);
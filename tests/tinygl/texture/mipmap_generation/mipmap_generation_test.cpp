@@ -0,0 +1,245 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+namespace {
+
+// 标量参考：2x2 盒式降采样 (奇数尺寸时钳制到最后一行 / 列)，逐通道 (a + b + c + d + 2) / 4
+// sRGB 模式下 RGB 在线性空间按浮点平均，Alpha 仍按整数平均
+std::vector<uint32_t> referenceLevel(const std::vector<uint32_t>& src, int w, int h, bool srgb) {
+    auto toLinear = [](uint32_t c) {
+        const float v = c / 255.0f;
+        return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    };
+    auto fromLinear = [](float l) {
+        const float v = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+        return (uint32_t)(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+
+    const int nextW = std::max(1, w / 2), nextH = std::max(1, h / 2);
+    std::vector<uint32_t> next((size_t)nextW * nextH);
+    for (int y = 0; y < nextH; ++y) {
+        for (int x = 0; x < nextW; ++x) {
+            const int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+            const int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+            const uint32_t p[4] = {src[(size_t)y0 * w + x0], src[(size_t)y0 * w + x1], src[(size_t)y1 * w + x0], src[(size_t)y1 * w + x1]};
+            uint32_t out = 0;
+            for (int c = 0; c < 32; c += 8) {
+                uint32_t avg;
+                if (srgb && c < 24) {
+                    float sum = 0.0f;
+                    for (uint32_t v : p) sum += toLinear((v >> c) & 0xFF);
+                    avg = fromLinear(sum * 0.25f);
+                } else {
+                    uint32_t sum = 2;
+                    for (uint32_t v : p) sum += (v >> c) & 0xFF;
+                    avg = sum / 4;
+                }
+                out |= avg << c;
+            }
+            next[(size_t)y * nextW + x] = out;
+        }
+    }
+    return next;
+}
+
+uint32_t packRGBA8(const Vec4& c) {
+    auto u = [](float v) { return (uint32_t)(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return (u(c.w) << 24) | (u(c.z) << 16) | (u(c.y) << 8) | u(c.x);
+}
+
+// 两个 RGBA8 值逐通道的最大差
+int channelDiff(uint32_t a, uint32_t b) {
+    int worst = 0;
+    for (int c = 0; c < 32; c += 8) worst = std::max(worst, std::abs((int)((a >> c) & 0xFF) - (int)((b >> c) & 0xFF)));
+    return worst;
+}
+
+} // namespace
+
+// 高频棋盘格纹理，缩小到远处平面上观察 Mipmap 效果；可切换 sRGB 正确的降采样并重新生成
+class MipGenScene {
+public:
+    static constexpr int TEX_SIZE = 1024;
+
+    void init(SoftRenderContext& ctx) {
+        const float vertices[] = {
+            // Position (3) + UV (2)
+            -1.0f, 0.0f, -1.0f,   0.0f, 0.0f,
+             1.0f, 0.0f, -1.0f,   8.0f, 0.0f,
+             1.0f, 0.0f,  1.0f,   8.0f, 8.0f,
+            -1.0f, 0.0f, -1.0f,   0.0f, 0.0f,
+             1.0f, 0.0f,  1.0f,   8.0f, 8.0f,
+            -1.0f, 0.0f,  1.0f,   0.0f, 8.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+
+        std::vector<uint32_t> pixels((size_t)TEX_SIZE * TEX_SIZE);
+        for (int y = 0; y < TEX_SIZE; ++y) {
+            for (int x = 0; x < TEX_SIZE; ++x) {
+                const bool check = ((x / 2) + (y / 2)) & 1;
+                pixels[(size_t)y * TEX_SIZE + x] = check ? 0xFFFFFFFFu : 0xFF000000u;
+            }
+        }
+        ctx.glGenTextures(1, &m_texture);
+        ctx.glBindTexture(GL_TEXTURE_2D, m_texture);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEX_SIZE, TEX_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteTextures(1, &m_texture);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    // 按 srgb 模式重建整条 Mipmap 链 (切换模式会使旧链失效)，返回耗时
+    float regenerate(SoftRenderContext& ctx, bool srgb) {
+        ctx.setTextureSRGBMipmap(m_texture, srgb);
+        ctx.glBindTexture(GL_TEXTURE_2D, m_texture);
+        ctx.getTextureObject(m_texture)->mipChainValid = false;
+        auto start = std::chrono::high_resolution_clock::now();
+        ctx.glGenerateMipmap(GL_TEXTURE_2D);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+    void render(SoftRenderContext& ctx, const Mat4& mvp) {
+        ctx.glBindVertexArray(m_vao);
+        m_shader.texture = ctx.getTextureObject(m_texture);
+        m_shader.mvp.load(mvp);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 6);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0, m_texture = 0;
+    tests::TexturedShader m_shader;
+};
+
+class MipmapGenerationTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        m_lastMs = m_scene.regenerate(ctx, m_srgb);
+        verifyMipmaps();
+    }
+
+    // 离屏验证：glGenerateMipmap 的每一层与标量参考逐 texel 比较
+    // 1. 线性模式必须逐字节一致：内部整块走 SIMD downsampleBlockRGBA8，边缘块走标量 averageRGBA8，
+    //    图像包含 0 / 255 与需要进位的值，覆盖 16-bit 累加与四舍五入；512x384 超过并行阈值，覆盖 JobSystem 分带
+    // 2. sRGB 模式与浮点参考相差不超过 1 (查表把线性值量化为 12 bit)
+    void verifyMipmaps() {
+        SoftRenderContext ctx(16, 16);
+        GLuint tex = 0;
+        ctx.glGenTextures(1, &tex);
+        ctx.glBindTexture(GL_TEXTURE_2D, tex);
+
+        struct Size {
+            int w, h;
+        };
+        const Size sizes[] = {{64, 64}, {100, 60}, {37, 23}, {1, 9}, {512, 384}};
+        int failures = 0;
+        for (const Size& s : sizes) {
+            std::vector<uint32_t> image((size_t)s.w * s.h);
+            uint32_t state = 12345u;
+            for (uint32_t& p : image) {
+                state = state * 1664525u + 1013904223u;
+                const uint32_t bits = state >> 8;
+                // 约四分之一的 texel 取 0 或 255，其余随机
+                p = (bits & 3) == 0 ? ((bits & 4) ? 0xFFFFFFFFu : 0u) : state ^ (state >> 13);
+            }
+            for (int srgb = 0; srgb < 2; ++srgb) {
+                ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, s.w, s.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+                ctx.setTextureSRGBMipmap(tex, srgb != 0);
+                ctx.glGenerateMipmap(GL_TEXTURE_2D);
+                const TextureObject* obj = ctx.getTextureObject(tex);
+
+                std::vector<uint32_t> expected = image;
+                int w = s.w, h = s.h, worst = 0, badLevel = -1;
+                for (int level = 1; level < (int)obj->mipLevels.size(); ++level) {
+                    expected = referenceLevel(expected, w, h, srgb != 0);
+                    w = std::max(1, w / 2);
+                    h = std::max(1, h / 2);
+                    for (int y = 0; y < h; ++y) {
+                        for (int x = 0; x < w; ++x) {
+                            const int d = channelDiff(packRGBA8(getTexelRaw(*obj, level, x, y)), expected[(size_t)y * w + x]);
+                            if (d > (srgb ? 1 : 0) && badLevel < 0) badLevel = level;
+                            worst = std::max(worst, d);
+                        }
+                    }
+                }
+                if (badLevel >= 0 || w != 1 || h != 1) {
+                    std::cerr << "Test Failed: " << s.w << "x" << s.h << (srgb ? " sRGB" : " linear") << " mipmaps differ from the scalar reference by "
+                              << worst << " at level " << badLevel << " (last level " << w << "x" << h << ")" << std::endl;
+                    ++failures;
+                }
+            }
+            ctx.setTextureSRGBMipmap(tex, false);
+        }
+        ctx.glDeleteTextures(1, &tex);
+        if (failures == 0) std::cout << "Mipmap Generation Test: SIMD and scalar box filters agree at every level" << std::endl;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "SIMD / Parallel Mipmap Generation");
+
+        int srgb = m_srgb ? 1 : 0;
+        if (mu_checkbox(ctx, "sRGB-correct", &srgb)) {
+            m_srgb = srgb != 0;
+            m_regenerate = true;
+        }
+        if (mu_button(ctx, "Regenerate")) m_regenerate = true;
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%dx%d chain: %.3f ms", MipGenScene::TEX_SIZE, MipGenScene::TEX_SIZE, m_lastMs);
+        mu_label(ctx, buf);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        if (m_regenerate) {
+            m_lastMs = m_scene.regenerate(ctx, m_srgb);
+            m_regenerate = false;
+        }
+        const auto& vp = ctx.glGetViewport();
+        Mat4 proj = Mat4::Perspective(45.0f, (float)vp.w / (float)vp.h, 0.1f, 100.0f);
+        Mat4 model = Mat4::Translate(0.0f, -0.5f, -2.0f) * Mat4::RotateX(15.0f);
+        ctx.glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_scene.render(ctx, proj * model);
+    }
+
+private:
+    MipGenScene m_scene;
+    bool m_srgb = false;
+    bool m_regenerate = false;
+    float m_lastMs = 0.0f;
+};
+
+static TestRegistrar registrar("Texture", "Mipmap Generation", []() -> ITinyGLTestCase* { return new MipmapGenerationTest(); });
@@ -0,0 +1,278 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <test_shaders.h>
+#include <tinygl/core/texture_codec.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace tinygl;
+using namespace framework;
+
+namespace {
+
+// 每个 seed 一幅不同的 RGBA8 噪声图 (整数哈希，结果与平台无关)
+uint32_t noisePixel(int x, int y, uint32_t seed) {
+    uint32_t v = (uint32_t)x * 0x9E3779B1u ^ (uint32_t)y * 0x85EBCA77u ^ seed * 0xC2B2AE3Du;
+    v ^= v >> 15;
+    v *= 0x2C1B3C6Du;
+    v ^= v >> 12;
+    return v;
+}
+
+std::vector<uint32_t> noiseImage(int w, int h, uint32_t seed) {
+    std::vector<uint32_t> image((size_t)w * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) image[(size_t)y * w + x] = noisePixel(x, y, seed);
+    }
+    return image;
+}
+
+struct Region {
+    int x, y, w, h;
+};
+
+// 用 seed 图像覆盖 image 中的矩形，同时把矩形内容上传到当前绑定纹理
+void uploadRegion(SoftRenderContext& ctx, std::vector<uint32_t>& image, int imageWidth, const Region& r, uint32_t seed) {
+    std::vector<uint32_t> patch((size_t)r.w * r.h);
+    for (int y = 0; y < r.h; ++y) {
+        for (int x = 0; x < r.w; ++x) {
+            const uint32_t p = noisePixel(r.x + x, r.y + y, seed);
+            patch[(size_t)y * r.w + x] = p;
+            image[(size_t)(r.y + y) * imageWidth + r.x + x] = p;
+        }
+    }
+    ctx.glTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y, r.w, r.h, GL_RGBA, GL_UNSIGNED_BYTE, patch.data());
+}
+
+} // namespace
+
+// 每帧把一块移动的 "视频" 区域流式写入纹理 (glTexSubImage2D + 增量 Mipmap)，画在倾斜的平面上
+class SubImageScene {
+public:
+    static constexpr int TEX_SIZE = 512;
+    static constexpr int PATCH_SIZE = 96;
+
+    void init(SoftRenderContext& ctx) {
+        const float vertices[] = {
+            // Position (3) + UV (2)
+            -1.0f, 0.0f, -1.0f,   0.0f, 0.0f,
+             1.0f, 0.0f, -1.0f,   1.0f, 0.0f,
+             1.0f, 0.0f,  1.0f,   1.0f, 1.0f,
+            -1.0f, 0.0f, -1.0f,   0.0f, 0.0f,
+             1.0f, 0.0f,  1.0f,   1.0f, 1.0f,
+            -1.0f, 0.0f,  1.0f,   0.0f, 1.0f,
+        };
+        ctx.glGenVertexArrays(1, &m_vao);
+        ctx.glBindVertexArray(m_vao);
+        ctx.glGenBuffers(1, &m_vbo);
+        ctx.glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        ctx.glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        ctx.glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        ctx.glEnableVertexAttribArray(0);
+        ctx.glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        ctx.glEnableVertexAttribArray(1);
+
+        m_image.assign((size_t)TEX_SIZE * TEX_SIZE, 0);
+        for (int y = 0; y < TEX_SIZE; ++y) {
+            for (int x = 0; x < TEX_SIZE; ++x) {
+                const bool check = ((x / 32) + (y / 32)) & 1;
+                m_image[(size_t)y * TEX_SIZE + x] = check ? 0xFF604030u : 0xFFC0A080u;
+            }
+        }
+        ctx.glGenTextures(1, &m_texture);
+        ctx.glBindTexture(GL_TEXTURE_2D, m_texture);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEX_SIZE, TEX_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_image.data());
+        ctx.glGenerateMipmap(GL_TEXTURE_2D);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        ctx.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    void destroy(SoftRenderContext& ctx) {
+        ctx.glDeleteTextures(1, &m_texture);
+        ctx.glDeleteBuffers(1, &m_vbo);
+        ctx.glDeleteVertexArrays(1, &m_vao);
+    }
+
+    // 把第 frame 帧的视频块写到 (x, y)：增量路径只上传该矩形，否则整张重新上传并重建整条 Mipmap 链
+    void stream(SoftRenderContext& ctx, int x, int y, uint32_t frame, bool incremental) {
+        ctx.glBindTexture(GL_TEXTURE_2D, m_texture);
+        if (incremental) {
+            uploadRegion(ctx, m_image, TEX_SIZE, {x, y, PATCH_SIZE, PATCH_SIZE}, frame);
+        } else {
+            for (int py = 0; py < PATCH_SIZE; ++py) {
+                for (int px = 0; px < PATCH_SIZE; ++px) m_image[(size_t)(y + py) * TEX_SIZE + x + px] = noisePixel(x + px, y + py, frame);
+            }
+            ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEX_SIZE, TEX_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_image.data());
+        }
+        ctx.glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    void render(SoftRenderContext& ctx, const Mat4& mvp) {
+        ctx.glBindVertexArray(m_vao);
+        m_shader.texture = ctx.getTextureObject(m_texture);
+        m_shader.mvp.load(mvp);
+        ctx.glDrawArrays(m_shader, GL_TRIANGLES, 0, 6);
+    }
+
+private:
+    GLuint m_vao = 0, m_vbo = 0, m_texture = 0;
+    std::vector<uint32_t> m_image;
+    tests::TexturedShader m_shader;
+};
+
+class SubImageTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_scene.init(ctx);
+        verifySubImage();
+    }
+
+    // 离屏验证：
+    // 1. 非 2 的幂 RGBA8 (100x60，及触发并行分带的 300x260) 与 BC1 (102x62) 纹理经多次 glTexSubImage2D + 增量 glGenerateMipmap 后，
+    //    整条 Mipmap 链的字节与用最终图像 glTexImage2D + 完整重建的结果完全相同
+    // 2. 压缩纹理只接受对齐到 4x4 块 (或到达层级边缘) 的区域，越界与未定义的层级被拒绝，被拒绝的调用不改变纹理
+    void verifySubImage() {
+        SoftRenderContext ctx(16, 16);
+        int failures = 0;
+        failures += verifyIncremental(ctx, GL_RGBA8, 100, 60,
+                                      {{13, 7, 21, 11}, {97, 55, 3, 5}, {0, 0, 100, 1}, {40, 20, 1, 1}, {0, 59, 1, 1}});
+        failures += verifyIncremental(ctx, GL_RGBA8, 300, 260, {{0, 0, 300, 260}, {5, 130, 290, 129}, {299, 0, 1, 260}});
+        failures += verifyIncremental(ctx, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 102, 62,
+                                      {{4, 8, 16, 12}, {100, 0, 2, 62}, {0, 60, 102, 2}, {96, 56, 6, 6}, {48, 28, 4, 4}});
+        failures += verifyAlignment(ctx);
+        if (failures == 0) std::cout << "Sub Image Test: incremental mipmaps match a full rebuild, misaligned updates rejected" << std::endl;
+    }
+
+    int verifyIncremental(SoftRenderContext& ctx, GLenum format, int w, int h, const std::vector<Region>& regions) {
+        GLuint tex[2] = {};
+        ctx.glGenTextures(2, tex);
+        std::vector<uint32_t> image = noiseImage(w, h, 1);
+        ctx.glBindTexture(GL_TEXTURE_2D, tex[0]);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+        ctx.glGenerateMipmap(GL_TEXTURE_2D);
+
+        // 每次更新后都生成一次：后一次的增量生成从前一次的结果继续
+        for (size_t i = 0; i < regions.size(); ++i) {
+            uploadRegion(ctx, image, w, regions[i], 2 + (uint32_t)i);
+            ctx.glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        ctx.glBindTexture(GL_TEXTURE_2D, tex[1]);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+        ctx.glGenerateMipmap(GL_TEXTURE_2D);
+
+        const TextureObject* incremental = ctx.getTextureObject(tex[0]);
+        const TextureObject* full = ctx.getTextureObject(tex[1]);
+        int firstBadLevel = -1;
+        if (incremental->mipLevels.size() != full->mipLevels.size() || incremental->data.size() != full->data.size()) {
+            firstBadLevel = 0;
+        } else {
+            for (size_t level = 0; level < full->mipLevels.size() && firstBadLevel < 0; ++level) {
+                const size_t begin = full->mipLevels[level].offset;
+                const size_t end = level + 1 < full->mipLevels.size() ? full->mipLevels[level + 1].offset : full->data.size();
+                if (!std::equal(full->data.begin() + begin, full->data.begin() + end, incremental->data.begin() + begin)) {
+                    firstBadLevel = (int)level;
+                }
+            }
+        }
+        ctx.glDeleteTextures(2, tex);
+
+        if (firstBadLevel >= 0) {
+            std::cerr << "Test Failed: " << (format == GL_RGBA8 ? "RGBA8 " : "BC1 ") << w << "x" << h
+                      << " incremental mipmaps differ from a full rebuild at level " << firstBadLevel << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    int verifyAlignment(SoftRenderContext& ctx) {
+        const int w = 102, h = 62;
+        GLuint tex = 0;
+        ctx.glGenTextures(1, &tex);
+        ctx.glBindTexture(GL_TEXTURE_2D, tex);
+        const std::vector<uint32_t> image = noiseImage(w, h, 1);
+        ctx.glTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+        const TextureObject* obj = ctx.getTextureObject(tex);
+        const std::vector<uint32_t> patch((size_t)w * h, 0xFF00FF00u);
+
+        struct Case {
+            GLint level;
+            Region r;
+            bool accepted;
+        };
+        const Case cases[] = {
+            {0, {2, 0, 4, 4}, false},    // x 未对齐
+            {0, {0, 1, 4, 4}, false},    // y 未对齐
+            {0, {0, 0, 6, 4}, false},    // 宽度不是 4 的倍数且未到达右边缘
+            {0, {0, 0, 4, 3}, false},    // 高度不是 4 的倍数且未到达下边缘
+            {0, {100, 60, 4, 4}, false}, // 超出层级范围
+            {1, {0, 0, 4, 4}, false},    // Level 1 尚未定义
+            {0, {100, 0, 2, 8}, true},   // 到达右边缘的 2 列
+            {0, {96, 60, 6, 2}, true},   // 到达右下角
+            {0, {8, 12, 16, 8}, true},
+        };
+
+        int failures = 0;
+        for (const Case& c : cases) {
+            const std::vector<uint32_t> before = obj->data;
+            ctx.glTexSubImage2D(GL_TEXTURE_2D, c.level, c.r.x, c.r.y, c.r.w, c.r.h, GL_RGBA, GL_UNSIGNED_BYTE, patch.data());
+            if ((obj->data != before) != c.accepted) {
+                std::cerr << "Test Failed: BC1 sub-image (" << c.r.x << ", " << c.r.y << ", " << c.r.w << "x" << c.r.h << ") at level "
+                          << c.level << " should be " << (c.accepted ? "accepted" : "rejected") << std::endl;
+                ++failures;
+            }
+        }
+        ctx.glDeleteTextures(1, &tex);
+        return failures;
+    }
+
+    void destroy(SoftRenderContext& ctx) override {
+        m_scene.destroy(ctx);
+    }
+
+    void onUpdate(float dt) override {
+        m_time += dt;
+    }
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, "glTexSubImage2D Streaming");
+
+        int incremental = m_incremental ? 1 : 0;
+        if (mu_checkbox(ctx, "Sub-image + incremental mips", &incremental)) m_incremental = incremental != 0;
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Upload + mipmaps: %.3f ms", m_lastMs);
+        mu_label(ctx, buf);
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        const int range = SubImageScene::TEX_SIZE - SubImageScene::PATCH_SIZE;
+        const int x = (int)((0.5f + 0.5f * std::sin(m_time * 0.7f)) * range);
+        const int y = (int)((0.5f + 0.5f * std::cos(m_time * 0.9f)) * range);
+        auto start = std::chrono::high_resolution_clock::now();
+        m_scene.stream(ctx, x, y, ++m_frame, m_incremental);
+        auto end = std::chrono::high_resolution_clock::now();
+        m_lastMs = std::chrono::duration<float, std::milli>(end - start).count();
+
+        const auto& vp = ctx.glGetViewport();
+        Mat4 proj = Mat4::Perspective(45.0f, (float)vp.w / (float)vp.h, 0.1f, 100.0f);
+        Mat4 model = Mat4::Translate(0.0f, -0.6f, -2.5f) * Mat4::RotateX(25.0f);
+        ctx.glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_scene.render(ctx, proj * model);
+    }
+
+private:
+    SubImageScene m_scene;
+    bool m_incremental = true;
+    uint32_t m_frame = 0;
+    float m_time = 0.0f;
+    float m_lastMs = 0.0f;
+};
+
+static TestRegistrar registrar("Texture", "Sub Image", []() -> ITinyGLTestCase* { return new SubImageTest(); });
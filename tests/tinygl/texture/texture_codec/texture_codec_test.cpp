@@ -0,0 +1,281 @@
+#include <ITestCase.h>
+#include <test_registry.h>
+#include <tinygl/tinygl.h>
+#include <tinygl/core/texture_codec.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace tinygl;
+
+namespace {
+
+uint32_t rgba(int r, int g, int b, int a = 255) {
+    return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+}
+
+int channel(uint32_t c, int ch) { return (int)((c >> (ch * 8)) & 0xFF); }
+
+// ETC2 / EAC 的 64-bit 块在内存中按大端字节序存放
+void storeEtcBits(uint64_t bits, uint32_t* words) {
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(words);
+    for (int i = 7; i >= 0; --i) { bytes[i] = (uint8_t)bits; bits >>= 8; }
+}
+
+// EAC Alpha 块：base | multiplier | table | 16 个 3-bit 索引 (按列优先，texel (x, y) 位于 bit 45 - 3 * (x * 4 + y))
+uint64_t eacBits(int base, int multiplier, int table, const int* indices) {
+    uint64_t bits = ((uint64_t)base << 56) | ((uint64_t)multiplier << 52) | ((uint64_t)table << 48);
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) bits |= (uint64_t)indices[y * 4 + x] << (45 - 3 * (x * 4 + y));
+    }
+    return bits;
+}
+
+} // namespace
+
+// 块压缩编解码测试：
+// 1. 参考向量：按 S3TC / ETC2 规范手工构造的块 (BC1 4 色 / 3 色 + 透明、BC3 两种 Alpha 模式、ETC2 T / H / Planar、EAC)，
+//    解码结果必须与规范计算出的参考值逐 texel 一致
+// 2. 往返：纯色、渐变与镂空 Alpha 块编码后再解码，误差在格式精度之内
+// 3. 采样路径：glCompressedTexImage2D 上传后 getTexelRaw (解码缓存) 与直接解码一致
+class TextureCodecTest : public ITinyGLTestCase {
+public:
+    void init(SoftRenderContext& ctx) override {
+        m_failures = 0;
+        checkBC1Reference();
+        checkBC3Reference();
+        checkEtc2Reference();
+        checkEacReference();
+        checkRoundTrips();
+        checkUpload(ctx);
+        if (m_failures == 0) std::cout << "Texture Codec Test: reference blocks and round trips passed" << std::endl;
+    }
+
+    void destroy(SoftRenderContext&) override {}
+
+    void onGui(mu_Context* ctx, const Rect&) override {
+        mu_layout_row(ctx, 1, (int[]){ -1 }, 0);
+        mu_label(ctx, m_failures == 0 ? "Codec checks passed" : "Codec checks FAILED (see log)");
+    }
+
+    void onRender(SoftRenderContext& ctx) override {
+        ctx.glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ctx.glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+private:
+    void expectBlock(const char* name, GLenum format, const uint32_t* block, const uint32_t* expected) {
+        uint32_t texels[16];
+        decodeTextureBlock(format, block, texels);
+        for (int i = 0; i < 16; ++i) {
+            if (texels[i] == expected[i]) continue;
+            std::cerr << "Test Failed: " << name << " texel (" << i % 4 << ", " << i / 4 << ") = " << std::hex << texels[i]
+                      << ", expected " << expected[i] << std::dec << std::endl;
+            ++m_failures;
+            return;
+        }
+    }
+
+    void checkBC1Reference() {
+        // 4 色模式 (color0 > color1)：红 -> 蓝，中间两项为 2:1 与 1:2 插值；索引按 texel 顺序 0, 1, 2, 3 循环
+        const uint32_t palette4[4] = {rgba(255, 0, 0), rgba(0, 0, 255), rgba(170, 0, 85), rgba(85, 0, 170)};
+        uint32_t block[2] = {0xF800u | (0x001Fu << 16), 0};
+        uint32_t expected[16];
+        for (int i = 0; i < 16; ++i) {
+            block[1] |= (uint32_t)(i & 3) << (2 * i);
+            expected[i] = palette4[i & 3];
+        }
+        expectBlock("BC1 four-color", GL_COMPRESSED_RGB_S3TC_DXT1_EXT, block, expected);
+        expectBlock("BC1 RGBA four-color", GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, block, expected);
+
+        // 3 色模式 (color0 <= color1)：第 3 项为 1:1 插值，索引 3 在 RGB 下为不透明黑色、在 RGBA 下为全透明
+        block[0] = 0x001Fu | (0xF800u << 16);
+        const uint32_t palette3[4] = {rgba(0, 0, 255), rgba(255, 0, 0), rgba(127, 0, 127), rgba(0, 0, 0)};
+        for (int i = 0; i < 16; ++i) expected[i] = palette3[i & 3];
+        expectBlock("BC1 three-color", GL_COMPRESSED_RGB_S3TC_DXT1_EXT, block, expected);
+        for (int i = 3; i < 16; i += 4) expected[i] = 0;
+        expectBlock("BC1 punch-through alpha", GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, block, expected);
+    }
+
+    void checkBC3Reference() {
+        // Alpha 8 值模式 (a0 > a1)：255, 0 与 6 个 1/7 步长的插值；索引 i % 8
+        const int alpha8[8] = {255, 0, 218, 182, 145, 109, 72, 36};
+        // BC3 的颜色块总是 4 色模式，即使 color0 <= color1：黑 -> 绿
+        const uint32_t colors[4] = {rgba(0, 0, 0), rgba(0, 255, 0), rgba(0, 85, 0), rgba(0, 170, 0)};
+        uint64_t alphaIndices = 0;
+        uint32_t block[4];
+        uint32_t expected[16];
+        block[2] = 0x0000u | (0x07E0u << 16);
+        block[3] = 0;
+        for (int i = 0; i < 16; ++i) {
+            alphaIndices |= (uint64_t)(i & 7) << (3 * i);
+            block[3] |= (uint32_t)((i >> 1) & 3) << (2 * i);
+            expected[i] = (colors[(i >> 1) & 3] & 0x00FFFFFFu) | ((uint32_t)alpha8[i & 7] << 24);
+        }
+        block[0] = 255u | (0u << 8) | (uint32_t)(alphaIndices << 16);
+        block[1] = (uint32_t)(alphaIndices >> 16);
+        expectBlock("BC3 eight-alpha", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, block, expected);
+
+        // Alpha 6 值模式 (a0 <= a1)：4 个 1/5 步长的插值，索引 6 / 7 固定为 0 / 255
+        const int alpha6[8] = {40, 200, 72, 104, 136, 168, 0, 255};
+        block[0] = 40u | (200u << 8) | (uint32_t)(alphaIndices << 16);
+        for (int i = 0; i < 16; ++i) expected[i] = (expected[i] & 0x00FFFFFFu) | ((uint32_t)alpha6[i & 7] << 24);
+        expectBlock("BC3 six-alpha", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, block, expected);
+    }
+
+    void checkEtc2Reference() {
+        // T / H 模式的索引：texel (x, y) 选取调色板第 (x + y) % 4 项
+        auto paintBlock = [&](const char* name, uint64_t bits, const uint32_t* paint) {
+            uint32_t block[2], expected[16];
+            storeEtcBits(bits, block);
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) expected[y * 4 + x] = paint[(x + y) % 4];
+            }
+            expectBlock(name, GL_COMPRESSED_RGB8_ETC2, block, expected);
+        };
+
+        // T 模式 (R 差分溢出)：C1 = (A, 5, 0)，C2 = (3, 6, 9)，距离表索引 3 (d = 16)
+        // 调色板 C1, C2 + d, C2, C2 - d
+        const uint32_t tPaint[4] = {rgba(170, 85, 0), rgba(67, 118, 169), rgba(51, 102, 153), rgba(35, 86, 137)};
+        paintBlock("ETC2 T-mode", 0xF2503697936C5A5Aull, tPaint);
+
+        // H 模式 (G 差分溢出)：C1 = (8, 4, 2)，C2 = (1, 2, 3)，da = 1, db = 0，C1 >= C2 -> 距离表索引 5 (d = 32)
+        // 调色板 C1 + d, C1 - d, C2 + d, C2 - d (钳制到 [0, 255])
+        const uint32_t hPaint[4] = {rgba(168, 100, 66), rgba(104, 36, 2), rgba(49, 66, 83), rgba(0, 2, 19)};
+        paintBlock("ETC2 H-mode", 0x4205091E936C5A5Aull, hPaint);
+
+        // Planar 模式 (B 差分溢出)：O = (130, 129, 65)，H = (195, 193, 32)，V = (65, 64, 255)
+        // C(x, y) = (x * (H - O) + y * (V - O) + 4 * O + 2) >> 2
+        const uint32_t planar[16] = {
+            rgba(130, 129, 65),  rgba(146, 145, 57),  rgba(163, 161, 49),  rgba(179, 177, 40),
+            rgba(114, 113, 113), rgba(130, 129, 104), rgba(146, 145, 96),  rgba(163, 161, 88),
+            rgba(98, 97, 160),   rgba(114, 113, 152), rgba(130, 129, 144), rgba(146, 145, 135),
+            rgba(81, 80, 208),   rgba(98, 96, 199),   rgba(114, 112, 191), rgba(130, 128, 183),
+        };
+        uint32_t block[2];
+        storeEtcBits(0x41001462C042083Full, block);
+        expectBlock("ETC2 planar", GL_COMPRESSED_RGB8_ETC2, block, planar);
+    }
+
+    void checkEacReference() {
+        int indices[16];
+        for (int i = 0; i < 16; ++i) indices[i] = i & 7;
+        uint32_t block[4], expected[16];
+        // 颜色部分用 T 模式块，Alpha 只替换高字节
+        storeEtcBits(0xF2503697936C5A5Aull, block + 2);
+        const uint32_t tPaint[4] = {rgba(170, 85, 0), rgba(67, 118, 169), rgba(51, 102, 153), rgba(35, 86, 137)};
+
+        // 表 13 {-1, -2, -3, -10, 0, 1, 2, 9}，base 128，multiplier 2
+        const int alphaA[8] = {126, 124, 122, 108, 128, 130, 132, 146};
+        storeEtcBits(eacBits(128, 2, 13, indices), block);
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                expected[y * 4 + x] = (tPaint[(x + y) % 4] & 0x00FFFFFFu) | ((uint32_t)alphaA[indices[y * 4 + x]] << 24);
+            }
+        }
+        expectBlock("EAC alpha", GL_COMPRESSED_RGBA8_ETC2_EAC, block, expected);
+
+        // 表 0 {-3, -6, -9, -15, 2, 5, 8, 14}，base 250，multiplier 3：正向修正钳制到 255
+        const int alphaB[8] = {241, 232, 223, 205, 255, 255, 255, 255};
+        storeEtcBits(eacBits(250, 3, 0, indices), block);
+        for (int i = 0; i < 16; ++i) expected[i] = (expected[i] & 0x00FFFFFFu) | ((uint32_t)alphaB[indices[i]] << 24);
+        expectBlock("EAC alpha clamp", GL_COMPRESSED_RGBA8_ETC2_EAC, block, expected);
+    }
+
+    // 编码 -> 解码，RGB 与 Alpha 的最大误差分别不超过 rgbTolerance / alphaTolerance
+    void expectRoundTrip(const std::string& name, GLenum format, const uint32_t* texels, int rgbTolerance, int alphaTolerance) {
+        uint32_t block[4], decoded[16];
+        encodeTextureBlock(format, texels, block);
+        decodeTextureBlock(format, block, decoded);
+        int rgbError = 0, alphaError = 0;
+        for (int i = 0; i < 16; ++i) {
+            for (int ch = 0; ch < 3; ++ch) rgbError = std::max(rgbError, std::abs(channel(decoded[i], ch) - channel(texels[i], ch)));
+            alphaError = std::max(alphaError, std::abs(channel(decoded[i], 3) - channel(texels[i], 3)));
+        }
+        if (rgbError > rgbTolerance || alphaError > alphaTolerance) {
+            std::cerr << "Test Failed: " << name << " round trip error rgb " << rgbError << " alpha " << alphaError << std::endl;
+            ++m_failures;
+        }
+    }
+
+    void checkRoundTrips() {
+        struct Format { GLenum format; const char* name; bool alpha; };
+        const Format formats[] = {
+            {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, "BC1", false},
+            {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, "BC3", true},
+            {GL_COMPRESSED_RGB8_ETC2, "ETC2", false},
+            {GL_COMPRESSED_RGBA8_ETC2_EAC, "ETC2+EAC", true},
+        };
+        uint32_t flat[16], gradient[16], alphaRamp[16];
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                const int t = x + y; // 沿对角线的亮度渐变 (ETC2 的独立 / 差分模式只能表示亮度修正)
+                flat[y * 4 + x] = rgba(200, 100, 50);
+                gradient[y * 4 + x] = rgba(40 + t * 12, 60 + t * 12, 90 + t * 12);
+                alphaRamp[y * 4 + x] = rgba(90, 160, 220, (y * 4 + x) * 17);
+            }
+        }
+        for (const Format& f : formats) {
+            const std::string name = f.name;
+            // 纯色：BC1 端点为 565 (误差不超过半个量化步长 + 插值取整)，ETC2 为 5 位基色 + 最小修正 2
+            expectRoundTrip(name + " flat", f.format, flat, 6, 0);
+            // 7 级渐变落到 4 个调色板项 (BC) 或每个子块 4 个修正值 (ETC2)：误差约为一级 (12)
+            expectRoundTrip(name + " gradient", f.format, gradient, 16, 0);
+            // 16 级 Alpha 渐变落到 8 个 Alpha 值：误差不超过半个 255 / 7 步长
+            if (f.alpha) expectRoundTrip(name + " alpha ramp", f.format, alphaRamp, 6, 18);
+        }
+
+        // 镂空 Alpha (BC1 RGBA)：alpha < 128 的 texel 解码为全透明，其余不透明且颜色保持
+        uint32_t punch[16], block[2], decoded[16];
+        for (int i = 0; i < 16; ++i) punch[i] = ((i + i / 4) & 1) ? rgba(0, 0, 0, 0) : rgba(60 + i * 4, 200, 90, 255);
+        encodeTextureBlock(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, punch, block);
+        decodeTextureBlock(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, block, decoded);
+        int alphaMismatches = 0, rgbError = 0;
+        for (int i = 0; i < 16; ++i) {
+            if (channel(decoded[i], 3) != channel(punch[i], 3)) ++alphaMismatches;
+            if (channel(punch[i], 3) == 0) continue;
+            for (int ch = 0; ch < 3; ++ch) rgbError = std::max(rgbError, std::abs(channel(decoded[i], ch) - channel(punch[i], ch)));
+        }
+        if (alphaMismatches > 0 || rgbError > 20) { // 3 色模式：相邻调色板项相差约 30
+            std::cerr << "Test Failed: BC1 punch-through round trip alpha mismatches " << alphaMismatches << ", rgb error " << rgbError << std::endl;
+            ++m_failures;
+        }
+    }
+
+    // 两个参考块组成 8x4 纹理上传，getTexelRaw 走解码缓存读回，结果与直接解码一致
+    void checkUpload(SoftRenderContext& ctx) {
+        uint32_t blocks[4];
+        storeEtcBits(0xF2503697936C5A5Aull, blocks);
+        storeEtcBits(0x41001462C042083Full, blocks + 2);
+        GLuint tex = 0;
+        ctx.glGenTextures(1, &tex);
+        ctx.glBindTexture(GL_TEXTURE_2D, tex);
+        ctx.glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB8_ETC2, 8, 4, 0, sizeof(blocks), blocks);
+        const TextureObject* obj = ctx.getTextureObject(tex);
+
+        int mismatches = 0;
+        for (int b = 0; b < 2; ++b) {
+            uint32_t expected[16];
+            decodeTextureBlock(GL_COMPRESSED_RGB8_ETC2, blocks + b * 2, expected);
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    Vec4 t = getTexelRaw(*obj, 0, b * 4 + x, y);
+                    uint32_t c = rgba((int)std::lround(t.x * 255.0f), (int)std::lround(t.y * 255.0f), (int)std::lround(t.z * 255.0f),
+                                      (int)std::lround(t.w * 255.0f));
+                    if (c != expected[y * 4 + x]) ++mismatches;
+                }
+            }
+        }
+        ctx.glDeleteTextures(1, &tex);
+        if (mismatches > 0) {
+            std::cerr << "Test Failed: compressed upload readback " << mismatches << " texels differ from decodeTextureBlock" << std::endl;
+            ++m_failures;
+        }
+    }
+
+    int m_failures = 0;
+};
+
+static TestRegistrar registrar("Texture", "Texture Codec", []() -> ITinyGLTestCase* { return new TextureCodecTest(); });
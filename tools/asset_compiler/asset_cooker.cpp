@@ -1,5 +1,6 @@
 #include "asset_cooker.h"
 #include <framework/asset_formats.h>
+#include <tinygl/core/texture_codec.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -12,13 +13,56 @@
 #include <vector>
 #include <iostream>
 #include <functional>
+#include <algorithm>
+#include <cstring>
 
 using namespace framework;
 namespace fs = std::filesystem;
 
 namespace tools {
 
-bool AssetCooker::CookTexture(const fs::path& source, const fs::path& dest) {
+namespace {
+
+tinygl::GLenum ToCompressedGLFormat(rhi::TextureFormat format) {
+    switch (format) {
+        case rhi::TextureFormat::BC1:        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case rhi::TextureFormat::BC3:        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case rhi::TextureFormat::ETC2_RGB8:  return GL_COMPRESSED_RGB8_ETC2;
+        case rhi::TextureFormat::ETC2_RGBA8: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: return 0;
+    }
+}
+
+// 2x2 box filter (edge texels are clamped for odd sizes)
+std::vector<uint32_t> Downsample(const std::vector<uint32_t>& src, int w, int h, int nextW, int nextH) {
+    std::vector<uint32_t> dst((size_t)nextW * nextH);
+    for (int y = 0; y < nextH; ++y) {
+        for (int x = 0; x < nextW; ++x) {
+            const int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+            const int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+            const uint32_t p[4] = {src[(size_t)y0 * w + x0], src[(size_t)y0 * w + x1],
+                                   src[(size_t)y1 * w + x0], src[(size_t)y1 * w + x1]};
+            uint32_t out = 0;
+            for (int c = 0; c < 32; c += 8) {
+                uint32_t sum = 2;
+                for (uint32_t v : p) sum += (v >> c) & 0xFF;
+                out |= (sum / 4) << c;
+            }
+            dst[(size_t)y * nextW + x] = out;
+        }
+    }
+    return dst;
+}
+
+} // namespace
+
+bool AssetCooker::CookTexture(const fs::path& source, const fs::path& dest, rhi::TextureFormat format) {
+    const tinygl::GLenum glFormat = ToCompressedGLFormat(format);
+    if (format != rhi::TextureFormat::RGBA8 && glFormat == 0) {
+        std::cerr << "Unsupported texture format: " << (uint32_t)format << std::endl;
+        return false;
+    }
+
     int w, h, c;
     stbi_set_flip_vertically_on_load(true); 
     unsigned char* data = stbi_load(source.string().c_str(), &w, &h, &c, 4); // Force RGBA
@@ -43,16 +87,45 @@ bool AssetCooker::CookTexture(const fs::path& source, const fs::path& dest) {
     texHeader.height = h;
     texHeader.channels = 4;
     texHeader.mipLevels = 1;
-    texHeader.format = 0; // RGBA8
+    texHeader.format = static_cast<uint32_t>(format);
+
+    if (format == rhi::TextureFormat::RGBA8) {
+        size_t payloadSize = sizeof(TextureHeader) + (w * h * 4);
+        header.dataSize = payloadSize;
+
+        out.write(reinterpret_cast<char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<char*>(&texHeader), sizeof(texHeader));
+        out.write(reinterpret_cast<char*>(data), w * h * 4);
+        
+        stbi_image_free(data);
+        return true;
+    }
 
-    size_t payloadSize = sizeof(TextureHeader) + (w * h * 4);
-    header.dataSize = payloadSize;
+    // Compressed: encode every mip level into 4x4 blocks (matches the runtime storage layout)
+    std::vector<uint32_t> level((size_t)w * h);
+    std::memcpy(level.data(), data, level.size() * 4);
+    stbi_image_free(data);
 
+    std::vector<uint32_t> blocks;
+    int levelW = w, levelH = h;
+    while (true) {
+        size_t offset = blocks.size();
+        blocks.resize(offset + tinygl::textureImageWords(glFormat, levelW, levelH));
+        tinygl::encodeTextureImage(glFormat, level.data(), levelW, levelH, blocks.data() + offset);
+        if (levelW <= 1 && levelH <= 1) break;
+
+        int nextW = std::max(1, levelW / 2);
+        int nextH = std::max(1, levelH / 2);
+        level = Downsample(level, levelW, levelH, nextW, nextH);
+        levelW = nextW;
+        levelH = nextH;
+        texHeader.mipLevels++;
+    }
+
+    header.dataSize = sizeof(TextureHeader) + blocks.size() * 4;
     out.write(reinterpret_cast<char*>(&header), sizeof(header));
     out.write(reinterpret_cast<char*>(&texHeader), sizeof(texHeader));
-    out.write(reinterpret_cast<char*>(data), w * h * 4);
-    
-    stbi_image_free(data);
+    out.write(reinterpret_cast<char*>(blocks.data()), blocks.size() * 4);
     return true;
 }
 
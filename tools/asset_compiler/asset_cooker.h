@@ -2,12 +2,15 @@
 
 #include <filesystem>
 #include <string>
+#include <rhi/types.h>
 
 namespace tools {
 
 class AssetCooker {
 public:
-    static bool CookTexture(const std::filesystem::path& source, const std::filesystem::path& dest);
+    // Compressed formats are encoded offline together with their full mip chain
+    static bool CookTexture(const std::filesystem::path& source, const std::filesystem::path& dest,
+                            rhi::TextureFormat format = rhi::TextureFormat::RGBA8);
     static bool CookModel(const std::filesystem::path& source, const std::filesystem::path& dest);
 };
 
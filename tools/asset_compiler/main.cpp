@@ -7,7 +7,8 @@
 namespace fs = std::filesystem;
 
 void print_usage() {
-    std::cout << "Usage: tinygl_ac <input_file> <output_file>" << std::endl;
+    std::cout << "Usage: tinygl_ac <input_file> <output_file> [texture_format]" << std::endl;
+    std::cout << "  texture_format: rgba8 (default), bc1, bc3, etc2, etc2_rgba" << std::endl;
 }
 
 std::string to_lower(const std::string& str) {
@@ -35,8 +36,21 @@ int main(int argc, char** argv) {
 
     bool success = false;
     if (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp") {
+        rhi::TextureFormat format = rhi::TextureFormat::RGBA8;
+        if (argc > 3) {
+            std::string name = to_lower(argv[3]);
+            if (name == "bc1") format = rhi::TextureFormat::BC1;
+            else if (name == "bc3") format = rhi::TextureFormat::BC3;
+            else if (name == "etc2") format = rhi::TextureFormat::ETC2_RGB8;
+            else if (name == "etc2_rgba") format = rhi::TextureFormat::ETC2_RGBA8;
+            else if (name != "rgba8") {
+                std::cerr << "Error: Unknown texture format: " << argv[3] << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
         std::cout << "Cooking Texture: " << inputPath << " -> " << outputPath << std::endl;
-        success = tools::AssetCooker::CookTexture(inputPath, outputPath);
+        success = tools::AssetCooker::CookTexture(inputPath, outputPath, format);
     } 
     else if (ext == ".obj" || ext == ".fbx" || ext == ".gltf" || ext == ".glb") {
         std::cout << "Cooking Model: " << inputPath << " -> " << outputPath << std::endl;